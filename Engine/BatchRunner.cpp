@@ -0,0 +1,176 @@
+// Пакетный прогон партий на всех ядрах и сводная статистика
+#include "BatchRunner.h"
+#include "EventSimulation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+namespace sim
+{
+    namespace
+    {
+        const double Z95 = 1.959963984540054; // Квантиль нормального распределения для 95%
+
+        // Интервал Уилсона для доли successes / n
+        Interval WilsonInterval(int successes, int n)
+        {
+            if (n <= 0) return Interval{ 0.0, 0.0 };
+            double p = (double)successes / n;
+            double z2 = Z95 * Z95;
+            double denom = 1.0 + z2 / n;
+            double center = (p + z2 / (2.0 * n)) / denom;
+            double half = Z95 * std::sqrt(p * (1.0 - p) / n + z2 / (4.0 * n * (double)n)) / denom;
+            return Interval{ std::max(0.0, center - half), std::min(1.0, center + half) };
+        }
+
+        // Среднее, стандартное отклонение и интервал для среднего
+        void MeanStats(const std::vector<double>& values, double& mean, double& stdDev, Interval& ci)
+        {
+            mean = 0.0;
+            stdDev = 0.0;
+            ci = Interval{ 0.0, 0.0 };
+            if (values.empty()) return;
+
+            for (double v : values) mean += v;
+            mean /= values.size();
+            if (values.size() > 1)
+            {
+                double sq = 0.0;
+                for (double v : values) sq += (v - mean) * (v - mean);
+                stdDev = std::sqrt(sq / (values.size() - 1));
+            }
+            double half = Z95 * stdDev / std::sqrt((double)values.size());
+            ci = Interval{ mean - half, mean + half };
+        }
+
+        // Квантиль по отсортированному массиву (линейная интерполяция)
+        double Quantile(const std::vector<double>& sorted, double q)
+        {
+            if (sorted.empty()) return 0.0;
+            double pos = q * (sorted.size() - 1);
+            size_t lo = (size_t)pos;
+            size_t hi = std::min(lo + 1, sorted.size() - 1);
+            double f = pos - lo;
+            return sorted[lo] * (1.0 - f) + sorted[hi] * f;
+        }
+    }
+
+    uint64_t EngagementSeed(uint64_t baseSeed, uint64_t runIndex)
+    {
+        // Соседние номера партий дают несвязанные seed
+        return Mix64(baseSeed + (runIndex + 1) * 0x9E3779B97F4A7C15ull);
+    }
+
+    EngagementResult RunEngagement(const ConfigData& config, uint64_t seed, float deltaTime, uint64_t maxTicks, bool eventDriven)
+    {
+        // Конфигурации, которые событийный движок не поддерживает, играются пошагово
+        if (eventDriven && EventSimulation::Supports(config))
+        {
+            EventSimulation simulation(config, seed);
+            if (deltaTime <= 0.0f) deltaTime = config.SimRateHz > 0.0f ? 1.0f / config.SimRateHz : 0.033f;
+            simulation.RunToEnd(maxTicks > 0 ? (double)maxTicks * deltaTime : 0.0);
+
+            EngagementResult result;
+            result.Seed = seed;
+            result.Result = simulation.Result;
+            result.Launched = simulation.RocketsLaunchedCount;
+            result.Intercepted = simulation.RocketsInterceptedCount;
+            result.EndTimeSec = simulation.ElapsedSec;
+            return result;
+        }
+
+        Simulation simulation(config, seed);
+        if (deltaTime <= 0.0f) deltaTime = simulation.FixedStepSec();
+        simulation.RunToEnd(deltaTime, maxTicks);
+
+        EngagementResult result;
+        result.Seed = seed;
+        result.Result = simulation.Result;
+        result.Launched = simulation.RocketsLaunchedCount;
+        result.Intercepted = simulation.RocketsInterceptedCount;
+        result.EndTimeSec = simulation.ElapsedSec;
+        return result;
+    }
+
+    bool CheckScenario(ConfigData& config, std::string* error)
+    {
+        return config.ScanScenarioInfo(error);
+    }
+
+    std::vector<EngagementResult> RunBatch(const ConfigData& batchConfig, const BatchOptions& options, std::string* error)
+    {
+        ConfigData config = batchConfig;
+        if (!CheckScenario(config, error)) return std::vector<EngagementResult>();
+        std::vector<EngagementResult> results(options.Runs > 0 ? options.Runs : 0);
+        if (results.empty()) return results;
+
+        int threads = options.Threads > 0 ? options.Threads : (int)std::thread::hardware_concurrency();
+        if (threads < 1) threads = 1;
+        if (threads > options.Runs) threads = options.Runs;
+
+        // Партии раздаются потокам по одной через общий счетчик: медленные партии не тормозят остальных
+        std::atomic<int> nextRun(0);
+        auto worker = [&]()
+        {
+            for (;;)
+            {
+                int run = nextRun.fetch_add(1, std::memory_order_relaxed);
+                if (run >= options.Runs) break;
+                results[run] = RunEngagement(config, EngagementSeed(options.BaseSeed, (uint64_t)run), options.DeltaTime, options.MaxTicks,
+                    options.EventDriven);
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (int t = 1; t < threads; t++) pool.emplace_back(worker);
+        worker();
+        for (std::thread& thread : pool) thread.join();
+        return results;
+    }
+
+    BatchStats Summarize(const std::vector<EngagementResult>& results)
+    {
+        BatchStats stats = BatchStats();
+        stats.Runs = (int)results.size();
+
+        std::vector<double> intercepts;
+        std::vector<double> breachTimes;
+        intercepts.reserve(results.size());
+        for (const EngagementResult& r : results)
+        {
+            switch (r.Result)
+            {
+            case Outcome::Victory: stats.Victories++; break;
+            case Outcome::DefenseFailed: stats.DefenseFailures++; break;
+            case Outcome::RadarDestroyed:
+                stats.RadarDestructions++;
+                breachTimes.push_back(r.EndTimeSec);
+                break;
+            default: stats.Unfinished++; break;
+            }
+
+            if (r.Intercepted >= (int)stats.InterceptHistogram.size()) stats.InterceptHistogram.resize(r.Intercepted + 1, 0);
+            stats.InterceptHistogram[r.Intercepted]++;
+            intercepts.push_back(r.Intercepted);
+        }
+
+        stats.WinRate = stats.Runs > 0 ? (double)stats.Victories / stats.Runs : 0.0;
+        stats.WinRateCi = WilsonInterval(stats.Victories, stats.Runs);
+
+        MeanStats(intercepts, stats.InterceptMean, stats.InterceptStdDev, stats.InterceptMeanCi);
+
+        MeanStats(breachTimes, stats.BreachTimeMean, stats.BreachTimeStdDev, stats.BreachTimeMeanCi);
+        std::sort(breachTimes.begin(), breachTimes.end());
+        if (!breachTimes.empty())
+        {
+            stats.BreachTimeMin = breachTimes.front();
+            stats.BreachTimeMax = breachTimes.back();
+        }
+        stats.BreachTimeP10 = Quantile(breachTimes, 0.10);
+        stats.BreachTimeP50 = Quantile(breachTimes, 0.50);
+        stats.BreachTimeP90 = Quantile(breachTimes, 0.90);
+        return stats;
+    }
+}
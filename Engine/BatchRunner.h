@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Simulation.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sim
+{
+    // Параметры пакетного прогона (метод Монте-Карло): много независимых партий с разными seed
+    struct BatchOptions
+    {
+        int Runs;           // Сколько партий сыграть
+        int Threads;        // Сколько потоков использовать (0 - по числу ядер)
+        uint64_t BaseSeed;  // Партия i получает seed, выведенный из BaseSeed и i
+        float DeltaTime;    // Шаг симуляции (0 - фиксированный шаг из конфигурации)
+        uint64_t MaxTicks;  // Ограничение длины партии в шагах (0 - без ограничения)
+        bool EventDriven;   // Играть событийным движком EventSimulation вместо пошагового (где он применим)
+
+        BatchOptions() : Runs(1000), Threads(0), BaseSeed(1), DeltaTime(0.0f), MaxTicks(0), EventDriven(false) {}
+    };
+
+    // Итог одной партии
+    struct EngagementResult
+    {
+        uint64_t Seed;      // С каким seed игралась партия
+        Outcome Result;     // Итог
+        int Launched;       // Сколько ракет запущено
+        int Intercepted;    // Сколько перехвачено
+        double EndTimeSec;  // Игровое время окончания партии (для RadarDestroyed - время прорыва к ядру)
+    };
+
+    // Доверительный интервал (95%)
+    struct Interval
+    {
+        double Low;
+        double High;
+    };
+
+    // Сводная статистика пакетного прогона
+    struct BatchStats
+    {
+        int Runs;
+        int Victories;
+        int DefenseFailures;
+        int RadarDestructions;
+        int Unfinished;                     // Партии, прерванные по MaxTicks
+
+        double WinRate;                     // Доля побед
+        Interval WinRateCi;                 // Интервал Уилсона для доли побед
+
+        std::vector<int> InterceptHistogram; // InterceptHistogram[k] - сколько партий закончились с k перехватами
+        double InterceptMean;
+        double InterceptStdDev;
+        Interval InterceptMeanCi;           // Нормальное приближение для среднего
+
+        // Время до прорыва к ядру (только по партиям с RadarDestroyed)
+        double BreachTimeMean;
+        double BreachTimeStdDev;
+        Interval BreachTimeMeanCi;
+        double BreachTimeMin;
+        double BreachTimeP10;
+        double BreachTimeP50;
+        double BreachTimeP90;
+        double BreachTimeMax;
+    };
+
+    // seed партии с номером runIndex, выведенный из базового (одинаков при любом числе потоков)
+    uint64_t EngagementSeed(uint64_t baseSeed, uint64_t runIndex);
+
+    // Одна партия до конца. Событийный движок ограничивается тем же игровым временем, что и maxTicks шагов;
+    // если он не поддерживает конфигурацию (EventSimulation::Supports), партия играется пошагово
+    EngagementResult RunEngagement(const ConfigData& config, uint64_t seed, float deltaTime, uint64_t maxTicks, bool eventDriven = false);
+
+    // Проверка сценария конфигурации (если он задан) и его сводка (ConfigData::ScanScenarioInfo). Партия
+    // с неоткрывшимся сценарием не начинается (Simulation::ScenarioError), поэтому пакет и перебор проверяют его
+    // до прогона и раздают партиям уже проверенную конфигурацию - файл читается один раз. При ошибке - false и текст в error
+    bool CheckScenario(ConfigData& config, std::string* error = nullptr);
+
+    // Прогон options.Runs партий на всех ядрах. Результат i всегда соответствует партии i,
+    // поэтому итог не зависит от числа потоков. Если сценарий не открывается - ни одной партии и текст в error
+    std::vector<EngagementResult> RunBatch(const ConfigData& config, const BatchOptions& options, std::string* error = nullptr);
+
+    // Сводная статистика по результатам партий
+    BatchStats Summarize(const std::vector<EngagementResult>& results);
+}
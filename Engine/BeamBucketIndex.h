@@ -0,0 +1,234 @@
+#pragma once
+
+#include "Vec2.h"
+#include "BinaryAngle.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace sim
+{
+    // Пространственный индекс ракет по направлению и дальности от радара.
+    // Плоскость вокруг радара разбита на секторы по углу и кольца по расстоянию;
+    // каждая ракета лежит в одной корзине (сектор, кольцо). Луч покрывает лишь несколько секторов,
+    // поэтому точная проверка нужна только ракетам из этих корзин - примерно BeamWidth / 360 от всех.
+    // Индекс обновляется инкрементально: при движении ракеты перекладываются только те, что сменили корзину.
+    // Номера ракет совпадают с индексами в RocketStore, удаление повторяет RocketStore::SwapRemove
+    class BeamBucketIndex
+    {
+    public:
+        BeamBucketIndex() : sectorCount(1), ringCount(1), ringWidthSq(1.0f), invRingWidthSq(1.0f), maxSpeed(0.0f) {}
+
+        // Разбиение под луч шириной beamWidthDegrees и дальностью rangeR.
+        // Секторы примерно вчетверо уже луча. Кольца равны по квадрату расстояния (так корзина считается без корня):
+        // восемь колец до дальности луча, еще два за ней (запас для непрерывной проверки) и одно внешнее для всех дальних
+        void Reset(Vec2 center, float beamWidthDegrees, float rangeR)
+        {
+            this->center = center;
+            float width = std::max(beamWidthDegrees, 0.1f);
+            sectorCount = (uint32_t)std::min(4096.0f, std::max(8.0f, std::ceil(4.0f * 360.0f / width)));
+            ringWidthSq = rangeR > 0.0f ? rangeR * rangeR / RingsInsideRange : 1.0f;
+            invRingWidthSq = 1.0f / ringWidthSq;
+            ringCount = RingsInsideRange + 3;
+            buckets.assign((size_t)sectorCount * ringCount, std::vector<uint32_t>());
+            bucketOf.clear();
+            slotOf.clear();
+            maxSpeed = 0.0f;
+        }
+
+        void Clear()
+        {
+            for (std::vector<uint32_t>& bucket : buckets) bucket.clear();
+            bucketOf.clear();
+            slotOf.clear();
+            maxSpeed = 0.0f;
+        }
+
+        // Место под capacity ракет в массивах на ракету (корзины растут сами и сохраняют емкость до Reset)
+        void Reserve(size_t capacity)
+        {
+            bucketOf.reserve(capacity);
+            slotOf.reserve(capacity);
+            scratch.reserve(capacity);
+        }
+
+        uint32_t SectorCount() const { return sectorCount; }
+        uint32_t RingCount() const { return ringCount; }
+        size_t Size() const { return bucketOf.size(); }
+
+        // Наибольшая скорость среди добавленных ракет: ограничивает смещение за шаг для непрерывной проверки
+        float MaxSpeed() const { return maxSpeed; }
+
+        // Учет скорости, которую ракеты наберут позже запуска (профиль скорости rocket_speed_profile)
+        void NoteSpeed(float speed) { maxSpeed = std::max(maxSpeed, speed); }
+
+        // Добавление ракеты с номером index (должен быть равен текущему Size(), как в RocketStore::Add)
+        void Insert(uint32_t index, float x, float y, float speed)
+        {
+            uint32_t bucket = BucketOf(x, y);
+            bucketOf.push_back(bucket);
+            slotOf.push_back((uint32_t)buckets[bucket].size());
+            buckets[bucket].push_back(index);
+            maxSpeed = std::max(maxSpeed, speed);
+        }
+
+        // Удаление ракеты i с переносом последней на ее место, как в RocketStore::SwapRemove
+        void SwapRemove(uint32_t i)
+        {
+            uint32_t last = (uint32_t)bucketOf.size() - 1;
+            Unlink(i);
+            if (i != last)
+            {
+                bucketOf[i] = bucketOf[last];
+                slotOf[i] = slotOf[last];
+                buckets[bucketOf[i]][slotOf[i]] = i;
+            }
+            bucketOf.pop_back();
+            slotOf.pop_back();
+        }
+
+        // Перемещение ракет на шаг и пересчет их корзин в одном проходе по памяти.
+        // Этот цикл без ветвлений (компилятор его векторизует), а перекладываются
+        // только ракеты, сменившие корзину (их единицы за шаг)
+        void MoveAndRefresh(float* x, float* y, const float* vx, const float* vy, size_t count, float deltaTime)
+        {
+            scratch.resize(count);
+            uint32_t* fresh = scratch.data();
+            const float cx = center.X, cy = center.Y;
+            const float sectorScale = (float)sectorCount * 0.25f;
+            const float lastSector = (float)(sectorCount - 1);
+            const float lastRing = (float)(ringCount - 1);
+            const float invWidthSq = invRingWidthSq;
+            const int32_t rings = (int32_t)ringCount;
+            for (size_t i = 0; i < count; i++)
+            {
+                float nx = x[i] + vx[i] * deltaTime;
+                float ny = y[i] + vy[i] * deltaTime;
+                x[i] = nx;
+                y[i] = ny;
+                float dx = nx - cx;
+                float dy = ny - cy;
+                float sector = std::min(PseudoAngle(dx, dy) * sectorScale, lastSector);
+                float ring = std::min((dx * dx + dy * dy) * invWidthSq, lastRing);
+                fresh[i] = (uint32_t)((int32_t)sector * rings + (int32_t)ring);
+            }
+            for (size_t i = 0; i < count; i++)
+            {
+                if (fresh[i] != bucketOf[i])
+                {
+                    Unlink((uint32_t)i);
+                    bucketOf[i] = fresh[i];
+                    slotOf[i] = (uint32_t)buckets[fresh[i]].size();
+                    buckets[fresh[i]].push_back((uint32_t)i);
+                }
+            }
+        }
+
+        // Ракеты из корзин, пересекающих клин: углы от fromDegrees до toDegrees (по возрастанию, в градусах)
+        // и расстояния от minRange до maxRange. Результат дописывается в out, порядок произвольный
+        void GatherWedge(float fromDegrees, float toDegrees, float minRange, float maxRange, std::vector<uint32_t>& out) const
+        {
+            uint32_t ringFrom = RingOf(std::max(0.0f, minRange - Slack(minRange)));
+            uint32_t ringTo = RingOf(maxRange + Slack(maxRange));
+
+            // Небольшой запас по углу: граница корзины и граница луча считаются разными формулами
+            const float angleSlack = 1e-3f;
+            float span = toDegrees - fromDegrees + 2.0f * angleSlack;
+            uint32_t first = 0, steps = sectorCount - 1;
+            if (span < 360.0f)
+            {
+                first = SectorOfAngle(fromDegrees - angleSlack);
+                uint32_t last = SectorOfAngle(toDegrees + angleSlack);
+                steps = (last + sectorCount - first) % sectorCount;
+                // Клин больше половины круга с концами в одном секторе - это почти весь круг
+                if (steps == 0 && span > 180.0f) steps = sectorCount - 1;
+            }
+
+            for (uint32_t k = 0, sector = first; k <= steps; k++, sector = (sector + 1 == sectorCount ? 0 : sector + 1))
+            {
+                for (uint32_t ring = ringFrom; ring <= ringTo; ring++)
+                {
+                    const std::vector<uint32_t>& bucket = buckets[(size_t)sector * ringCount + ring];
+                    out.insert(out.end(), bucket.begin(), bucket.end());
+                }
+            }
+        }
+
+        // Ракеты из корзин, пересекающих круг радиуса maxRange вокруг центра
+        void GatherDisk(float maxRange, std::vector<uint32_t>& out) const
+        {
+            uint32_t ringTo = RingOf(maxRange + Slack(maxRange));
+            for (uint32_t sector = 0; sector < sectorCount; sector++)
+            {
+                for (uint32_t ring = 0; ring <= ringTo; ring++)
+                {
+                    const std::vector<uint32_t>& bucket = buckets[(size_t)sector * ringCount + ring];
+                    out.insert(out.end(), bucket.begin(), bucket.end());
+                }
+            }
+        }
+
+    private:
+        static const uint32_t RingsInsideRange = 8;
+
+        Vec2 center;
+        uint32_t sectorCount;
+        uint32_t ringCount;
+        float ringWidthSq;      // Ширина кольца по квадрату расстояния
+        float invRingWidthSq;
+        float maxSpeed;
+
+        std::vector<std::vector<uint32_t>> buckets; // Номера ракет по корзинам (сектор * ringCount + кольцо)
+        std::vector<uint32_t> bucketOf;             // Корзина каждой ракеты
+        std::vector<uint32_t> slotOf;               // Позиция ракеты внутри своей корзины
+        std::vector<uint32_t> scratch;              // Новые корзины при MoveAndRefresh
+
+        // Запас по дальности на погрешность округления
+        static float Slack(float range)
+        {
+            return std::fabs(range) * 1e-5f + 1e-3f;
+        }
+
+        // Псевдоугол в [0, 4): монотонен по настоящему углу, но без atan2 и без ветвлений.
+        // В верхней полуплоскости 1 - p (от 0 до 2), в нижней 3 + p (от 2 до 4), где p = dx / (|dx| + |dy|)
+        static float PseudoAngle(float dx, float dy)
+        {
+            float p = dx / (std::fabs(dx) + std::fabs(dy) + 1e-30f);
+            return 2.0f - std::copysign(1.0f, dy) * (1.0f + p);
+        }
+
+        uint32_t SectorOfAngle(float degrees) const
+        {
+            BinaryAngle angle = BinaryAngleFromDegrees(degrees);
+            float sector = std::min(PseudoAngle(Cos(angle), Sin(angle)) * (float)sectorCount * 0.25f, (float)(sectorCount - 1));
+            return (uint32_t)sector;
+        }
+
+        uint32_t RingOf(float range) const
+        {
+            float ring = std::min(range * range * invRingWidthSq, (float)(ringCount - 1));
+            return (uint32_t)ring;
+        }
+
+        uint32_t BucketOf(float x, float y) const
+        {
+            float dx = x - center.X;
+            float dy = y - center.Y;
+            uint32_t sector = (uint32_t)std::min(PseudoAngle(dx, dy) * (float)sectorCount * 0.25f, (float)(sectorCount - 1));
+            uint32_t ring = (uint32_t)std::min((dx * dx + dy * dy) * invRingWidthSq, (float)(ringCount - 1));
+            return sector * ringCount + ring;
+        }
+
+        // Исключение ракеты из ее корзины перестановкой последнего элемента корзины на ее место
+        void Unlink(uint32_t i)
+        {
+            std::vector<uint32_t>& bucket = buckets[bucketOf[i]];
+            uint32_t slot = slotOf[i];
+            uint32_t moved = bucket.back();
+            bucket[slot] = moved;
+            slotOf[moved] = slot;
+            bucket.pop_back();
+        }
+    };
+}
@@ -0,0 +1,313 @@
+// Пакетная проверка попадания ракет в луч радара.
+// Файл компилируется как обычный нативный код (без /clr): векторные инструкции
+// и выбор реализации во время выполнения здесь допустимы
+#include "BeamKernel.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define RADAR_BEAM_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#else
+#define RADAR_BEAM_X86 0
+#endif
+
+// GCC и Clang требуют разрешить набор инструкций для конкретной функции,
+// MSVC позволяет использовать любые встроенные функции без этого
+#if RADAR_BEAM_X86 && (defined(__GNUC__) || defined(__clang__))
+#define RADAR_TARGET(isa) __attribute__((target(isa)))
+#else
+#define RADAR_TARGET(isa)
+#endif
+
+namespace sim
+{
+    namespace
+    {
+        // Таблицы для перевода битовой маски попаданий в массив байтов 0/1:
+        // 4 бита маски -> 4 байта, 8 бит -> 8 байт
+        struct MaskTables
+        {
+            uint32_t Bytes4[16];
+            uint64_t Bytes8[256];
+
+            MaskTables()
+            {
+                for (uint32_t m = 0; m < 256; m++)
+                {
+                    uint64_t bytes = 0;
+                    for (int bit = 0; bit < 8; bit++)
+                    {
+                        if (m & (1u << bit)) bytes |= (uint64_t)1 << (bit * 8);
+                    }
+                    Bytes8[m] = bytes;
+                    if (m < 16) Bytes4[m] = (uint32_t)bytes;
+                }
+            }
+        };
+
+        const MaskTables& Tables()
+        {
+            static const MaskTables tables;
+            return tables;
+        }
+
+        // Угловое условие для одной точки.
+        // Узкий луч (cos >= 0): dot >= 0 и dot^2 >= cos^2 * d^2.
+        // Широкий луч (cos < 0): dot >= 0 или dot^2 <= cos^2 * d^2
+        template <bool Wide>
+        inline size_t DetectScalarRange(const BeamSector& beam, const float* x, const float* y, size_t begin, size_t end, uint8_t* hit)
+        {
+            size_t hits = 0;
+            for (size_t i = begin; i < end; i++)
+            {
+                float dx = x[i] - beam.CenterX;
+                float dy = y[i] - beam.CenterY;
+                float d2 = dx * dx + dy * dy;
+                float dot = dx * beam.DirX + dy * beam.DirY;
+                float c2 = beam.CosHalfWidthSq * d2;
+                float dot2 = dot * dot;
+                bool inRange = (d2 > beam.DeadZoneRadiusSq) & (d2 <= beam.RangeSq);
+                bool inAngle = Wide ? ((dot >= 0.0f) | (dot2 <= c2)) : ((dot >= 0.0f) & (dot2 >= c2));
+                uint8_t h = (uint8_t)(inRange & inAngle);
+                hit[i] = h;
+                hits += h;
+            }
+            return hits;
+        }
+
+        template <bool Wide>
+        size_t DetectScalar(const BeamSector& beam, const float* x, const float* y, size_t count, uint8_t* hit)
+        {
+            return DetectScalarRange<Wide>(beam, x, y, 0, count, hit);
+        }
+
+        inline int PopCount(uint32_t v)
+        {
+            int n = 0;
+            for (; v; v &= v - 1) n++;
+            return n;
+        }
+
+#if RADAR_BEAM_X86
+        template <bool Wide>
+        RADAR_TARGET("sse2")
+        size_t DetectSse(const BeamSector& beam, const float* x, const float* y, size_t count, uint8_t* hit)
+        {
+            const MaskTables& tables = Tables();
+            const __m128 cx = _mm_set1_ps(beam.CenterX);
+            const __m128 cy = _mm_set1_ps(beam.CenterY);
+            const __m128 dirX = _mm_set1_ps(beam.DirX);
+            const __m128 dirY = _mm_set1_ps(beam.DirY);
+            const __m128 cos2 = _mm_set1_ps(beam.CosHalfWidthSq);
+            const __m128 dz2 = _mm_set1_ps(beam.DeadZoneRadiusSq);
+            const __m128 r2 = _mm_set1_ps(beam.RangeSq);
+            const __m128 zero = _mm_setzero_ps();
+
+            size_t hits = 0;
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), cx);
+                __m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), cy);
+                __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+                __m128 dot = _mm_add_ps(_mm_mul_ps(dx, dirX), _mm_mul_ps(dy, dirY));
+                __m128 c2 = _mm_mul_ps(cos2, d2);
+                __m128 dot2 = _mm_mul_ps(dot, dot);
+                __m128 inRange = _mm_and_ps(_mm_cmpgt_ps(d2, dz2), _mm_cmple_ps(d2, r2));
+                __m128 dotPositive = _mm_cmpge_ps(dot, zero);
+                __m128 inAngle = Wide ? _mm_or_ps(dotPositive, _mm_cmple_ps(dot2, c2))
+                                      : _mm_and_ps(dotPositive, _mm_cmpge_ps(dot2, c2));
+                uint32_t mask = (uint32_t)_mm_movemask_ps(_mm_and_ps(inRange, inAngle));
+                std::memcpy(hit + i, &tables.Bytes4[mask], 4);
+                hits += PopCount(mask);
+            }
+            return hits + DetectScalarRange<Wide>(beam, x, y, i, count, hit);
+        }
+
+        template <bool Wide>
+        RADAR_TARGET("avx2")
+        size_t DetectAvx2(const BeamSector& beam, const float* x, const float* y, size_t count, uint8_t* hit)
+        {
+            const MaskTables& tables = Tables();
+            const __m256 cx = _mm256_set1_ps(beam.CenterX);
+            const __m256 cy = _mm256_set1_ps(beam.CenterY);
+            const __m256 dirX = _mm256_set1_ps(beam.DirX);
+            const __m256 dirY = _mm256_set1_ps(beam.DirY);
+            const __m256 cos2 = _mm256_set1_ps(beam.CosHalfWidthSq);
+            const __m256 dz2 = _mm256_set1_ps(beam.DeadZoneRadiusSq);
+            const __m256 r2 = _mm256_set1_ps(beam.RangeSq);
+            const __m256 zero = _mm256_setzero_ps();
+
+            size_t hits = 0;
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + i), cx);
+                __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + i), cy);
+                __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+                __m256 dot = _mm256_add_ps(_mm256_mul_ps(dx, dirX), _mm256_mul_ps(dy, dirY));
+                __m256 c2 = _mm256_mul_ps(cos2, d2);
+                __m256 dot2 = _mm256_mul_ps(dot, dot);
+                __m256 inRange = _mm256_and_ps(_mm256_cmp_ps(d2, dz2, _CMP_GT_OQ), _mm256_cmp_ps(d2, r2, _CMP_LE_OQ));
+                __m256 dotPositive = _mm256_cmp_ps(dot, zero, _CMP_GE_OQ);
+                __m256 inAngle = Wide ? _mm256_or_ps(dotPositive, _mm256_cmp_ps(dot2, c2, _CMP_LE_OQ))
+                                      : _mm256_and_ps(dotPositive, _mm256_cmp_ps(dot2, c2, _CMP_GE_OQ));
+                uint32_t mask = (uint32_t)_mm256_movemask_ps(_mm256_and_ps(inRange, inAngle));
+                std::memcpy(hit + i, &tables.Bytes8[mask], 8);
+                hits += PopCount(mask);
+            }
+            return hits + DetectScalarRange<Wide>(beam, x, y, i, count, hit);
+        }
+
+        template <bool Wide>
+        RADAR_TARGET("avx512f")
+        size_t DetectAvx512(const BeamSector& beam, const float* x, const float* y, size_t count, uint8_t* hit)
+        {
+            const __m512 cx = _mm512_set1_ps(beam.CenterX);
+            const __m512 cy = _mm512_set1_ps(beam.CenterY);
+            const __m512 dirX = _mm512_set1_ps(beam.DirX);
+            const __m512 dirY = _mm512_set1_ps(beam.DirY);
+            const __m512 cos2 = _mm512_set1_ps(beam.CosHalfWidthSq);
+            const __m512 dz2 = _mm512_set1_ps(beam.DeadZoneRadiusSq);
+            const __m512 r2 = _mm512_set1_ps(beam.RangeSq);
+            const __m512 zero = _mm512_setzero_ps();
+            const __m512i one = _mm512_set1_epi32(1);
+
+            size_t hits = 0;
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16)
+            {
+                __m512 dx = _mm512_sub_ps(_mm512_loadu_ps(x + i), cx);
+                __m512 dy = _mm512_sub_ps(_mm512_loadu_ps(y + i), cy);
+                __m512 d2 = _mm512_add_ps(_mm512_mul_ps(dx, dx), _mm512_mul_ps(dy, dy));
+                __m512 dot = _mm512_add_ps(_mm512_mul_ps(dx, dirX), _mm512_mul_ps(dy, dirY));
+                __m512 c2 = _mm512_mul_ps(cos2, d2);
+                __m512 dot2 = _mm512_mul_ps(dot, dot);
+                __mmask16 inRange = _mm512_cmp_ps_mask(d2, dz2, _CMP_GT_OQ) & _mm512_cmp_ps_mask(d2, r2, _CMP_LE_OQ);
+                __mmask16 dotPositive = _mm512_cmp_ps_mask(dot, zero, _CMP_GE_OQ);
+                __mmask16 inAngle = Wide ? (__mmask16)(dotPositive | _mm512_cmp_ps_mask(dot2, c2, _CMP_LE_OQ))
+                                         : (__mmask16)(dotPositive & _mm512_cmp_ps_mask(dot2, c2, _CMP_GE_OQ));
+                __mmask16 mask = (__mmask16)(inRange & inAngle);
+                // 16 бит маски -> 16 байтов 0/1 через сужение 32-битных элементов
+                _mm_storeu_si128((__m128i*)(hit + i), _mm512_cvtepi32_epi8(_mm512_maskz_mov_epi32(mask, one)));
+                hits += PopCount(mask);
+            }
+            return hits + DetectScalarRange<Wide>(beam, x, y, i, count, hit);
+        }
+#endif
+
+        typedef size_t (*DetectFunc)(const BeamSector&, const float*, const float*, size_t, uint8_t*);
+
+        bool CpuSupports(BeamKernelIsa isa)
+        {
+            switch (isa)
+            {
+            case BeamKernelIsa::Scalar:
+                return true;
+#if RADAR_BEAM_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+            case BeamKernelIsa::Sse:
+                return true; // SSE2 есть на любом процессоре x64
+            case BeamKernelIsa::Avx2:
+            case BeamKernelIsa::Avx512:
+            {
+                int regs[4];
+                __cpuid(regs, 1);
+                bool osxsave = (regs[2] & (1 << 27)) != 0;
+                if (!osxsave) return false;
+                unsigned long long xcr0 = _xgetbv(0);
+                __cpuidex(regs, 7, 0);
+                if (isa == BeamKernelIsa::Avx2)
+                    return (xcr0 & 0x6) == 0x6 && (regs[1] & (1 << 5)) != 0;
+                return (xcr0 & 0xE6) == 0xE6 && (regs[1] & (1 << 16)) != 0;
+            }
+#else
+            case BeamKernelIsa::Sse:
+                return __builtin_cpu_supports("sse2");
+            case BeamKernelIsa::Avx2:
+                return __builtin_cpu_supports("avx2");
+            case BeamKernelIsa::Avx512:
+                return __builtin_cpu_supports("avx512f");
+#endif
+#endif
+            default:
+                return false;
+            }
+        }
+
+        BeamKernelIsa DetectBestIsa()
+        {
+            // Ручной выбор через переменную окружения, если процессор его поддерживает
+            if (const char* forced = std::getenv("RADAR_BEAM_KERNEL"))
+            {
+                std::string name = forced;
+                BeamKernelIsa all[] = { BeamKernelIsa::Scalar, BeamKernelIsa::Sse, BeamKernelIsa::Avx2, BeamKernelIsa::Avx512 };
+                for (BeamKernelIsa isa : all)
+                {
+                    if (name == BeamKernelIsaName(isa) && CpuSupports(isa)) return isa;
+                }
+            }
+            if (CpuSupports(BeamKernelIsa::Avx512)) return BeamKernelIsa::Avx512;
+            if (CpuSupports(BeamKernelIsa::Avx2)) return BeamKernelIsa::Avx2;
+            if (CpuSupports(BeamKernelIsa::Sse)) return BeamKernelIsa::Sse;
+            return BeamKernelIsa::Scalar;
+        }
+
+        std::atomic<int>& SelectedIsa()
+        {
+            static std::atomic<int> selected((int)DetectBestIsa());
+            return selected;
+        }
+
+        template <bool Wide>
+        DetectFunc GetDetectFunc(BeamKernelIsa isa)
+        {
+            switch (isa)
+            {
+#if RADAR_BEAM_X86
+            case BeamKernelIsa::Sse: return &DetectSse<Wide>;
+            case BeamKernelIsa::Avx2: return &DetectAvx2<Wide>;
+            case BeamKernelIsa::Avx512: return &DetectAvx512<Wide>;
+#endif
+            default: return &DetectScalar<Wide>;
+            }
+        }
+    }
+
+    size_t DetectBatch(const BeamSector& beam, const float* x, const float* y, size_t count, uint8_t* hit)
+    {
+        BeamKernelIsa isa = (BeamKernelIsa)SelectedIsa().load(std::memory_order_relaxed);
+        DetectFunc detect = beam.CosHalfWidth < 0.0f ? GetDetectFunc<true>(isa) : GetDetectFunc<false>(isa);
+        return detect(beam, x, y, count, hit);
+    }
+
+    BeamKernelIsa ActiveBeamKernelIsa()
+    {
+        return (BeamKernelIsa)SelectedIsa().load(std::memory_order_relaxed);
+    }
+
+    bool SelectBeamKernelIsa(BeamKernelIsa isa)
+    {
+        if (!CpuSupports(isa)) return false;
+        SelectedIsa().store((int)isa, std::memory_order_relaxed);
+        return true;
+    }
+
+    const char* BeamKernelIsaName(BeamKernelIsa isa)
+    {
+        switch (isa)
+        {
+        case BeamKernelIsa::Sse: return "sse";
+        case BeamKernelIsa::Avx2: return "avx2";
+        case BeamKernelIsa::Avx512: return "avx512";
+        default: return "scalar";
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sim
+{
+    // Сектор луча в виде, удобном для пакетной проверки без тригонометрии.
+    // Точка p внутри сектора, если
+    //   DeadZoneRadiusSq < |p - C|^2 <= RangeSq и угол между (p - C) и Dir не больше половины ширины луча.
+    // Угловая проверка сводится к скалярному произведению: dot(p - C, Dir) >= |p - C| * cos(половины ширины),
+    // которое сравнивается в квадратах, поэтому корень и atan2 не нужны
+    struct BeamSector
+    {
+        float CenterX;          // Центр радара
+        float CenterY;
+        float DirX;             // Единичный вектор направления луча
+        float DirY;
+        float CosHalfWidth;     // Косинус половины ширины луча
+        float CosHalfWidthSq;   // Его квадрат
+        float DeadZoneRadiusSq; // Квадрат радиуса мертвой зоны
+        float RangeSq;          // Квадрат эффективной дальности луча
+    };
+
+    // Проверка одной точки тем же условием, что и в DetectBatch
+    inline bool BeamSectorContains(const BeamSector& beam, float x, float y)
+    {
+        float dx = x - beam.CenterX;
+        float dy = y - beam.CenterY;
+        float d2 = dx * dx + dy * dy;
+        if (d2 <= beam.DeadZoneRadiusSq || d2 > beam.RangeSq) return false;
+        float dot = dx * beam.DirX + dy * beam.DirY;
+        float c2 = beam.CosHalfWidthSq * d2;
+        float dot2 = dot * dot;
+        // Узкий луч (cos >= 0): dot >= 0 и dot^2 >= cos^2 * d^2; широкий: dot >= 0 или dot^2 <= cos^2 * d^2
+        if (beam.CosHalfWidth >= 0.0f) return dot >= 0.0f && dot2 >= c2;
+        return dot >= 0.0f || dot2 <= c2;
+    }
+
+    // Набор инструкций, которым выполняется пакетная проверка
+    enum class BeamKernelIsa
+    {
+        Scalar,
+        Sse,
+        Avx2,
+        Avx512
+    };
+
+    // Пакетная проверка count точек (x[i], y[i]) на попадание в сектор луча.
+    // В hit[i] записывается 1 для точек внутри сектора и 0 для остальных.
+    // Возвращает число попаданий. Реализация выбирается при первом вызове по возможностям процессора
+    // (переменная окружения RADAR_BEAM_KERNEL=scalar|sse|avx2|avx512 позволяет выбрать ее вручную)
+    size_t DetectBatch(const BeamSector& beam, const float* x, const float* y, size_t count, uint8_t* hit);
+
+    // Реализация, которую сейчас использует DetectBatch
+    BeamKernelIsa ActiveBeamKernelIsa();
+
+    // Принудительный выбор реализации (для сравнения и замеров).
+    // Возвращает false, если процессор не поддерживает нужные инструкции
+    bool SelectBeamKernelIsa(BeamKernelIsa isa);
+
+    // Название реализации для вывода в отчеты
+    const char* BeamKernelIsaName(BeamKernelIsa isa);
+}
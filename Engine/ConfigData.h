@@ -0,0 +1,512 @@
+#pragma once // Предотвращает повторное включение этого файла
+
+#include "Scenario.h"
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace sim
+{
+    // Дополнительный радар сети. Поля, равные NaN, берутся у главного радара
+    struct RadarSite
+    {
+        float X;                    // Координаты радара относительно главного
+        float Y;
+        float RotationSpeedDps;
+        float BeamWidthDegrees;
+        float MaxDetectionRangeP;   // Дальность луча, как и у главного, - P / 1.5
+        float StartAngleDegrees;    // Начальный угол луча (по умолчанию 0)
+    };
+
+    // Точка профиля скорости ракеты: скорость Speed через TimeSec секунд полета
+    struct SpeedPoint
+    {
+        float TimeSec;
+        float Speed;
+
+        bool operator==(const SpeedPoint& other) const { return TimeSec == other.TimeSec && Speed == other.Speed; }
+    };
+
+    // Способ наведения ракеты
+    enum class RocketGuidance
+    {
+        Straight,   // Курс задается при запуске и не меняется
+        Pursuit     // Курс на каждом шаге поворачивается к цели (не быстрее RocketModelConfig::TurnRateDps)
+    };
+
+    // Модель полета ракет (ключи rocket_*, кроме rocket_speed). По умолчанию - прямой полет к радару
+    // с постоянной скоростью, как в исходной игре
+    struct RocketModelConfig
+    {
+        RocketGuidance Guidance = RocketGuidance::Straight;
+        float TurnRateDps = 0.0f;           // Предельная скорость поворота при наведении (0 - без ограничения)
+        float LaunchSpreadDegrees = 0.0f;   // Разброс курса при запуске: курс отклоняется от цели на +-половину
+        float WeaveAmplitudeDegrees = 0.0f; // "Змейка": отклонение курса от наведения меняется по синусу с этой амплитудой
+        float WeavePeriodSec = 2.0f;        // Период змейки
+        std::vector<SpeedPoint> SpeedProfile; // Скорость по времени полета (линейно между точками); пусто - rocket_speed
+        float MaxFlightSec = 0.0f;          // Ракета, не долетевшая за это время, самоуничтожается (0 - по дальности и скорости)
+
+        // Прямой полет с постоянной скоростью: ни наведения, ни маневров
+        bool Straight() const
+        {
+            return Guidance == RocketGuidance::Straight && LaunchSpreadDegrees == 0.0f
+                && WeaveAmplitudeDegrees == 0.0f && SpeedProfile.empty();
+        }
+    };
+
+    // Нативная версия параметров игры из settings.txt.
+    // Не зависит от .NET, поэтому используется и в окне, и в консольном запуске
+    struct ConfigData
+    {
+    private:
+        // Ключи конфигурации
+        enum class ConfigKey {
+            RocketSpeed,
+            DistanceCornerToCenter,
+            RadarBeamWidthDegrees,
+            RadarRotationSpeedDps,
+            RadarMaxDetectionRangeP,
+            RadarCircularAttackRange,
+            RadarCoreVulnerabilityRadius,
+            RadarDeadZoneRadius,
+            LaunchIntervalMinSec,
+            LaunchIntervalMaxSec,
+            TotalRocketsToLaunch,
+            RadarSweptBeam,
+            SimRateHz,
+            RenderRateHz,
+            RandomSeed,
+            RadarBucketIndex,
+            RadarSite,
+            RecordReplay,
+            RocketGuidance,
+            RocketTurnRateDps,
+            RocketLaunchSpreadDegrees,
+            RocketWeaveAmplitudeDegrees,
+            RocketWeavePeriodSec,
+            RocketSpeedProfile,
+            RocketMaxFlightSec,
+            Scenario,
+            StreamAddress,
+            Unknown // Для неизвестных ключей
+        };
+
+        // Статический словарь для сопоставления строк и enum.
+        // Создается один раз при первом обращении
+        static const std::unordered_map<std::string, ConfigKey>& KeyMap()
+        {
+            static const std::unordered_map<std::string, ConfigKey> keyMap = {
+                { "rocket_speed", ConfigKey::RocketSpeed },
+                { "distance_corner_to_center", ConfigKey::DistanceCornerToCenter },
+                { "radar_beam_width_degrees", ConfigKey::RadarBeamWidthDegrees },
+                { "radar_rotation_speed_dps", ConfigKey::RadarRotationSpeedDps },
+                { "radar_max_detection_range_P", ConfigKey::RadarMaxDetectionRangeP },
+                { "radar_circular_attack_range", ConfigKey::RadarCircularAttackRange },
+                { "radar_core_vulnerability_radius", ConfigKey::RadarCoreVulnerabilityRadius },
+                { "radar_dead_zone_radius", ConfigKey::RadarDeadZoneRadius },
+                { "launch_interval_min_sec", ConfigKey::LaunchIntervalMinSec },
+                { "launch_interval_max_sec", ConfigKey::LaunchIntervalMaxSec },
+                { "total_rockets_to_launch", ConfigKey::TotalRocketsToLaunch },
+                { "radar_swept_beam", ConfigKey::RadarSweptBeam },
+                { "sim_rate_hz", ConfigKey::SimRateHz },
+                { "render_rate_hz", ConfigKey::RenderRateHz },
+                { "random_seed", ConfigKey::RandomSeed },
+                { "record_replay", ConfigKey::RecordReplay },
+                { "radar_bucket_index", ConfigKey::RadarBucketIndex },
+                { "radar_site", ConfigKey::RadarSite },
+                { "rocket_guidance", ConfigKey::RocketGuidance },
+                { "rocket_turn_rate_dps", ConfigKey::RocketTurnRateDps },
+                { "rocket_launch_spread_degrees", ConfigKey::RocketLaunchSpreadDegrees },
+                { "rocket_weave_amplitude_degrees", ConfigKey::RocketWeaveAmplitudeDegrees },
+                { "rocket_weave_period_sec", ConfigKey::RocketWeavePeriodSec },
+                { "rocket_speed_profile", ConfigKey::RocketSpeedProfile },
+                { "rocket_max_flight_sec", ConfigKey::RocketMaxFlightSec },
+                { "scenario", ConfigKey::Scenario },
+                { "stream_address", ConfigKey::StreamAddress },
+            };
+            return keyMap;
+        }
+
+        // Удаляет пробелы и символы табуляции/перевода строки по краям
+        static std::string Trim(const std::string& s)
+        {
+            const char* spaces = " \t\r\n";
+            size_t begin = s.find_first_not_of(spaces);
+            if (begin == std::string::npos) return std::string();
+            size_t end = s.find_last_not_of(spaces);
+            return s.substr(begin, end - begin + 1);
+        }
+
+        // Разбор числа с проверкой, что вся строка является числом
+        static float ParseFloat(const std::string& value)
+        {
+            size_t used = 0;
+            float result = 0.0f;
+            try { result = std::stof(value, &used); }
+            catch (const std::logic_error&) { used = 0; } // std::stof сообщает только свое имя
+            if (used == 0 || used != value.size()) throw std::invalid_argument("некорректное число: " + value);
+            return result;
+        }
+
+        static int ParseInt(const std::string& value)
+        {
+            size_t used = 0;
+            int result = 0;
+            try { result = std::stoi(value, &used); }
+            catch (const std::logic_error&) { used = 0; } // std::stoi сообщает только свое имя
+            if (used == 0 || used != value.size()) throw std::invalid_argument("некорректное целое: " + value);
+            return result;
+        }
+
+        static uint64_t ParseUInt64(const std::string& value)
+        {
+            size_t used = 0;
+            if (!value.empty() && value[0] == '-') throw std::invalid_argument("ожидается неотрицательное целое: " + value);
+            uint64_t result = 0;
+            try { result = std::stoull(value, &used); }
+            catch (const std::logic_error&) { used = 0; } // std::stoull сообщает только свое имя
+            if (used == 0 || used != value.size()) throw std::invalid_argument("некорректное целое: " + value);
+            return result;
+        }
+
+        // "x,y[,скорость вращения[,ширина луча[,дальность P[,начальный угол]]]]"
+        static RadarSite ParseRadarSite(const std::string& value)
+        {
+            const float inherit = std::numeric_limits<float>::quiet_NaN();
+            float fields[6] = { 0.0f, 0.0f, inherit, inherit, inherit, 0.0f };
+            size_t count = 0, begin = 0;
+            for (;;)
+            {
+                size_t end = value.find(',', begin);
+                if (count == 6) throw std::invalid_argument("слишком много полей в radar_site: " + value);
+                fields[count++] = ParseFloat(Trim(value.substr(begin, end == std::string::npos ? std::string::npos : end - begin)));
+                if (end == std::string::npos) break;
+                begin = end + 1;
+            }
+            if (count < 2) throw std::invalid_argument("radar_site: ожидается x,y[,скорость[,ширина[,дальность[,угол]]]]: " + value);
+            return RadarSite{ fields[0], fields[1], fields[2], fields[3], fields[4], fields[5] };
+        }
+
+        // "время:скорость, время:скорость, ..." - время полета в секундах по возрастанию
+        static std::vector<SpeedPoint> ParseSpeedProfile(const std::string& value)
+        {
+            std::vector<SpeedPoint> points;
+            size_t begin = 0;
+            for (;;)
+            {
+                size_t end = value.find(',', begin);
+                std::string point = Trim(value.substr(begin, end == std::string::npos ? std::string::npos : end - begin));
+                size_t colon = point.find(':');
+                if (colon == std::string::npos) throw std::invalid_argument("rocket_speed_profile: ожидается время:скорость, ...: " + value);
+                points.push_back(SpeedPoint{ ParseFloat(Trim(point.substr(0, colon))), ParseFloat(Trim(point.substr(colon + 1))) });
+                if (end == std::string::npos) break;
+                begin = end + 1;
+            }
+            return points;
+        }
+
+        static RocketGuidance ParseGuidance(const std::string& value)
+        {
+            if (value == "straight") return RocketGuidance::Straight;
+            if (value == "pursuit") return RocketGuidance::Pursuit;
+            throw std::invalid_argument("ожидается straight или pursuit: " + value);
+        }
+
+        static bool ParseBool(const std::string& value)
+        {
+            if (value == "1" || value == "true") return true;
+            if (value == "0" || value == "false") return false;
+            throw std::invalid_argument("ожидается 0/1 или true/false: " + value);
+        }
+
+        // Запись одного значения в поле по ключу. При некорректном значении бросает std::invalid_argument
+        void ApplyValue(ConfigKey key, const std::string& value)
+        {
+            switch (key)
+            {
+            case ConfigKey::RocketSpeed:
+                RocketSpeed = ParseFloat(value);
+                break;
+            case ConfigKey::DistanceCornerToCenter:
+                DistanceCornerToCenter = ParseFloat(value);
+                break;
+            case ConfigKey::RadarBeamWidthDegrees:
+                RadarBeamWidthDegrees = ParseFloat(value);
+                break;
+            case ConfigKey::RadarRotationSpeedDps:
+                RadarRotationSpeedDps = ParseFloat(value);
+                break;
+            case ConfigKey::RadarMaxDetectionRangeP:
+                RadarMaxDetectionRangeP = ParseFloat(value);
+                break;
+            case ConfigKey::RadarCircularAttackRange:
+                RadarCircularAttackRange = ParseFloat(value);
+                break;
+            case ConfigKey::RadarCoreVulnerabilityRadius:
+                RadarCoreVulnerabilityRadius = ParseFloat(value);
+                break;
+            case ConfigKey::RadarDeadZoneRadius:
+                RadarDeadZoneRadius = ParseFloat(value);
+                break;
+            case ConfigKey::LaunchIntervalMinSec:
+                LaunchIntervalMinSec = ParseFloat(value);
+                break;
+            case ConfigKey::LaunchIntervalMaxSec:
+                LaunchIntervalMaxSec = ParseFloat(value);
+                break;
+            case ConfigKey::TotalRocketsToLaunch:
+                TotalRocketsToLaunch = ParseInt(value);
+                break;
+            case ConfigKey::RadarSweptBeam:
+                RadarSweptBeam = ParseBool(value);
+                break;
+            case ConfigKey::SimRateHz:
+                SimRateHz = ParseFloat(value);
+                break;
+            case ConfigKey::RenderRateHz:
+                RenderRateHz = ParseFloat(value);
+                break;
+            case ConfigKey::RandomSeed:
+                RandomSeed = ParseUInt64(value);
+                HasRandomSeed = true;
+                break;
+            case ConfigKey::RadarBucketIndex:
+                RadarBucketIndex = ParseBool(value);
+                break;
+            case ConfigKey::RadarSite:
+                // Ключ повторяется: каждая строка добавляет радар
+                RadarSites.push_back(ParseRadarSite(value));
+                break;
+            case ConfigKey::RecordReplay:
+                RecordReplayPath = value;
+                break;
+            case ConfigKey::StreamAddress:
+                StreamAddress = value;
+                break;
+            case ConfigKey::RocketGuidance:
+                RocketModel.Guidance = ParseGuidance(value);
+                break;
+            case ConfigKey::RocketTurnRateDps:
+                RocketModel.TurnRateDps = ParseFloat(value);
+                break;
+            case ConfigKey::RocketLaunchSpreadDegrees:
+                RocketModel.LaunchSpreadDegrees = ParseFloat(value);
+                break;
+            case ConfigKey::RocketWeaveAmplitudeDegrees:
+                RocketModel.WeaveAmplitudeDegrees = ParseFloat(value);
+                break;
+            case ConfigKey::RocketWeavePeriodSec:
+                RocketModel.WeavePeriodSec = ParseFloat(value);
+                break;
+            case ConfigKey::RocketSpeedProfile:
+                RocketModel.SpeedProfile = ParseSpeedProfile(value);
+                break;
+            case ConfigKey::RocketMaxFlightSec:
+                RocketModel.MaxFlightSec = ParseFloat(value);
+                break;
+            case ConfigKey::Scenario:
+                // Файл здесь не читается: settings.txt перечитывается при каждой правке, а сценарий может быть
+                // огромным. Сводку считает ScanScenarioInfo один раз перед партией или пакетом
+                ScenarioPath = value;
+                ScenarioInfo = ScenarioSummary();
+                ScenarioScanned = false;
+                break;
+            default:
+                break;
+            }
+        }
+
+    public:
+        // Поля для хранения параметров конфигурации
+        float RocketSpeed;
+        float DistanceCornerToCenter;
+        float RadarBeamWidthDegrees;
+        float RadarRotationSpeedDps;
+        float RadarMaxDetectionRangeP;
+        float RadarBeamEffectiveRadiusR;
+        float RadarCircularAttackRange;
+        float RadarCoreVulnerabilityRadius;
+        float RadarDeadZoneRadius;
+        float LaunchIntervalMinSec;
+        float LaunchIntervalMaxSec;
+        int TotalRocketsToLaunch;
+        bool RadarSweptBeam; // Непрерывная проверка перехвата по всему повороту луча за шаг (для больших шагов)
+        float SimRateHz;     // Частота шагов симуляции (фиксированный шаг 1 / SimRateHz)
+        float RenderRateHz;  // Частота перерисовки окна, не зависит от частоты симуляции
+        uint64_t RandomSeed; // Главный seed партии: из него выводятся потоки случайных чисел всех установок
+        bool HasRandomSeed;  // Задан ли random_seed в файле (иначе seed выбирается случайно)
+        bool RadarBucketIndex; // Проверять лучом только ракеты из секторов, которые он покрывает (для тысяч ракет)
+        std::vector<RadarSite> RadarSites; // Дополнительные радары сети (ключ radar_site, по строке на радар)
+        std::string RecordReplayPath; // Куда окно записывает каждую партию (ключ record_replay, пусто - не записывать)
+        std::string StreamAddress;    // Где окно раздает состояние партии зрителям (ключ stream_address: unix:/путь или tcp:порт)
+        RocketModelConfig RocketModel; // Наведение, маневры и профиль скорости ракет
+        std::string ScenarioPath;     // Файл сценария (ключ scenario): установки и залпы вместо четырех углов и общего таймера
+        ScenarioSummary ScenarioInfo; // Сводка этого файла (после ScanScenarioInfo)
+        bool ScenarioScanned = false; // ScenarioInfo посчитана для ScenarioPath
+
+        // Установки и залпы берутся из сценария
+        bool HasScenario() const { return !ScenarioPath.empty(); }
+
+        // Проверка сценария целиком и его сводка в ScenarioInfo. Файл читается только в первый раз: копии
+        // уже проверенной конфигурации (партии пакета, точки перебора) его не перечитывают.
+        // При ошибке в файле - false и текст в error
+        bool ScanScenarioInfo(std::string* error = nullptr)
+        {
+            if (!HasScenario() || ScenarioScanned) return true;
+            try
+            {
+                ScenarioInfo = ScanScenario(ScenarioPath);
+            }
+            catch (const std::exception& ex)
+            {
+                if (error) *error = ex.what();
+                return false;
+            }
+            ScenarioScanned = true;
+            return true;
+        }
+
+        // Наибольшее расстояние от установки до радара в центре
+        float LaunchDistance() const { return HasScenario() ? ScenarioInfo.LaunchDistance : DistanceCornerToCenter; }
+
+        ConfigData()
+        {
+            // Значения по умолчанию совпадают с прежней управляемой версией
+            RocketSpeed = 50.0f;
+            DistanceCornerToCenter = 250.0f;
+            RadarBeamWidthDegrees = 30.0f;
+            RadarRotationSpeedDps = 45.0f;
+            RadarMaxDetectionRangeP = 150.0f;
+            RadarCircularAttackRange = 40.0f;
+            RadarCoreVulnerabilityRadius = 10.0f;
+            RadarDeadZoneRadius = 10.0f;
+            LaunchIntervalMinSec = 5.0f;
+            LaunchIntervalMaxSec = 8.0f;
+            TotalRocketsToLaunch = 10;
+            RadarSweptBeam = false;
+            SimRateHz = 30.0f;
+            RenderRateHz = 30.0f;
+            RandomSeed = 0;
+            HasRandomSeed = false;
+            RadarBucketIndex = false;
+            RadarBeamEffectiveRadiusR = RadarMaxDetectionRangeP / 1.5f;
+        }
+
+        // Загрузка параметров из файла формата "ключ=значение".
+        // При ошибке возвращает false, а текст ошибки кладет в error (если он передан).
+        // Значения, прочитанные до ошибки, сохраняются, остальные остаются по умолчанию
+        bool LoadFromFile(const std::string& filename, std::string* error = nullptr)
+        {
+            try
+            {
+                std::ifstream sr(filename);
+                if (!sr) throw std::runtime_error("не удалось открыть файл " + filename);
+
+                std::string line;
+                while (std::getline(sr, line))
+                {
+                    line = Trim(line);
+                    if (line.empty() || line[0] == '#') continue;
+
+                    size_t eq = line.find('=');
+                    if (eq == std::string::npos || line.find('=', eq + 1) != std::string::npos) continue;
+
+                    std::string keyStr = Trim(line.substr(0, eq));
+                    std::string value = Trim(line.substr(eq + 1));
+
+                    auto it = KeyMap().find(keyStr);
+                    // Если ключ не найден в словаре, мы его просто игнорируем
+                    if (it == KeyMap().end()) continue;
+
+                    ApplyValue(it->second, value);
+                }
+
+                RadarBeamEffectiveRadiusR = RadarMaxDetectionRangeP / 1.5f;
+                return true;
+            }
+            catch (const std::exception& ex)
+            {
+                if (error) *error = ex.what();
+                RadarBeamEffectiveRadiusR = RadarMaxDetectionRangeP / 1.5f;
+                return false;
+            }
+        }
+
+        // Проверка допустимости значений (LoadFromFile проверяет только формат чисел).
+        // Нужна там, где конфигурация применяется к идущей партии (ConfigWatcher): ошибка правки
+        // не должна ломать партию. При ошибке возвращает false и имя ключа с причиной в error
+        bool Validate(std::string* error = nullptr) const
+        {
+            const char* problem = nullptr;
+            if (!(RocketSpeed > 0.0f) || !std::isfinite(RocketSpeed)) problem = "rocket_speed: ожидается число больше 0";
+            else if (!(DistanceCornerToCenter > 0.0f) || !std::isfinite(DistanceCornerToCenter)) problem = "distance_corner_to_center: ожидается число больше 0";
+            else if (!(RadarBeamWidthDegrees > 0.0f && RadarBeamWidthDegrees <= 360.0f)) problem = "radar_beam_width_degrees: ожидается число от 0 до 360";
+            else if (!std::isfinite(RadarRotationSpeedDps)) problem = "radar_rotation_speed_dps: ожидается конечное число";
+            else if (!(RadarMaxDetectionRangeP > 0.0f) || !std::isfinite(RadarMaxDetectionRangeP)) problem = "radar_max_detection_range_P: ожидается число больше 0";
+            else if (!(RadarCircularAttackRange >= 0.0f) || !std::isfinite(RadarCircularAttackRange)) problem = "radar_circular_attack_range: ожидается число не меньше 0";
+            else if (!(RadarCoreVulnerabilityRadius >= 0.0f) || !std::isfinite(RadarCoreVulnerabilityRadius)) problem = "radar_core_vulnerability_radius: ожидается число не меньше 0";
+            else if (!(RadarDeadZoneRadius >= 0.0f) || !std::isfinite(RadarDeadZoneRadius)) problem = "radar_dead_zone_radius: ожидается число не меньше 0";
+            else if (!(LaunchIntervalMinSec >= 0.0f) || !std::isfinite(LaunchIntervalMinSec)) problem = "launch_interval_min_sec: ожидается число не меньше 0";
+            else if (!(LaunchIntervalMaxSec >= LaunchIntervalMinSec) || !std::isfinite(LaunchIntervalMaxSec)) problem = "launch_interval_max_sec: ожидается число не меньше launch_interval_min_sec";
+            else if (TotalRocketsToLaunch < 0) problem = "total_rockets_to_launch: ожидается число не меньше 0";
+            else if (!(SimRateHz > 0.0f) || !std::isfinite(SimRateHz)) problem = "sim_rate_hz: ожидается число больше 0";
+            else if (!(RenderRateHz > 0.0f) || !std::isfinite(RenderRateHz)) problem = "render_rate_hz: ожидается число больше 0";
+            else if (!(RocketModel.TurnRateDps >= 0.0f) || !std::isfinite(RocketModel.TurnRateDps)) problem = "rocket_turn_rate_dps: ожидается число не меньше 0";
+            else if (!(RocketModel.LaunchSpreadDegrees >= 0.0f && RocketModel.LaunchSpreadDegrees <= 360.0f)) problem = "rocket_launch_spread_degrees: ожидается число от 0 до 360";
+            else if (!(RocketModel.WeaveAmplitudeDegrees >= 0.0f && RocketModel.WeaveAmplitudeDegrees < 90.0f)) problem = "rocket_weave_amplitude_degrees: ожидается число от 0 до 90";
+            else if (!(RocketModel.WeavePeriodSec >= 0.01f) || !std::isfinite(RocketModel.WeavePeriodSec)) problem = "rocket_weave_period_sec: ожидается число не меньше 0.01";
+            else if (!(RocketModel.MaxFlightSec >= 0.0f) || !std::isfinite(RocketModel.MaxFlightSec)) problem = "rocket_max_flight_sec: ожидается число не меньше 0";
+            for (size_t k = 0; problem == nullptr && k < RocketModel.SpeedProfile.size(); k++)
+            {
+                const SpeedPoint& point = RocketModel.SpeedProfile[k];
+                if (!(point.TimeSec >= 0.0f) || !std::isfinite(point.TimeSec) || (k > 0 && !(point.TimeSec > RocketModel.SpeedProfile[k - 1].TimeSec)))
+                    problem = "rocket_speed_profile: время ожидается неотрицательным и возрастающим";
+                else if (!(point.Speed >= 0.0f) || !std::isfinite(point.Speed)) problem = "rocket_speed_profile: скорость ожидается не меньше 0";
+            }
+            // Ракета, остановившаяся навсегда, не долетела бы и не самоуничтожилась бы (предел по дальности бесконечен)
+            if (problem == nullptr && !RocketModel.SpeedProfile.empty() && !(RocketModel.SpeedProfile.back().Speed > 0.0f))
+                problem = "rocket_speed_profile: конечная скорость ожидается больше 0";
+            for (size_t k = 0; problem == nullptr && k < RadarSites.size(); k++)
+            {
+                const RadarSite& site = RadarSites[k];
+                // NaN - параметр берется у главного радара, иначе значение должно быть допустимым
+                if (!std::isfinite(site.X) || !std::isfinite(site.Y) || !std::isfinite(site.StartAngleDegrees)) problem = "radar_site: ожидаются конечные координаты и угол";
+                else if (std::isinf(site.RotationSpeedDps)) problem = "radar_site: ожидается конечная скорость вращения";
+                else if (!std::isnan(site.BeamWidthDegrees) && !(site.BeamWidthDegrees > 0.0f && site.BeamWidthDegrees <= 360.0f)) problem = "radar_site: ширина луча ожидается от 0 до 360";
+                else if (!std::isnan(site.MaxDetectionRangeP) && !(site.MaxDetectionRangeP > 0.0f && std::isfinite(site.MaxDetectionRangeP))) problem = "radar_site: дальность ожидается больше 0";
+            }
+            if (problem == nullptr) return true;
+            if (error) *error = problem;
+            return false;
+        }
+
+        // Установка одного параметра по имени ключа из settings.txt (например, при переборе параметров).
+        // При неизвестном ключе или некорректном значении возвращает false и не меняет конфигурацию
+        bool SetValue(const std::string& keyName, const std::string& value, std::string* error = nullptr)
+        {
+            auto it = KeyMap().find(keyName);
+            if (it == KeyMap().end())
+            {
+                if (error) *error = "неизвестный ключ: " + keyName;
+                return false;
+            }
+            try
+            {
+                ConfigData updated = *this;
+                updated.ApplyValue(it->second, Trim(value));
+                updated.RadarBeamEffectiveRadiusR = updated.RadarMaxDetectionRangeP / 1.5f;
+                *this = updated;
+                return true;
+            }
+            catch (const std::exception& ex)
+            {
+                if (error) *error = keyName + ": " + ex.what();
+                return false;
+            }
+        }
+    };
+}
@@ -0,0 +1,272 @@
+// Слежение за settings.txt и разбор правок вне потока симуляции
+#include "ConfigWatcher.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+#ifdef __linux__
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace sim
+{
+    namespace
+    {
+        // Пауза после изменения файла: редакторы пишут и переименовывают файл в несколько приемов
+        const int SettleMs = 50;
+        // Период опроса времени изменения файла там, где нет inotify
+        const int PollMs = 250;
+
+        // Время изменения и размер файла: по ним опрос замечает правку
+        struct FileStamp
+        {
+            std::filesystem::file_time_type Time;
+            std::uintmax_t Size = 0;
+            bool Exists = false;
+
+            bool operator==(const FileStamp& other) const
+            {
+                return Exists == other.Exists && Size == other.Size && Time == other.Time;
+            }
+            bool operator!=(const FileStamp& other) const { return !(*this == other); }
+        };
+
+        FileStamp StampOf(const std::string& path)
+        {
+            FileStamp stamp;
+            std::error_code error;
+            stamp.Time = std::filesystem::last_write_time(path, error);
+            if (error) return stamp;
+            stamp.Size = std::filesystem::file_size(path, error);
+            stamp.Exists = !error;
+            return stamp;
+        }
+    }
+
+    struct ConfigWatcher::Impl
+    {
+        std::string Path;
+        std::string FileName;                   // Имя файла без каталога (так его называют события inotify)
+        std::atomic<ConfigData*> Pending;       // Проверенная конфигурация, которую еще не забрали
+        std::atomic<uint64_t> RejectedCount;
+        mutable std::mutex ErrorLock;
+        std::string LastError;
+
+        std::mutex WakeLock;                    // Остановка потока опроса
+        std::condition_variable Wake;
+        bool StopRequested = false;
+        std::thread Worker;
+#ifdef __linux__
+        int Inotify = -1;
+        int WakePipe[2] = { -1, -1 };           // Запись в канал будит поток, ждущий события inotify
+#endif
+
+        Impl() : Pending(nullptr), RejectedCount(0) {}
+
+        // Разбор и проверка файла; готовая конфигурация заменяет еще не забранную
+        void Reload()
+        {
+            ConfigData* config = new ConfigData();
+            std::string error;
+            if (!config->LoadFromFile(Path, &error) || !config->Validate(&error))
+            {
+                delete config;
+                RejectedCount.fetch_add(1, std::memory_order_relaxed);
+                std::lock_guard<std::mutex> lock(ErrorLock);
+                LastError = error;
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(ErrorLock);
+                LastError.clear();
+            }
+            delete Pending.exchange(config, std::memory_order_acq_rel);
+        }
+
+        void Run()
+        {
+#ifdef __linux__
+            if (Inotify >= 0)
+            {
+                RunInotify();
+                return;
+            }
+#endif
+            RunPolling();
+        }
+
+        // Опрос времени изменения. Файл перечитывается, когда отметка сменилась и держится один период опроса
+        void RunPolling()
+        {
+            FileStamp applied = StampOf(Path);
+            FileStamp seen = applied;
+            std::unique_lock<std::mutex> lock(WakeLock);
+            while (!Wake.wait_for(lock, std::chrono::milliseconds(PollMs), [this]() { return StopRequested; }))
+            {
+                FileStamp current = StampOf(Path);
+                bool settled = current == seen;
+                seen = current;
+                if (!settled || current == applied || !current.Exists) continue;
+                applied = current;
+                lock.unlock();
+                Reload();
+                lock.lock();
+            }
+        }
+
+#ifdef __linux__
+        // Разбор накопленных событий inotify. true - среди них есть событие нашего файла
+        bool DrainEvents()
+        {
+            alignas(inotify_event) char buffer[4096];
+            bool touched = false;
+            for (;;)
+            {
+                ssize_t size = read(Inotify, buffer, sizeof(buffer));
+                if (size <= 0) return touched;
+                for (ssize_t offset = 0; offset < size; )
+                {
+                    const inotify_event* event = (const inotify_event*)(buffer + offset);
+                    // При переполнении очереди событий имя неизвестно - перечитываем на всякий случай
+                    if ((event->mask & IN_Q_OVERFLOW) || (event->len > 0 && FileName == event->name)) touched = true;
+                    offset += sizeof(inotify_event) + event->len;
+                }
+            }
+        }
+
+        // Каталог файла слушается целиком: редакторы часто сохраняют через новый файл и переименование
+        void RunInotify()
+        {
+            pollfd fds[2] = { { Inotify, POLLIN, 0 }, { WakePipe[0], POLLIN, 0 } };
+            for (;;)
+            {
+                int ready = poll(fds, 2, -1);
+                if (ready < 0 && errno == EINTR) continue;
+                if (ready < 0 || fds[1].revents) return;
+                if (!DrainEvents()) continue;
+
+                // Собираем события, пока запись не затихнет, затем перечитываем файл один раз
+                while ((ready = poll(fds, 2, SettleMs)) != 0)
+                {
+                    if (ready < 0 && errno == EINTR) continue;
+                    if (ready < 0 || fds[1].revents) return;
+                    DrainEvents();
+                }
+                Reload();
+            }
+        }
+
+        void CloseHandles()
+        {
+            if (Inotify >= 0) close(Inotify);
+            if (WakePipe[0] >= 0) close(WakePipe[0]);
+            if (WakePipe[1] >= 0) close(WakePipe[1]);
+            Inotify = WakePipe[0] = WakePipe[1] = -1;
+        }
+#endif
+    };
+
+    ConfigWatcher::ConfigWatcher() : impl(new Impl()) {}
+
+    ConfigWatcher::~ConfigWatcher()
+    {
+        Stop();
+        delete impl->Pending.exchange(nullptr);
+        delete impl;
+    }
+
+    bool ConfigWatcher::Start(const std::string& path, std::string* error)
+    {
+        Stop();
+        std::filesystem::path file(path);
+        std::filesystem::path directory = file.has_parent_path() ? file.parent_path() : std::filesystem::path(".");
+        std::error_code status;
+        if (!std::filesystem::is_directory(directory, status))
+        {
+            if (error) *error = "каталог недоступен: " + directory.string();
+            return false;
+        }
+
+        impl->Path = path;
+        impl->FileName = file.filename().string();
+        impl->RejectedCount.store(0, std::memory_order_relaxed);
+        impl->LastError.clear();
+        delete impl->Pending.exchange(nullptr);
+        impl->StopRequested = false;
+
+#ifdef __linux__
+        // Без inotify (исчерпан лимит, особая файловая система) остается опрос
+        impl->Inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (impl->Inotify >= 0
+            && (inotify_add_watch(impl->Inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0
+                || pipe2(impl->WakePipe, O_CLOEXEC) != 0))
+        {
+            impl->CloseHandles();
+        }
+#endif
+        impl->Worker = std::thread([this]() { impl->Run(); });
+        return true;
+    }
+
+    void ConfigWatcher::Stop()
+    {
+        if (!impl->Worker.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(impl->WakeLock);
+            impl->StopRequested = true;
+        }
+        impl->Wake.notify_all();
+#ifdef __linux__
+        if (impl->WakePipe[1] >= 0)
+        {
+            char wake = 1;
+            while (write(impl->WakePipe[1], &wake, 1) < 0 && errno == EINTR) {}
+        }
+#endif
+        impl->Worker.join();
+#ifdef __linux__
+        impl->CloseHandles();
+#endif
+    }
+
+    bool ConfigWatcher::Watching() const
+    {
+        return impl->Worker.joinable();
+    }
+
+    const std::string& ConfigWatcher::Path() const
+    {
+        return impl->Path;
+    }
+
+    bool ConfigWatcher::TakeUpdate(ConfigData& config)
+    {
+        // Пока файл не менялся, обходимся без атомарной записи
+        if (impl->Pending.load(std::memory_order_relaxed) == nullptr) return false;
+        ConfigData* next = impl->Pending.exchange(nullptr, std::memory_order_acq_rel);
+        if (next == nullptr) return false;
+        config = std::move(*next);
+        delete next;
+        return true;
+    }
+
+    uint64_t ConfigWatcher::Rejected() const
+    {
+        return impl->RejectedCount.load(std::memory_order_relaxed);
+    }
+
+    std::string ConfigWatcher::LastError() const
+    {
+        std::lock_guard<std::mutex> lock(impl->ErrorLock);
+        return impl->LastError;
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "ConfigData.h"
+#include <cstdint>
+#include <string>
+
+namespace sim
+{
+    // Слежение за settings.txt во время партии.
+    // Фоновый поток ждет изменения файла (inotify в Linux, в остальных системах - опрос времени изменения),
+    // читает и проверяет его (ConfigData::LoadFromFile и Validate) и выкладывает готовую конфигурацию.
+    // Поток симуляции между шагами забирает ее вызовом TakeUpdate: пока файл не менялся, это одно атомарное чтение,
+    // разбор и проверка в шаг не попадают. Файл с ошибкой не применяется, текст ошибки - в LastError.
+    // Потоки и атомарные переменные спрятаны в ConfigWatcher.cpp: заголовок подключается и из C++/CLI
+    class ConfigWatcher
+    {
+    public:
+        ConfigWatcher();
+        ~ConfigWatcher();
+
+        ConfigWatcher(const ConfigWatcher&) = delete;
+        ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+        // Начать слежение за файлом (прежнее слежение останавливается). false - каталог файла недоступен
+        bool Start(const std::string& path, std::string* error = nullptr);
+        void Stop();
+
+        bool Watching() const;
+        const std::string& Path() const;
+
+        // Новая проверенная конфигурация, если файл изменился после прошлого вызова. Вызывается из одного потока
+        bool TakeUpdate(ConfigData& config);
+
+        // Сколько правок файла отвергнуто (ошибка разбора или проверки) и текст последней ошибки
+        uint64_t Rejected() const;
+        std::string LastError() const;
+
+    private:
+        struct Impl;
+        Impl* impl;
+    };
+}
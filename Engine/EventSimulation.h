@@ -0,0 +1,355 @@
+#pragma once
+
+#include "Simulation.h"
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <string>
+#include <vector>
+
+namespace sim
+{
+    // Событийный (аналитический) движок партии.
+    // Ракеты летят по прямой к радару с постоянной скоростью, а луч вращается с постоянной угловой скоростью,
+    // поэтому момент входа ракеты в луч, вход в мертвую зону и попадание в ядро решаются в замкнутой форме.
+    // Вместо шагов по 33 мс движок обрабатывает очередь будущих событий (запуск, перехват лучом, попадание в ядро),
+    // а координаты ракеты считаются по требованию из времени запуска и скорости.
+    // Время непрерывное, поэтому итог совпадает с пошаговым Simulation в пределе малого шага,
+    // а не побитово: там запуск и перехват округляются до границы шага
+    class EventSimulation
+    {
+    public:
+        // Чем закончился полет ракеты
+        enum class FlightEnd
+        {
+            Intercepted,    // Перехвачена лучом
+            CoreHit,        // Долетела до ядра
+            Never           // Никогда не долетит и не будет перехвачена (нулевая скорость вне луча)
+        };
+
+        // Полет одной ракеты: положение в любой момент вычисляется из Origin, Velocity и LaunchTimeSec
+        struct Flight
+        {
+            int LauncherId;         // Какая установка запустила ракету
+            Vec2 Origin;            // Точка запуска
+            Vec2 Velocity;          // Вектор скорости
+            double LaunchTimeSec;   // Время запуска
+            double EndTimeSec;      // Время перехвата или попадания в ядро (бесконечность для Never)
+            FlightEnd End;          // Итог полета (предсказан при запуске, наступает в EndTimeSec)
+            bool Finished;          // Событие окончания полета уже обработано
+        };
+
+        ConfigData Config;
+        Radar MainRadar;                    // Параметры радара (угол луча вычисляется через BeamAngleAt)
+        std::vector<Launcher> Launchers;
+        std::vector<Flight> Flights;        // Все запущенные ракеты в порядке запуска
+
+        int RocketsLaunchedCount;
+        int RocketsInterceptedCount;
+        int RocketsInFlightCount;
+        bool GameOver;
+        Outcome Result;
+        double ElapsedSec;                  // Время последнего обработанного события (или RunUntil)
+        uint64_t EventCount;                // Сколько событий обработано
+        uint64_t Seed;
+
+        // Может ли движок сыграть партию с такой конфигурацией. Сеть радаров не поддерживается:
+        // ракета, погибшая на дополнительном радаре, меняет итог полета после запуска
+        static bool Supports(const ConfigData& config, std::string* reason = nullptr)
+        {
+            if (!config.RadarSites.empty())
+            {
+                if (reason) *reason = "событийный движок не поддерживает сеть радаров (radar_site)";
+                return false;
+            }
+            // Запуски считаются по общему таймеру четырех установок
+            if (config.HasScenario())
+            {
+                if (reason) *reason = "событийный движок не поддерживает сценарии (scenario)";
+                return false;
+            }
+            // Время встречи с лучом считается для прямого полета с постоянной скоростью
+            if (!config.RocketModel.Straight())
+            {
+                if (reason) *reason = "событийный движок не поддерживает наведение, маневр и профиль скорости ракет (rocket_guidance и др.)";
+                return false;
+            }
+            return true;
+        }
+
+        EventSimulation(const ConfigData& config, uint64_t seed)
+            : MainRadar(Vec2(0, 0), 0, 0, 0, 0, 0, 0, 0)
+        {
+            Reset(config, seed);
+        }
+
+        // Инициализация партии. Потоки случайных чисел те же, что и у Simulation с тем же seed,
+        // поэтому интервалы перезарядки совпадают
+        void Reset(const ConfigData& config, uint64_t seed)
+        {
+            Config = config;
+            Seed = seed;
+            launchRandom = RandomStream(seed, StreamLaunchSchedule);
+
+            MainRadar = Radar(Vec2(0, 0), Config.RadarRotationSpeedDps, Config.RadarBeamWidthDegrees,
+                Config.RadarMaxDetectionRangeP, Config.RadarBeamEffectiveRadiusR,
+                Config.RadarCircularAttackRange, Config.RadarCoreVulnerabilityRadius,
+                Config.RadarDeadZoneRadius);
+            Launchers = MakeCornerLaunchers(Config, seed);
+
+            // Собственный таймер установки отсчитывается от начала партии
+            launcherReadySec.clear();
+            for (const Launcher& launcher : Launchers) launcherReadySec.push_back(launcher.TimeToNextLaunchSec);
+
+            Flights.clear();
+            events = EventQueue();
+            eventOrder = 0;
+            destroyedAtSec = 0.0;
+
+            RocketsLaunchedCount = 0;
+            RocketsInterceptedCount = 0;
+            RocketsInFlightCount = 0;
+            GameOver = false;
+            Result = Outcome::InProgress;
+            ElapsedSec = 0.0;
+            EventCount = 0;
+
+            if (Config.TotalRocketsToLaunch > 0 && !Launchers.empty())
+            {
+                // Первая ракета может стартовать немедленно, если установка уже перезарядилась
+                Push(std::max(0.0, launcherReadySec[0]), EventType::Launch, 0);
+            }
+            else
+            {
+                CheckVictory();
+            }
+        }
+
+        // Время ближайшего необработанного события (бесконечность, если событий нет)
+        double NextEventTimeSec() const
+        {
+            return events.empty() || GameOver ? Infinity() : events.top().TimeSec;
+        }
+
+        // Обработка одного ближайшего события. Возвращает false, если событий больше нет
+        bool ProcessNextEvent()
+        {
+            if (GameOver || events.empty()) return false;
+
+            Event event = events.top();
+            events.pop();
+            ElapsedSec = event.TimeSec;
+            EventCount++;
+
+            switch (event.Type)
+            {
+            case EventType::Launch:
+                Launch(event.TimeSec, event.Index);
+                break;
+            case EventType::Intercept:
+                Flights[event.Index].Finished = true;
+                RocketsInterceptedCount++;
+                RocketsInFlightCount--;
+                break;
+            case EventType::CoreHit:
+                Flights[event.Index].Finished = true;
+                RocketsInFlightCount--;
+                MainRadar.IsDestroyed = true;
+                MainRadar.SetAngleDegrees(BeamAngleAt(event.TimeSec));
+                destroyedAtSec = event.TimeSec;
+                GameOver = true;
+                Result = Outcome::RadarDestroyed;
+                return true;
+            }
+
+            CheckVictory();
+            return true;
+        }
+
+        // Обработка всех событий до момента timeSec включительно
+        Outcome RunUntil(double timeSec)
+        {
+            while (!GameOver && NextEventTimeSec() <= timeSec) ProcessNextEvent();
+            if (!GameOver && timeSec > ElapsedSec) ElapsedSec = timeSec;
+            return Result;
+        }
+
+        // Прогон партии до конца. maxTimeSec ограничивает игровое время (0 - без ограничения).
+        // Возвращает итог партии (InProgress, если сработало ограничение или событий больше нет)
+        Outcome RunToEnd(double maxTimeSec = 0.0)
+        {
+            if (maxTimeSec > 0.0) return RunUntil(maxTimeSec);
+            while (ProcessNextEvent()) {}
+            return Result;
+        }
+
+        // Координаты ракеты в момент timeSec
+        static Vec2 PositionAt(const Flight& flight, double timeSec)
+        {
+            double t = timeSec - flight.LaunchTimeSec;
+            return Vec2((float)(flight.Origin.X + flight.Velocity.X * t), (float)(flight.Origin.Y + flight.Velocity.Y * t));
+        }
+
+        // Угол луча в момент timeSec (после уничтожения радара луч замирает)
+        float BeamAngleAt(double timeSec) const
+        {
+            if (MainRadar.IsDestroyed && timeSec >= destroyedAtSec) return MainRadar.AngleDegrees();
+            return BinaryAngleToDegrees(BinaryAngleFromDegrees((double)MainRadar.RotationSpeedDps * timeSec));
+        }
+
+    private:
+        enum class EventType
+        {
+            Launch,     // Index - номер запуска
+            Intercept,  // Index - номер ракеты в Flights
+            CoreHit     // Index - номер ракеты в Flights
+        };
+
+        struct Event
+        {
+            double TimeSec;
+            EventType Type;
+            int Index;
+            uint64_t Order; // Порядок добавления: при равном времени события обрабатываются в нем, итог детерминирован
+        };
+
+        // Сравнение для std::priority_queue: наверху самое раннее событие
+        struct Later
+        {
+            bool operator()(const Event& a, const Event& b) const
+            {
+                if (a.TimeSec != b.TimeSec) return a.TimeSec > b.TimeSec;
+                return a.Order > b.Order;
+            }
+        };
+
+        typedef std::priority_queue<Event, std::vector<Event>, Later> EventQueue;
+
+        EventQueue events;
+        uint64_t eventOrder;
+        RandomStream launchRandom;              // Тот же поток общего таймера запуска, что и в Simulation
+        std::vector<double> launcherReadySec;   // Когда каждая установка перезарядится
+        double destroyedAtSec;
+
+        static double Infinity()
+        {
+            return std::numeric_limits<double>::infinity();
+        }
+
+        void Push(double timeSec, EventType type, int index)
+        {
+            events.push(Event{ timeSec, type, index, eventOrder++ });
+        }
+
+        void CheckVictory()
+        {
+            if (RocketsLaunchedCount >= Config.TotalRocketsToLaunch && RocketsInFlightCount == 0)
+            {
+                Result = RocketsInterceptedCount == Config.TotalRocketsToLaunch ? Outcome::Victory : Outcome::DefenseFailed;
+                GameOver = true;
+            }
+        }
+
+        // Запуск с номером launchIndex в момент timeSec. Установки стреляют по кругу, как в Simulation:
+        // следующий запуск - не раньше общей задержки и не раньше перезарядки следующей установки
+        void Launch(double timeSec, int launchIndex)
+        {
+            int launcherIndex = launchIndex % (int)Launchers.size();
+            Launcher& launcher = Launchers[launcherIndex];
+            Rocket rocket = launcher.Fire(MainRadar.Position, Config.RocketSpeed);
+            launcherReadySec[launcherIndex] = timeSec + launcher.TimeToNextLaunchSec;
+
+            Flight flight;
+            flight.LauncherId = launcher.Id;
+            flight.Origin = rocket.Position;
+            flight.Velocity = rocket.Velocity;
+            flight.LaunchTimeSec = timeSec;
+            flight.Finished = false;
+            PredictFlight(flight, rocket.Speed);
+            Flights.push_back(flight);
+            RocketsLaunchedCount++;
+            RocketsInFlightCount++;
+
+            int flightIndex = (int)Flights.size() - 1;
+            if (flight.End == FlightEnd::Intercepted) Push(flight.EndTimeSec, EventType::Intercept, flightIndex);
+            else if (flight.End == FlightEnd::CoreHit) Push(flight.EndTimeSec, EventType::CoreHit, flightIndex);
+
+            double globalReadySec = timeSec + launchRandom.NextRange(Config.LaunchIntervalMinSec, Config.LaunchIntervalMaxSec);
+            int next = launchIndex + 1;
+            if (next < Config.TotalRocketsToLaunch)
+            {
+                Push(std::max(globalReadySec, launcherReadySec[next % (int)Launchers.size()]), EventType::Launch, next);
+            }
+        }
+
+        // Первый момент не раньше timeSec, когда направление bearingDeg попадает в луч (бесконечность, если никогда)
+        double FirstBeamTime(double bearingDeg, double timeSec) const
+        {
+            double halfWidth = MainRadar.BeamWidthDegrees / 2.0;
+            if (halfWidth >= 180.0) return timeSec;
+
+            double omega = MainRadar.RotationSpeedDps;
+            // Угол луча относительно направления на ракету в диапазоне [-180, 180)
+            double phase = std::fmod(omega * timeSec - bearingDeg, 360.0);
+            if (phase < -180.0) phase += 360.0;
+            if (phase >= 180.0) phase -= 360.0;
+            if (std::fabs(phase) <= halfWidth) return timeSec;
+            if (omega == 0.0) return Infinity();
+
+            // Сколько градусов лучу осталось пройти до ближней по ходу вращения кромки
+            double degrees = omega > 0.0 ? std::fmod(-halfWidth - phase + 720.0, 360.0)
+                                         : std::fmod(phase - halfWidth + 720.0, 360.0);
+            return timeSec + degrees / std::fabs(omega);
+        }
+
+        // Итог полета в замкнутой форме. Ракета летит прямо на радар, поэтому направление на нее постоянно,
+        // а расстояние убывает линейно: она доступна лучу, пока DeadZone < r(t) <= R,
+        // и перехватывается в первый момент этого интервала, когда луч проходит через ее направление
+        void PredictFlight(Flight& flight, float speed) const
+        {
+            double dx = flight.Origin.X - MainRadar.Position.X;
+            double dy = flight.Origin.Y - MainRadar.Position.Y;
+            double startDist = std::sqrt(dx * dx + dy * dy);
+            double bearingDeg = std::atan2(dy, dx) * 180.0 / M_PI;
+            double t0 = flight.LaunchTimeSec;
+            bool moving = speed > 0.0f && (flight.Velocity.X != 0.0f || flight.Velocity.Y != 0.0f);
+
+            double range = MainRadar.BeamEffectiveRadiusR;
+            double deadZone = MainRadar.DeadZoneRadius;
+            double core = MainRadar.CoreVulnerabilityRadius;
+
+            double enterSec, exitSec, coreSec;
+            if (moving)
+            {
+                enterSec = t0 + std::max(0.0, (startDist - range) / speed);
+                exitSec = t0 + (startDist - deadZone) / speed;
+                coreSec = t0 + std::max(0.0, (startDist - core) / speed);
+            }
+            else
+            {
+                bool inRange = startDist > deadZone && startDist <= range;
+                enterSec = inRange ? t0 : Infinity();
+                exitSec = inRange ? Infinity() : t0;
+                coreSec = startDist <= core ? t0 : Infinity();
+            }
+
+            double hitSec = enterSec < exitSec ? FirstBeamTime(bearingDeg, enterSec) : Infinity();
+            // При одновременном попадании в ядро и в луч ракета долетает: в Simulation ядро проверяется первым
+            if (hitSec < exitSec && hitSec < coreSec)
+            {
+                flight.End = FlightEnd::Intercepted;
+                flight.EndTimeSec = hitSec;
+            }
+            else if (coreSec < Infinity())
+            {
+                flight.End = FlightEnd::CoreHit;
+                flight.EndTimeSec = coreSec;
+            }
+            else
+            {
+                flight.End = FlightEnd::Never;
+                flight.EndTimeSec = Infinity();
+            }
+        }
+    };
+}
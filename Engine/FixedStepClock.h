@@ -0,0 +1,61 @@
+#pragma once
+
+namespace sim
+{
+    // Накопитель реального времени для симуляции с фиксированным шагом.
+    // Окно сообщает, сколько реального времени прошло с прошлого кадра (по высокоточным часам),
+    // а накопитель отвечает, сколько фиксированных шагов симуляции нужно сделать.
+    // Итог партии зависит только от длины шага, а не от того, насколько загружена машина:
+    // при задержке кадра просто выполняется больше шагов подряд
+    class FixedStepClock
+    {
+    public:
+        FixedStepClock()
+        {
+            Reset(1.0 / 30.0, 0.5);
+        }
+
+        FixedStepClock(double stepSec, double maxCatchUpSec)
+        {
+            Reset(stepSec, maxCatchUpSec);
+        }
+
+        // stepSec - длина шага симуляции, maxCatchUpSec - сколько реального времени
+        // можно "догнать" за один кадр (защита от лавины шагов после долгой остановки)
+        void Reset(double stepSec, double maxCatchUpSec)
+        {
+            StepSec = stepSec;
+            MaxCatchUpSec = maxCatchUpSec;
+            accumulatorSec = 0.0;
+        }
+
+        // Добавить прошедшее реальное время, вернуть число шагов, которые нужно выполнить сейчас
+        int Advance(double elapsedSec)
+        {
+            if (elapsedSec < 0.0) elapsedSec = 0.0;
+            accumulatorSec += elapsedSec;
+            if (accumulatorSec > MaxCatchUpSec) accumulatorSec = MaxCatchUpSec;
+
+            int steps = 0;
+            while (accumulatorSec >= StepSec)
+            {
+                accumulatorSec -= StepSec;
+                steps++;
+            }
+            return steps;
+        }
+
+        // Доля шага, прошедшая после последнего выполненного шага, в диапазоне [0, 1).
+        // Используется для интерполяции положения объектов при отрисовке
+        float Alpha() const
+        {
+            return StepSec > 0.0 ? (float)(accumulatorSec / StepSec) : 0.0f;
+        }
+
+        double StepSec;        // Длина фиксированного шага симуляции в секундах
+        double MaxCatchUpSec;  // Максимум реального времени, отрабатываемого за один кадр
+
+    private:
+        double accumulatorSec; // Реальное время, еще не отработанное шагами симуляции
+    };
+}
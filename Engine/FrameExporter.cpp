@@ -0,0 +1,375 @@
+// Запись кадров партии в фоновом потоке: PPM, PNG или сырые кадры во внешнюю программу
+#include "FrameExporter.h"
+#include "FrameRenderer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+namespace sim
+{
+    namespace
+    {
+        // Таблицы CRC-32 для обработки по 8 байт за итерацию (slicing-by-8)
+        struct CrcTable
+        {
+            uint32_t Entries[8][256];
+
+            CrcTable()
+            {
+                for (uint32_t n = 0; n < 256; n++)
+                {
+                    uint32_t c = n;
+                    for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                    Entries[0][n] = c;
+                }
+                for (uint32_t n = 0; n < 256; n++)
+                {
+                    for (int t = 1; t < 8; t++) Entries[t][n] = (Entries[t - 1][n] >> 8) ^ Entries[0][Entries[t - 1][n] & 0xFF];
+                }
+            }
+        };
+
+        // CRC-32 для блоков PNG
+        uint32_t Crc32(const uint8_t* data, size_t size, uint32_t crc = 0)
+        {
+            static const CrcTable table;
+            const uint32_t (*t)[256] = table.Entries;
+            crc = ~crc;
+            for (; size >= 8; size -= 8, data += 8)
+            {
+                uint32_t lo = crc ^ ((uint32_t)data[0] | (uint32_t)data[1] << 8 | (uint32_t)data[2] << 16 | (uint32_t)data[3] << 24);
+                crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24]
+                    ^ t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+            }
+            for (; size > 0; size--, data++) crc = t[0][(crc ^ *data) & 0xFF] ^ (crc >> 8);
+            return ~crc;
+        }
+
+        void PutU32(std::vector<uint8_t>& out, uint32_t value)
+        {
+            out.push_back((uint8_t)(value >> 24)); out.push_back((uint8_t)(value >> 16));
+            out.push_back((uint8_t)(value >> 8)); out.push_back((uint8_t)value);
+        }
+
+        void PutChunk(std::vector<uint8_t>& out, const char* type, const uint8_t* data, size_t size)
+        {
+            PutU32(out, (uint32_t)size);
+            size_t start = out.size();
+            out.insert(out.end(), type, type + 4);
+            out.insert(out.end(), data, data + size);
+            PutU32(out, Crc32(&out[start], size + 4));
+        }
+
+        // PNG RGB 8 бит без сжатия: поток zlib из несжатых блоков deflate (stored).
+        // Файл крупнее сжатого, зато кодирование - это копирование памяти и не нужна zlib
+        void EncodePng(const SoftwareRaster& frame, std::vector<uint8_t>& out, std::vector<uint8_t>& raw, std::vector<uint8_t>& scratch)
+        {
+            static const uint8_t Signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+            out.assign(Signature, Signature + sizeof(Signature));
+
+            uint8_t header[13];
+            uint32_t w = (uint32_t)frame.Width(), h = (uint32_t)frame.Height();
+            header[0] = (uint8_t)(w >> 24); header[1] = (uint8_t)(w >> 16); header[2] = (uint8_t)(w >> 8); header[3] = (uint8_t)w;
+            header[4] = (uint8_t)(h >> 24); header[5] = (uint8_t)(h >> 16); header[6] = (uint8_t)(h >> 8); header[7] = (uint8_t)h;
+            header[8] = 8;  // Бит на канал
+            header[9] = 2;  // RGB
+            header[10] = header[11] = header[12] = 0;
+            PutChunk(out, "IHDR", header, sizeof(header));
+
+            // Строки с байтом фильтра 0 перед каждой
+            size_t rowBytes = (size_t)w * 3;
+            raw.clear();
+            for (uint32_t y = 0; y < h; y++)
+            {
+                raw.push_back(0);
+                raw.insert(raw.end(), frame.Data() + y * rowBytes, frame.Data() + (y + 1) * rowBytes);
+            }
+
+            scratch.clear();
+            scratch.push_back(0x78); scratch.push_back(0x01); // Заголовок zlib
+            uint32_t a = 1, b = 0;                            // Adler-32
+            for (size_t pos = 0; pos < raw.size() || pos == 0;)
+            {
+                size_t size = std::min<size_t>(65535, raw.size() - pos);
+                bool last = pos + size >= raw.size();
+                scratch.push_back(last ? 1 : 0);
+                scratch.push_back((uint8_t)size); scratch.push_back((uint8_t)(size >> 8));
+                scratch.push_back((uint8_t)~size); scratch.push_back((uint8_t)(~size >> 8));
+                scratch.insert(scratch.end(), raw.begin() + pos, raw.begin() + pos + size);
+                // Остаток берется раз в 5552 байта: столько можно сложить без переполнения 32 бит
+                for (size_t i = pos; i < pos + size;)
+                {
+                    size_t end = std::min(pos + size, i + 5552);
+                    for (; i < end; i++)
+                    {
+                        a += raw[i];
+                        b += a;
+                    }
+                    a %= 65521;
+                    b %= 65521;
+                }
+                pos += size;
+                if (last) break;
+            }
+            PutU32(scratch, (b << 16) | a);
+            PutChunk(out, "IDAT", scratch.data(), scratch.size());
+            PutChunk(out, "IEND", nullptr, 0);
+        }
+    }
+
+    FrameFormat FrameExportOptions::FormatForPath(const std::string& path)
+    {
+        size_t dot = path.rfind('.');
+        std::string extension = dot == std::string::npos ? "" : path.substr(dot + 1);
+        for (char& c : extension) c = (char)std::tolower((unsigned char)c);
+        return extension == "png" ? FrameFormat::Png : FrameFormat::Ppm;
+    }
+
+    bool FrameExportOptions::CheckPathPattern(const std::string& pattern, std::string* error)
+    {
+        int conversions = 0;
+        for (size_t i = 0; i < pattern.size(); i++)
+        {
+            if (pattern[i] != '%') continue;
+            i++;
+            if (i < pattern.size() && pattern[i] == '%') continue;
+            // Допускается только ширина с ведущими нулями: %d, %5d, %05d
+            while (i < pattern.size() && std::isdigit((unsigned char)pattern[i])) i++;
+            if (i >= pattern.size() || pattern[i] != 'd')
+            {
+                if (error) *error = "шаблон кадров " + pattern + ": допустима только подстановка %d или %0Nd";
+                return false;
+            }
+            conversions++;
+        }
+        if (conversions != 1)
+        {
+            if (error) *error = "шаблон кадров " + pattern + ": нужна ровно одна подстановка номера кадра (%d или %0Nd)";
+            return false;
+        }
+        return true;
+    }
+
+    struct FrameExporter::Impl
+    {
+        FrameExportOptions Options;
+        std::vector<SimSnapshot> Slots;
+        std::vector<size_t> FreeSlots;
+        std::deque<size_t> ReadySlots;
+        std::mutex Mutex;
+        std::condition_variable Changed;
+        bool Closing;
+        bool Failed;
+        std::string Error;
+        uint64_t Written;
+        uint64_t Dropped;
+        FILE* Pipe;
+        std::thread Worker;
+
+        // Только фоновый поток
+        FrameRenderer Renderer;
+        SoftwareRaster Frame;
+        std::vector<uint8_t> Encoded;
+        std::vector<uint8_t> Rows;
+        std::vector<uint8_t> Scratch;
+
+        Impl() : Closing(false), Failed(false), Written(0), Dropped(0), Pipe(nullptr) {}
+
+        void Run()
+        {
+            for (;;)
+            {
+                size_t slot;
+                bool failed;
+                {
+                    std::unique_lock<std::mutex> lock(Mutex);
+                    Changed.wait(lock, [this]() { return Closing || !ReadySlots.empty(); });
+                    if (ReadySlots.empty()) return;
+                    slot = ReadySlots.front();
+                    ReadySlots.pop_front();
+                    failed = Failed;
+                }
+
+                // После первой ошибки кадры больше не пишутся, но буферы возвращаются в очередь
+                std::string error;
+                bool ok = failed || Write(Slots[slot], error);
+
+                std::lock_guard<std::mutex> lock(Mutex);
+                if (!ok && !Failed)
+                {
+                    Failed = true;
+                    Error = error;
+                }
+                if (ok && !Failed) Written++;
+                FreeSlots.push_back(slot);
+                Changed.notify_all();
+            }
+        }
+
+        bool Write(const SimSnapshot& snapshot, std::string& error)
+        {
+            Renderer.Render(snapshot, 1.0f, Options.Width, Options.Height, Frame);
+
+            if (Options.Format == FrameFormat::Raw)
+            {
+                if (std::fwrite(Frame.Data(), 1, Frame.ByteSize(), Pipe) != Frame.ByteSize())
+                {
+                    error = "внешняя программа перестала принимать кадры";
+                    return false;
+                }
+                return true;
+            }
+
+            const uint8_t* data = Frame.Data();
+            size_t size = Frame.ByteSize();
+            char header[64];
+            size_t headerSize = 0;
+            if (Options.Format == FrameFormat::Png)
+            {
+                EncodePng(Frame, Encoded, Rows, Scratch);
+                data = Encoded.data();
+                size = Encoded.size();
+            }
+            else
+            {
+                headerSize = (size_t)std::snprintf(header, sizeof(header), "P6\n%d %d\n255\n", Frame.Width(), Frame.Height());
+            }
+
+            char path[1024];
+            std::snprintf(path, sizeof(path), Options.PathPattern.c_str(), (int)Written);
+            FILE* file = std::fopen(path, "wb");
+            if (file == nullptr)
+            {
+                error = std::string("не удалось создать файл кадра ") + path;
+                return false;
+            }
+            bool ok = std::fwrite(header, 1, headerSize, file) == headerSize && std::fwrite(data, 1, size, file) == size;
+            ok = std::fclose(file) == 0 && ok;
+            if (!ok) error = std::string("ошибка записи ") + path;
+            return ok;
+        }
+    };
+
+    FrameExporter::FrameExporter() : impl(new Impl()) {}
+
+    FrameExporter::~FrameExporter()
+    {
+        Close();
+        delete impl;
+    }
+
+    bool FrameExporter::Open(const FrameExportOptions& options, std::string* error)
+    {
+        Close();
+        if (options.Format != FrameFormat::Raw && !FrameExportOptions::CheckPathPattern(options.PathPattern, error)) return false;
+        impl->Options = options;
+        impl->Options.QueueDepth = std::max(1, options.QueueDepth);
+        impl->Slots.assign((size_t)impl->Options.QueueDepth, SimSnapshot());
+        impl->FreeSlots.clear();
+        for (size_t i = 0; i < impl->Slots.size(); i++) impl->FreeSlots.push_back(i);
+        impl->ReadySlots.clear();
+        impl->Closing = false;
+        impl->Failed = false;
+        impl->Error.clear();
+        impl->Written = 0;
+        impl->Dropped = 0;
+
+        if (options.Format == FrameFormat::Raw)
+        {
+            impl->Pipe = popen(options.PipeCommand.c_str(), "w");
+            if (impl->Pipe == nullptr)
+            {
+                if (error) *error = "не удалось запустить " + options.PipeCommand;
+                return false;
+            }
+        }
+        impl->Worker = std::thread([this]() { impl->Run(); });
+        return true;
+    }
+
+    template <typename Fill>
+    bool FrameExporter::SubmitWith(Fill fill)
+    {
+        size_t slot;
+        {
+            std::unique_lock<std::mutex> lock(impl->Mutex);
+            if (!impl->Worker.joinable() || impl->Failed) return false;
+            if (impl->FreeSlots.empty())
+            {
+                if (impl->Options.DropWhenBusy)
+                {
+                    impl->Dropped++;
+                    return false;
+                }
+                impl->Changed.wait(lock, [this]() { return !impl->FreeSlots.empty(); });
+            }
+            slot = impl->FreeSlots.back();
+            impl->FreeSlots.pop_back();
+        }
+
+        // Снимок заполняется без блокировки: буфер сейчас не принадлежит фоновому потоку
+        fill(impl->Slots[slot]);
+
+        std::lock_guard<std::mutex> lock(impl->Mutex);
+        impl->ReadySlots.push_back(slot);
+        impl->Changed.notify_all();
+        return true;
+    }
+
+    bool FrameExporter::Submit(const Simulation& simulation)
+    {
+        return SubmitWith([&](SimSnapshot& slot) { slot.CaptureFrom(simulation); });
+    }
+
+    bool FrameExporter::Submit(const SimSnapshot& snapshot)
+    {
+        return SubmitWith([&](SimSnapshot& slot) { slot = snapshot; });
+    }
+
+    bool FrameExporter::Close(std::string* error)
+    {
+        if (impl->Worker.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(impl->Mutex);
+                impl->Closing = true;
+                impl->Changed.notify_all();
+            }
+            impl->Worker.join();
+        }
+        if (impl->Pipe != nullptr)
+        {
+            if (pclose(impl->Pipe) != 0 && !impl->Failed)
+            {
+                impl->Failed = true;
+                impl->Error = "внешняя программа завершилась с ошибкой";
+            }
+            impl->Pipe = nullptr;
+        }
+        if (impl->Failed && error) *error = impl->Error;
+        return !impl->Failed;
+    }
+
+    uint64_t FrameExporter::FramesWritten() const
+    {
+        std::lock_guard<std::mutex> lock(impl->Mutex);
+        return impl->Written;
+    }
+
+    uint64_t FrameExporter::FramesDropped() const
+    {
+        std::lock_guard<std::mutex> lock(impl->Mutex);
+        return impl->Dropped;
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "SimSnapshot.h"
+#include <cstdint>
+#include <string>
+
+namespace sim
+{
+    // Формат записи кадров
+    enum class FrameFormat
+    {
+        Ppm,    // Последовательность файлов PPM (P6)
+        Png,    // Последовательность файлов PNG (без сжатия, без внешних библиотек)
+        Raw     // Сырые кадры rgb24 подряд в стандартный ввод внешней программы (например, ffmpeg)
+    };
+
+    // Параметры записи кадров
+    struct FrameExportOptions
+    {
+        FrameFormat Format;
+        std::string PathPattern;    // Шаблон имени файла с номером кадра в стиле printf, например frames/f_%05d.png
+        std::string PipeCommand;    // Команда, которой передаются сырые кадры (для FrameFormat::Raw)
+        int Width;                  // Размер кадра в пикселях; центр мира - в центре кадра
+        int Height;
+        int QueueDepth;             // Сколько снимков может ждать отрисовки
+        bool DropWhenBusy;          // true - при полной очереди кадр пропускается; false - симуляция ждет
+
+        FrameExportOptions() : Format(FrameFormat::Ppm), Width(800), Height(600), QueueDepth(4), DropWhenBusy(true) {}
+
+        // Формат по расширению шаблона: .png - PNG, иначе PPM
+        static FrameFormat FormatForPath(const std::string& path);
+
+        // Шаблон передается в snprintf, поэтому в нем должна быть ровно одна подстановка номера кадра:
+        // %d или %0Nd (и сколько угодно %%). Иначе false и причина в error
+        static bool CheckPathPattern(const std::string& pattern, std::string* error = nullptr);
+    };
+
+    // Запись кадров партии для просмотра без окна.
+    // Submit только снимает состояние симуляции в свободный буфер очереди; отрисовка (FrameRenderer),
+    // кодирование и запись идут в фоновом потоке, поэтому симуляция не ждет диска и кодировщика.
+    // Буферы очереди переиспользуются, после разгона запись не выделяет память в потоке симуляции
+    class FrameExporter
+    {
+    public:
+        FrameExporter();
+        ~FrameExporter();
+
+        FrameExporter(const FrameExporter&) = delete;
+        FrameExporter& operator=(const FrameExporter&) = delete;
+
+        // Запуск фонового потока. При ошибке (не запустилась внешняя программа) возвращает false и текст в error
+        bool Open(const FrameExportOptions& options, std::string* error = nullptr);
+
+        // Снимок текущего состояния в очередь. false - кадр пропущен (очередь полна при DropWhenBusy или запись сломалась)
+        bool Submit(const Simulation& simulation);
+
+        // То же для готового снимка (например, восстановленного из записи партии)
+        bool Submit(const SimSnapshot& snapshot);
+
+        // Дождаться записи всех кадров из очереди и остановить поток. false - была ошибка записи (текст в error)
+        bool Close(std::string* error = nullptr);
+
+        uint64_t FramesWritten() const;
+        uint64_t FramesDropped() const;
+
+    private:
+        struct Impl;
+        Impl* impl;
+
+        template <typename Fill>
+        bool SubmitWith(Fill fill);
+    };
+}
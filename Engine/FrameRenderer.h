@@ -0,0 +1,124 @@
+#pragma once
+
+#include "SimSnapshot.h"
+#include "SoftwareRaster.h"
+#include <vector>
+
+namespace sim
+{
+    // Отрисовка снимка партии в программный кадр - те же цвета и фигуры, что в окне
+    // (Radar.h, Launcher.h, Rocket.h), но без GDI+. Как и окно, держит готовый фоновый слой
+    // (фон, зоны радаров, установки) и перестраивает его только при смене размера кадра
+    // или числа уничтоженных радаров, а также после применения новой конфигурации. Номера установок и строка состояния не рисуются: шрифтов здесь нет
+    class FrameRenderer
+    {
+    public:
+        FrameRenderer() : staticDestroyedRadars(-1), staticConfigVersion(0) {}
+
+        // Кадр размером width x height, центр мира - в центре кадра (как в окне).
+        // alpha - доля шага для интерполяции (1 - состояние на конец последнего шага)
+        void Render(const SimSnapshot& snapshot, float alpha, int width, int height, SoftwareRaster& frame)
+        {
+            float originX = width / 2.0f, originY = height / 2.0f;
+            EnsureStaticLayer(snapshot, width, height, originX, originY);
+            frame.CopyFrom(staticLayer);
+
+            // Лучи радаров
+            DrawBeam(frame, snapshot.MainRadar, snapshot.BeamAngleAt(snapshot.MainRadar, alpha), originX, originY);
+            for (const Radar& radar : snapshot.SupportRadars)
+            {
+                DrawBeam(frame, radar, snapshot.BeamAngleAt(radar, alpha), originX, originY);
+            }
+
+            // Ракеты: экранные координаты считаются одним проходом по массивам,
+            // затем кружки одного цвета рисуются одним пакетом
+            const RocketStore& rockets = snapshot.Rockets;
+            float backstep = snapshot.InterpolationBackstepSec(alpha);
+            flying.Clear();
+            intercepted.Clear();
+            for (size_t i = 0; i < rockets.Size(); i++)
+            {
+                if (!rockets.IsActive(i)) continue;
+                PointList& list = rockets.IsIntercepted(i) ? intercepted : flying;
+                list.X.push_back(rockets.X[i] - rockets.VX[i] * backstep + originX);
+                list.Y.push_back(rockets.Y[i] - rockets.VY[i] * backstep + originY);
+            }
+            frame.FillDisks(flying.X.data(), flying.Y.data(), flying.X.size(), 3.0f, Red);
+            frame.FillDisks(intercepted.X.data(), intercepted.Y.data(), intercepted.X.size(), 3.0f, LightGreen);
+        }
+
+    private:
+        // Цвета GDI+ из оконной отрисовки
+        static constexpr Rgb Black{ 0, 0, 0 };
+        static constexpr Rgb CornflowerBlue{ 100, 149, 237 };
+        static constexpr Rgb Blue{ 0, 0, 255 };
+        static constexpr Rgb DarkRed{ 139, 0, 0 };
+        static constexpr Rgb OrangeRed{ 255, 69, 0 };
+        static constexpr Rgb DimGray{ 105, 105, 105 };
+        static constexpr Rgb LightSkyBlue{ 135, 206, 250 };
+        static constexpr Rgb SkyBlue{ 135, 206, 235 };
+        static constexpr Rgb DarkGray{ 169, 169, 169 };
+        static constexpr Rgb Red{ 255, 0, 0 };
+        static constexpr Rgb LightGreen{ 144, 238, 144 };
+
+        struct PointList
+        {
+            std::vector<float> X;
+            std::vector<float> Y;
+            void Clear() { X.clear(); Y.clear(); }
+        };
+
+        SoftwareRaster staticLayer;
+        int staticDestroyedRadars;
+        uint32_t staticConfigVersion;
+        PointList flying;       // Экранные координаты летящих ракет
+        PointList intercepted;  // и перехваченных
+
+        void EnsureStaticLayer(const SimSnapshot& snapshot, int width, int height, float originX, float originY)
+        {
+            int destroyed = snapshot.DestroyedRadarCount();
+            if (staticLayer.Width() == width && staticLayer.Height() == height && staticDestroyedRadars == destroyed
+                && staticConfigVersion == snapshot.ConfigVersion) return;
+
+            staticLayer.Resize(width, height);
+            staticLayer.Clear(Black);
+            DrawRadarStatic(snapshot.MainRadar, originX, originY);
+            for (const Radar& radar : snapshot.SupportRadars) DrawRadarStatic(radar, originX, originY);
+            for (const Launcher& launcher : snapshot.Launchers)
+            {
+                staticLayer.FillRect(launcher.Position.X + originX - 5.0f, launcher.Position.Y + originY - 5.0f, 10.0f, 10.0f, DarkGray);
+            }
+            staticDestroyedRadars = destroyed;
+            staticConfigVersion = snapshot.ConfigVersion;
+        }
+
+        // Зоны и база радара, как Radar::DrawStatic
+        void DrawRadarStatic(const Radar& radar, float originX, float originY)
+        {
+            static const float Dot[] = { 1.0f, 1.0f };
+            static const float Dash[] = { 3.0f, 1.0f };
+            static const float DashDot[] = { 3.0f, 1.0f, 1.0f, 1.0f };
+
+            float x = radar.Position.X + originX, y = radar.Position.Y + originY;
+            if (!radar.IsDestroyed) staticLayer.StrokeCircle(x, y, radar.MaxDetectionRangeP, 1.5f, CornflowerBlue, 60, Dot, 2);
+            staticLayer.FillDisk(x, y, 10.0f, radar.IsDestroyed ? DarkRed : Blue);
+            staticLayer.StrokeCircle(x, y, radar.CircularAttackRange, 2.0f, OrangeRed, 255, Dash, 2);
+            if (!radar.IsDestroyed) staticLayer.StrokeCircle(x, y, radar.DeadZoneRadius, 1.5f, DimGray, 100, DashDot, 4);
+        }
+
+        // Сектор луча, как Radar::DrawBeam
+        static void DrawBeam(SoftwareRaster& frame, const Radar& radar, float beamAngleDegrees, float originX, float originY)
+        {
+            if (radar.IsDestroyed) return;
+            float x = radar.Position.X + originX, y = radar.Position.Y + originY;
+            BinaryAngle from = BinaryAngleFromDegrees(beamAngleDegrees - radar.BeamWidthDegrees / 2.0f);
+            BinaryAngle to = BinaryAngleFromDegrees(beamAngleDegrees + radar.BeamWidthDegrees / 2.0f);
+            float r = radar.BeamEffectiveRadiusR;
+            float x2 = x + r * Cos(from), y2 = y + r * Sin(from);
+            float x3 = x + r * Cos(to), y3 = y + r * Sin(to);
+            frame.FillTriangle(x, y, x2, y2, x3, y3, LightSkyBlue, 100);
+            frame.DrawLine(x, y, x2, y2, SkyBlue);
+            frame.DrawLine(x, y, x3, y3, SkyBlue);
+        }
+    };
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace sim
+{
+    // Таймеры перезарядки установок без обхода на каждом шаге. Вместо того чтобы каждый шаг уменьшать
+    // таймер каждой установки, при перезарядке сразу считается номер шага, на котором таймер дойдет до нуля:
+    // tick + ceil(seconds / step) в double, в той же арифметике, что и OvershootSec. Шаг партии почти всегда
+    // постоянный; если он меняется, оставшиеся таймеры пересчитываются один раз (ChangeStep)
+    class LaunchTimers
+    {
+    public:
+        static const uint64_t Never = std::numeric_limits<uint64_t>::max();
+
+        // count установок, шаг stepSec
+        void Reset(size_t count, float stepSec)
+        {
+            this->stepSec = stepSec;
+            readyTick.assign(count, 0);
+            countdownSec.assign(count, 0.0f);
+            scheduledTick.assign(count, 0);
+        }
+
+        // Установка k перезаряжается seconds секунд начиная с шага tick (первый шаг отсчета - tick + 1)
+        void Schedule(size_t k, float seconds, uint64_t tick)
+        {
+            countdownSec[k] = seconds;
+            scheduledTick[k] = tick;
+            uint64_t ticks = TicksFor(seconds);
+            readyTick[k] = ticks == Never ? Never : tick + ticks;
+        }
+
+        // Готова ли установка k стрелять на шаге tick
+        bool Ready(size_t k, uint64_t tick) const { return readyTick[k] <= tick; }
+
+        // Шаг, с которого установка k готова (Never - шаг нулевой, таймер не убывает)
+        uint64_t ReadyTick(size_t k) const { return readyTick[k]; }
+
+        // Сколько секунд к концу шага tick установка k уже готова: насколько таймер ушел бы ниже нуля (0 - не готова)
+        float OvershootSec(size_t k, uint64_t tick) const
+        {
+            if (readyTick[k] > tick) return 0.0f;
+            return std::max(0.0f, (float)((double)(tick - scheduledTick[k]) * stepSec - countdownSec[k]));
+        }
+
+        float StepSec() const { return stepSec; }
+
+        // Смена длины шага с шага lastTick + 1: таймеры доводятся прежним шагом до lastTick
+        // и пересчитываются новым (как если бы каждый шаг вычитал свою длину)
+        void ChangeStep(float newStepSec, uint64_t lastTick)
+        {
+            for (size_t k = 0; k < readyTick.size(); k++)
+            {
+                // Готовой установке таймер уже не нужен; таймер, который не убывал, остается как был
+                if (readyTick[k] <= lastTick) countdownSec[k] = 0.0f;
+                else if (readyTick[k] != Never) countdownSec[k] = (float)(countdownSec[k] - (double)(lastTick - scheduledTick[k]) * stepSec);
+            }
+            stepSec = newStepSec;
+            for (size_t k = 0; k < readyTick.size(); k++) Schedule(k, countdownSec[k], lastTick);
+        }
+
+        // Сколько шагов отсчитывается таймер seconds: ceil(seconds / step), 0 - уже готов,
+        // Never - шаг нулевой или число шагов не помещается в счетчик
+        uint64_t TicksFor(float seconds) const
+        {
+            if (!(seconds > 0.0f)) return 0;
+            double ticks = std::ceil((double)seconds / stepSec);
+            return stepSec > 0.0f && ticks < 1e18 ? (uint64_t)ticks : Never;
+        }
+
+    private:
+        float stepSec = 0.0f;
+        std::vector<uint64_t> readyTick;    // Шаг, с которого установка готова
+        std::vector<float> countdownSec;    // Таймер на шаге scheduledTick
+        std::vector<uint64_t> scheduledTick;
+    };
+
+    // Очередь установок, которые стреляют по готовности (команда barrage сценария): двоичная куча по времени
+    // готовности. Шаг достает из нее только установки, чье время пришло, поэтому тысячи установок с долгой
+    // перезарядкой ничего не стоят между выстрелами
+    class LaunchQueue
+    {
+    public:
+        void Reset(size_t count)
+        {
+            heap.clear();
+            shotsLeft.assign(count, 0);
+            speed.assign(count, 0.0f);
+            readySec.assign(count, 0.0);
+        }
+
+        // Установке k добавляется shots выстрелов со скоростью shotSpeed; первый - не раньше nowSec
+        void Add(uint32_t k, uint32_t shots, float shotSpeed, double nowSec)
+        {
+            if (shots == 0) return;
+            speed[k] = shotSpeed;
+            if (shotsLeft[k] == 0) Push(std::max(readySec[k], nowSec), k);
+            shotsLeft[k] += shots;
+        }
+
+        // Выстрелы установок, готовых к nowSec, по времени готовности (при равном - по номеру установки).
+        // fire(номер установки, скорость) стреляет и возвращает время перезарядки
+        template <class Fire>
+        void Advance(double nowSec, Fire fire)
+        {
+            while (!heap.empty() && heap.front().ReadySec <= nowSec)
+            {
+                std::pop_heap(heap.begin(), heap.end(), Later);
+                uint32_t k = heap.back().Launcher;
+                heap.pop_back();
+
+                readySec[k] = nowSec + fire(k, speed[k]);
+                if (--shotsLeft[k] > 0) Push(readySec[k], k);
+            }
+        }
+
+        // Сколько установок ждет выстрела
+        size_t Size() const { return heap.size(); }
+        bool Empty() const { return heap.empty(); }
+
+    private:
+        struct Entry
+        {
+            double ReadySec;
+            uint32_t Launcher;
+        };
+
+        std::vector<Entry> heap;
+        std::vector<uint32_t> shotsLeft;    // Выстрелов в очереди у каждой установки
+        std::vector<float> speed;           // Скорость ее ракет
+        std::vector<double> readySec;       // Когда она перезарядится
+
+        // Порядок кучи: наверху самая ранняя готовность
+        static bool Later(const Entry& a, const Entry& b)
+        {
+            return a.ReadySec != b.ReadySec ? a.ReadySec > b.ReadySec : a.Launcher > b.Launcher;
+        }
+
+        void Push(double ready, uint32_t k)
+        {
+            heap.push_back(Entry{ ready, k });
+            std::push_heap(heap.begin(), heap.end(), Later);
+        }
+    };
+}
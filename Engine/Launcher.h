@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Rocket.h"
+#include "SimRandom.h"
+
+namespace sim
+{
+    // Нативная пусковая установка.
+    // У каждой установки свой поток случайных чисел (RandomStream), выведенный из seed симуляции,
+    // поэтому время перезарядки воспроизводимо и не зависит от других установок и симуляций
+    struct Launcher
+    {
+        Vec2 Position;              // Координаты пусковой установки в игровом мире
+        int Id;                     // Уникальный идентификатор установки для отладки и отрисовки
+        float MinLaunchIntervalSec; // Минимальное время перезарядки в секундах
+        float MaxLaunchIntervalSec; // Максимальное время перезарядки в секундах
+        float TimeToNextLaunchSec;  // Время перезарядки после последнего выстрела (отсчитывает LaunchTimers)
+        RandomStream Random;        // Собственный поток случайных чисел
+
+        Launcher(Vec2 pos, int id, float minInterval, float maxInterval, uint64_t seed)
+        {
+            Position = pos;
+            Id = id;
+            MinLaunchIntervalSec = minInterval;
+            MaxLaunchIntervalSec = maxInterval;
+            Random = RandomStream(seed, StreamLauncherBase + (uint64_t)id);
+            // Сразу же устанавливаем начальный таймер перезарядки
+            ResetLaunchTimer();
+        }
+
+        // Случайное время перезарядки в интервале [Min, Max]
+        void ResetLaunchTimer()
+        {
+            TimeToNextLaunchSec = Random.NextRange(MinLaunchIntervalSec, MaxLaunchIntervalSec);
+        }
+
+        // Выстрел: сбрасывает таймер перезарядки и возвращает новую ракету
+        Rocket Fire(Vec2 targetPos, float rocketSpeed)
+        {
+            ResetLaunchTimer();
+            return Rocket(Position, targetPos, rocketSpeed);
+        }
+    };
+}
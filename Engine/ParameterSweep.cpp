@@ -0,0 +1,335 @@
+// Перебор параметров конфигурации с досрочным отсечением проигрывающих точек
+#include "ParameterSweep.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <thread>
+
+namespace sim
+{
+    namespace
+    {
+        bool ParseNumber(const std::string& text, double& value)
+        {
+            if (text.empty()) return false;
+            char* end = nullptr;
+            value = std::strtod(text.c_str(), &end);
+            return end == text.c_str() + text.size();
+        }
+
+        // Точка в процессе счета
+        struct PointState
+        {
+            SweepPointResult Result;
+            ConfigData Config;
+            std::vector<EngagementResult> Runs;
+        };
+
+        void Score(PointState& point, SweepObjective objective)
+        {
+            point.Result.RunsDone = (int)point.Runs.size();
+            point.Result.Stats = Summarize(point.Runs);
+            if (objective == SweepObjective::WinRate)
+            {
+                point.Result.Score = point.Result.Stats.WinRate;
+                point.Result.ScoreCi = point.Result.Stats.WinRateCi;
+            }
+            else
+            {
+                point.Result.Score = point.Result.Stats.InterceptMean;
+                point.Result.ScoreCi = point.Result.Stats.InterceptMeanCi;
+            }
+        }
+
+        // Досчитывает набор точек раундами, отсекая заведомо худшие.
+        // finished - уже досчитанные точки прошлых уточнений: они тоже задают планку для отсечения
+        uint64_t RacePoints(std::vector<PointState*>& alive, const std::vector<PointState*>& finished, const SweepOptions& options)
+        {
+            int threads = options.Threads > 0 ? options.Threads : (int)std::thread::hardware_concurrency();
+            if (threads < 1) threads = 1;
+            int roundRuns = options.RoundRuns > 0 ? options.RoundRuns : options.RunsPerPoint;
+
+            uint64_t engagements = 0;
+            int runsDone = 0;
+            while (runsDone < options.RunsPerPoint && !alive.empty())
+            {
+                int chunk = std::min(roundRuns, options.RunsPerPoint - runsDone);
+                for (PointState* point : alive) point->Runs.resize(runsDone + chunk);
+
+                // Задача t - партия runsDone + t % chunk в точке t / chunk; раздача через общий счетчик, как в RunBatch
+                int tasks = (int)alive.size() * chunk;
+                std::atomic<int> nextTask(0);
+                auto worker = [&]()
+                {
+                    for (;;)
+                    {
+                        int task = nextTask.fetch_add(1, std::memory_order_relaxed);
+                        if (task >= tasks) break;
+                        PointState* point = alive[task / chunk];
+                        int run = runsDone + task % chunk;
+                        point->Runs[run] = RunEngagement(point->Config, EngagementSeed(options.BaseSeed, (uint64_t)run),
+                            options.DeltaTime, options.MaxTicks, options.EventDriven);
+                    }
+                };
+
+                int poolSize = std::min(threads, tasks);
+                std::vector<std::thread> pool;
+                for (int t = 1; t < poolSize; t++) pool.emplace_back(worker);
+                worker();
+                for (std::thread& thread : pool) thread.join();
+
+                runsDone += chunk;
+                engagements += (uint64_t)tasks;
+                for (PointState* point : alive) Score(*point, options.Objective);
+
+                if (!options.EarlyCutoff || runsDone >= options.RunsPerPoint) continue;
+
+                // Планка - лучшая нижняя граница среди живых и уже досчитанных точек
+                double bar = -1e300;
+                for (PointState* point : alive) bar = std::max(bar, point->Result.ScoreCi.Low);
+                for (PointState* point : finished) bar = std::max(bar, point->Result.ScoreCi.Low);
+
+                std::vector<PointState*> survivors;
+                for (PointState* point : alive)
+                {
+                    if (point->Result.ScoreCi.High < bar)
+                    {
+                        point->Result.Pruned = true;
+                        std::vector<EngagementResult>().swap(point->Runs);
+                    }
+                    else
+                    {
+                        survivors.push_back(point);
+                    }
+                }
+                alive.swap(survivors);
+            }
+
+            // Итоги партий больше не нужны: статистика точки уже посчитана
+            for (PointState* point : alive) std::vector<EngagementResult>().swap(point->Runs);
+            return engagements;
+        }
+
+        // Все сочетания значений осей (декартово произведение)
+        std::vector<std::vector<double>> GridPoints(const std::vector<SweepAxis>& axes)
+        {
+            std::vector<std::vector<double>> points(1);
+            for (const SweepAxis& axis : axes)
+            {
+                std::vector<std::vector<double>> next;
+                next.reserve(points.size() * axis.Values.size());
+                for (const std::vector<double>& prefix : points)
+                {
+                    for (double value : axis.Values)
+                    {
+                        next.push_back(prefix);
+                        next.back().push_back(value);
+                    }
+                }
+                points.swap(next);
+            }
+            return points;
+        }
+
+        // Шаг оси - наименьшее расстояние между соседними значениями
+        double AxisStep(const SweepAxis& axis)
+        {
+            double step = 0.0;
+            for (size_t i = 1; i < axis.Values.size(); i++)
+            {
+                double d = std::fabs(axis.Values[i] - axis.Values[i - 1]);
+                if (d > 0.0 && (step == 0.0 || d < step)) step = d;
+            }
+            return step;
+        }
+
+        // Сетка вдвое мельче вокруг лучшей точки
+        std::vector<SweepAxis> RefineAxes(const std::vector<SweepAxis>& axes, const std::vector<double>& center)
+        {
+            std::vector<SweepAxis> refined = axes;
+            for (size_t a = 0; a < refined.size(); a++)
+            {
+                SweepAxis& axis = refined[a];
+                double step = AxisStep(axes[a]) * 0.5;
+                if (axis.Integer) step = std::floor(step);
+
+                std::vector<double> values;
+                for (int k = -1; k <= 1; k++)
+                {
+                    double v = std::min(axis.Max, std::max(axis.Min, center[a] + k * step));
+                    if (axis.Integer) v = std::round(v);
+                    if (std::find(values.begin(), values.end(), v) == values.end()) values.push_back(v);
+                }
+                axis.Values = values;
+            }
+            return refined;
+        }
+
+        std::string PointKey(const std::vector<SweepAxis>& axes, const std::vector<double>& values)
+        {
+            std::string key;
+            for (size_t a = 0; a < axes.size(); a++) key += FormatSweepValue(axes[a], values[a]) + ";";
+            return key;
+        }
+
+        // Лучшая из досчитанных точек (при равенстве - с большей нижней границей)
+        int BestPoint(const std::vector<PointState*>& points)
+        {
+            int best = -1;
+            for (size_t i = 0; i < points.size(); i++)
+            {
+                const SweepPointResult& r = points[i]->Result;
+                if (r.Pruned) continue;
+                if (best < 0) { best = (int)i; continue; }
+                const SweepPointResult& b = points[best]->Result;
+                if (r.Score > b.Score || (r.Score == b.Score && r.ScoreCi.Low > b.ScoreCi.Low)) best = (int)i;
+            }
+            return best;
+        }
+    }
+
+    bool SweepAxis::Parse(const std::string& spec, SweepAxis& axis, std::string* error)
+    {
+        axis = SweepAxis();
+        size_t eq = spec.find('=');
+        if (eq == std::string::npos || eq == 0)
+        {
+            if (error) *error = "ожидается ключ=min:max:count или ключ=v1,v2,...: " + spec;
+            return false;
+        }
+        axis.Key = spec.substr(0, eq);
+        std::string body = spec.substr(eq + 1);
+
+        std::vector<std::string> parts;
+        char separator = body.find(':') != std::string::npos ? ':' : ',';
+        size_t begin = 0;
+        for (;;)
+        {
+            size_t end = body.find(separator, begin);
+            parts.push_back(body.substr(begin, end == std::string::npos ? std::string::npos : end - begin));
+            if (end == std::string::npos) break;
+            begin = end + 1;
+        }
+
+        if (separator == ':')
+        {
+            double lo = 0.0, hi = 0.0, count = 0.0;
+            if (parts.size() != 3 || !ParseNumber(parts[0], lo) || !ParseNumber(parts[1], hi) || !ParseNumber(parts[2], count)
+                || count < 1 || count != std::floor(count))
+            {
+                if (error) *error = "ожидается ключ=min:max:count: " + spec;
+                return false;
+            }
+            int n = (int)count;
+            for (int i = 0; i < n; i++)
+            {
+                axis.Values.push_back(n == 1 ? lo : lo + (hi - lo) * i / (n - 1));
+            }
+        }
+        else
+        {
+            for (const std::string& part : parts)
+            {
+                double value = 0.0;
+                if (!ParseNumber(part, value))
+                {
+                    if (error) *error = "некорректное значение '" + part + "' в " + spec;
+                    return false;
+                }
+                axis.Values.push_back(value);
+            }
+        }
+
+        axis.Integer = true;
+        for (double v : axis.Values)
+        {
+            if (v != std::floor(v)) axis.Integer = false;
+        }
+        axis.Min = *std::min_element(axis.Values.begin(), axis.Values.end());
+        axis.Max = *std::max_element(axis.Values.begin(), axis.Values.end());
+        return true;
+    }
+
+    std::string FormatSweepValue(const SweepAxis& axis, double value)
+    {
+        char buffer[64];
+        if (axis.Integer) std::snprintf(buffer, sizeof(buffer), "%lld", (long long)value);
+        else std::snprintf(buffer, sizeof(buffer), "%.6g", value);
+        return buffer;
+    }
+
+    bool RunSweep(const ConfigData& sweepBase, const SweepOptions& options, SweepResult& result, std::string* error)
+    {
+        result = SweepResult();
+        result.BestIndex = -1;
+        if (options.Axes.empty())
+        {
+            if (error) *error = "не задано ни одной оси перебора";
+            return false;
+        }
+        if (options.RunsPerPoint < 1)
+        {
+            if (error) *error = "число партий в точке должно быть положительным";
+            return false;
+        }
+        ConfigData base = sweepBase;
+        if (!CheckScenario(base, error)) return false;
+
+        // Точки хранятся по ключу из значений: при уточнении уже посчитанные точки не пересчитываются
+        std::vector<std::unique_ptr<PointState>> storage;
+        std::map<std::string, PointState*> byKey;
+        std::vector<PointState*> finished;
+
+        std::vector<SweepAxis> axes = options.Axes;
+        for (int round = 0; round <= options.AdaptiveRounds; round++)
+        {
+            std::vector<PointState*> alive;
+            for (const std::vector<double>& values : GridPoints(axes))
+            {
+                std::string key = PointKey(options.Axes, values);
+                if (byKey.count(key)) continue;
+
+                std::unique_ptr<PointState> point(new PointState());
+                point->Config = base;
+                for (size_t a = 0; a < axes.size(); a++)
+                {
+                    if (!point->Config.SetValue(axes[a].Key, FormatSweepValue(axes[a], values[a]), error)) return false;
+                }
+                point->Result.Values = values;
+                point->Result.RunsDone = 0;
+                point->Result.Pruned = false;
+                point->Result.Round = round;
+                point->Result.Score = 0.0;
+                point->Result.ScoreCi = Interval{ 0.0, 0.0 };
+
+                byKey[key] = point.get();
+                alive.push_back(point.get());
+                storage.push_back(std::move(point));
+            }
+
+            result.Engagements += RacePoints(alive, finished, options);
+            for (PointState* point : alive) finished.push_back(point);
+
+            if (round == options.AdaptiveRounds) break;
+            std::vector<PointState*> all;
+            for (const std::unique_ptr<PointState>& point : storage) all.push_back(point.get());
+            int best = BestPoint(all);
+            if (best < 0) break;
+            axes = RefineAxes(axes, all[best]->Result.Values);
+        }
+
+        std::vector<PointState*> all;
+        for (const std::unique_ptr<PointState>& point : storage)
+        {
+            all.push_back(point.get());
+            result.Points.push_back(point->Result);
+        }
+        result.BestIndex = BestPoint(all);
+        return true;
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "BatchRunner.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace sim
+{
+    // Одна ось перебора: ключ из settings.txt и список его значений
+    struct SweepAxis
+    {
+        std::string Key;            // Ключ, как в settings.txt (например, radar_rotation_speed_dps)
+        std::vector<double> Values; // Значения на сетке
+        bool Integer;               // Все значения целые (для целых и логических ключей)
+        double Min;                 // Границы оси: уточнение в адаптивном режиме за них не выходит
+        double Max;
+
+        SweepAxis() : Integer(false), Min(0.0), Max(0.0) {}
+
+        // Разбор описания "ключ=min:max:count" (равномерная сетка из count точек)
+        // или "ключ=v1,v2,..." (явный список). При ошибке возвращает false и текст в error
+        static bool Parse(const std::string& spec, SweepAxis& axis, std::string* error = nullptr);
+    };
+
+    // По какой метрике сравниваются точки
+    enum class SweepObjective
+    {
+        WinRate,        // Доля побед
+        InterceptMean   // Среднее число перехватов
+    };
+
+    // Параметры перебора
+    struct SweepOptions
+    {
+        std::vector<SweepAxis> Axes;
+        int RunsPerPoint;       // Сколько партий играется в точке, если ее не отсекли раньше
+        int RoundRuns;          // Партии идут раундами по RoundRuns в каждой живой точке; после раунда - отсечение
+        bool EarlyCutoff;       // Отсекать точки, которые уже заведомо хуже лучшей
+        int AdaptiveRounds;     // 0 - только сетка; иначе столько раз сетка сужается вокруг лучшей точки
+        SweepObjective Objective;
+        int Threads;            // 0 - по числу ядер
+        uint64_t BaseSeed;      // Партия i в любой точке играется с seed EngagementSeed(BaseSeed, i)
+        float DeltaTime;        // 0 - фиксированный шаг из конфигурации
+        uint64_t MaxTicks;      // 0 - без ограничения
+        bool EventDriven;       // Играть событийным движком EventSimulation
+
+        SweepOptions()
+            : RunsPerPoint(200), RoundRuns(25), EarlyCutoff(true), AdaptiveRounds(0),
+              Objective(SweepObjective::WinRate), Threads(0), BaseSeed(1), DeltaTime(0.0f), MaxTicks(0), EventDriven(false) {}
+    };
+
+    // Итог одной точки пространства параметров
+    struct SweepPointResult
+    {
+        std::vector<double> Values; // Значения по осям, в порядке SweepOptions::Axes
+        BatchStats Stats;           // Статистика по сыгранным партиям
+        int RunsDone;               // Сколько партий сыграно (меньше RunsPerPoint, если точку отсекли)
+        bool Pruned;                // Точка отсечена досрочно
+        int Round;                  // Номер уточнения, на котором точка появилась (0 - исходная сетка)
+        double Score;               // Значение целевой метрики
+        Interval ScoreCi;           // 95% интервал целевой метрики
+    };
+
+    // Итог перебора
+    struct SweepResult
+    {
+        std::vector<SweepPointResult> Points; // В порядке появления
+        int BestIndex;                        // Лучшая точка среди досчитанных до конца (-1, если таких нет)
+        uint64_t Engagements;                 // Сколько партий сыграно всего
+    };
+
+    // Текстовое представление значения оси в формате settings.txt
+    std::string FormatSweepValue(const SweepAxis& axis, double value);
+
+    // Перебор параметров на всех ядрах.
+    // Все точки играют одни и те же seed (общие случайные числа), поэтому разница между точками
+    // определяется параметрами, а не удачей. После каждого раунда точки, у которых верхняя граница
+    // интервала метрики ниже нижней границы лучшей точки, отсекаются и больше не считаются.
+    // При ошибке в описании осей или если сценарий не открывается (CheckScenario) возвращает false и текст в error
+    bool RunSweep(const ConfigData& base, const SweepOptions& options, SweepResult& result, std::string* error = nullptr);
+}
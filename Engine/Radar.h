@@ -0,0 +1,136 @@
+#pragma once // Предотвращает повторное включение этого файла
+
+#include "Rocket.h"
+#include "BeamKernel.h"
+#include "SweptBeam.h"
+#include "BinaryAngle.h"
+#include <cmath>
+#include <cstdlib>
+
+// Определяем константу M_PI, если она еще не определена
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace sim
+{
+    // Нативное состояние и логика радара: вращение луча и перехват ракет
+    struct Radar
+    {
+        Vec2 Position;                  // Координаты центра радара в мировом пространстве
+        BinaryAngle Angle;              // Текущий угол поворота луча радара (двоичные единицы, оборот - 2^32)
+        float RotationSpeedDps;         // Скорость вращения радара в градусах в секунду
+        float BeamWidthDegrees;         // Ширина основного луча радара в градусах
+        float MaxDetectionRangeP;       // Максимальная дальность пассивного обнаружения
+        float BeamEffectiveRadiusR;     // Эффективная дальность активного луча перехвата
+        float CircularAttackRange;      // Радиус круговой зоны атаки
+        float CoreVulnerabilityRadius;  // Радиус уязвимого ядра радара
+        float DeadZoneRadius;           // Радиус "мертвой зоны" вокруг радара, где цели не обнаруживаются
+        bool IsDestroyed;               // Флаг, указывающий, уничтожен ли радар
+
+        Radar(Vec2 pos, float rotSpeed, float beamWidth, float p_range, float r_beam_eff_radius,
+            float circularAttackRng, float coreVulnerabilityR, float deadZoneRad)
+        {
+            Position = pos;
+            RotationSpeedDps = rotSpeed;
+            BeamWidthDegrees = beamWidth;
+            MaxDetectionRangeP = p_range;
+            BeamEffectiveRadiusR = r_beam_eff_radius;
+            CircularAttackRange = circularAttackRng;
+            CoreVulnerabilityRadius = coreVulnerabilityR;
+            DeadZoneRadius = deadZoneRad;
+            Angle = 0;
+            IsDestroyed = false;
+        }
+
+        // Угол луча в градусах [0, 360)
+        float AngleDegrees() const { return BinaryAngleToDegrees(Angle); }
+        void SetAngleDegrees(float degrees) { Angle = BinaryAngleFromDegrees(degrees); }
+
+        // Поворот луча за прошедшее время. Поворот за шаг округляется до двоичной единицы (8e-8 градуса)
+        // один раз, дальше углы складываются точно и оборачиваются через 0 переполнением
+        void Update(float deltaTime)
+        {
+            if (IsDestroyed) return;
+            Angle += BinaryAngleFromDegrees((double)RotationSpeedDps * deltaTime);
+        }
+
+        // Приведение угла к диапазону [0, 360)
+        static float NormalizeAngle(float angle)
+        {
+            return BinaryAngleToDegrees(BinaryAngleFromDegrees(angle));
+        }
+
+        // Кратчайшая разница между двумя углами в диапазоне [-180, 180)
+        static float AngleDifference(float angle1, float angle2)
+        {
+            return BinaryAngleDeltaDegrees(BinaryAngleFromDegrees(angle1), BinaryAngleFromDegrees(angle2));
+        }
+
+        // Находится ли точка внутри луча перехвата: вне мертвой зоны,
+        // в пределах дальности луча и внутри его углового сектора
+        bool IsInBeam(Vec2 point) const
+        {
+            float distToRocket = Distance(point, Position);
+
+            // 1. Точка в мертвой зоне, перехват невозможен
+            if (distToRocket <= DeadZoneRadius) return false;
+
+            // 2. Точка дальше эффективной дальности луча
+            if (distToRocket > BeamEffectiveRadiusR) return false;
+
+            // 3. Точка внутри углового сектора луча
+            BinaryAngle angleToRocket = BinaryAngleFromRadians(std::atan2(point.Y - Position.Y, point.X - Position.X));
+            int64_t angleDiff = BinaryAngleDelta(angleToRocket, Angle);
+            return std::llabs(angleDiff) <= std::llround(BeamWidthDegrees / 2.0 * BinaryAnglePerDegree);
+        }
+
+        // Текущий сектор луча для пакетной проверки DetectBatch.
+        // Синус и косинус берутся из таблицы один раз на шаг, а не для каждой ракеты
+        BeamSector GetBeamSector() const
+        {
+            float halfWidthDeg = BeamWidthDegrees / 2.0f;
+
+            BeamSector beam;
+            beam.CenterX = Position.X;
+            beam.CenterY = Position.Y;
+            beam.DirX = Cos(Angle);
+            beam.DirY = Sin(Angle);
+            // Луч шире 360 градусов покрывает всю окружность
+            beam.CosHalfWidth = halfWidthDeg >= 180.0f ? -1.0f : Cos(BinaryAngleFromDegrees(halfWidthDeg));
+            beam.CosHalfWidthSq = beam.CosHalfWidth * beam.CosHalfWidth;
+            beam.DeadZoneRadiusSq = DeadZoneRadius * DeadZoneRadius;
+            beam.RangeSq = BeamEffectiveRadiusR * BeamEffectiveRadiusR;
+            return beam;
+        }
+
+        // Луч, прошедший за последний шаг длительностью deltaTime (вызывать после Update).
+        // Используется непрерывной проверкой SweptBeamHit
+        SweptBeam GetSweptBeam(float deltaTime) const
+        {
+            SweptBeam beam;
+            beam.Center = Position;
+            beam.SweepDegrees = RotationSpeedDps * deltaTime;
+            beam.StartAngleDegrees = AngleDegrees() - beam.SweepDegrees;
+            beam.HalfWidthDegrees = BeamWidthDegrees / 2.0f;
+            beam.DeadZoneRadius = DeadZoneRadius;
+            beam.RangeR = BeamEffectiveRadiusR;
+            return beam;
+        }
+
+        // Обнаружение и перехват ракеты.
+        // Возвращает true, если ракета была перехвачена, иначе false
+        bool DetectAndIntercept(Rocket& rocket) const
+        {
+            if (IsDestroyed || !rocket.IsActive) return false;
+
+            if (IsInBeam(rocket.Position))
+            {
+                rocket.IsIntercepted = true;
+                rocket.IsActive = false;
+                return true;
+            }
+            return false;
+        }
+    };
+}
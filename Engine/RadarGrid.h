@@ -0,0 +1,126 @@
+#pragma once
+
+#include "Vec2.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace sim
+{
+    // Равномерная сетка над сетью радаров: по координатам ракеты за O(1) дает список радаров,
+    // которые могут до нее дотянуться. Размер ячейки - наибольшая дальность обнаружения MaxDetectionRangeP,
+    // каждый радар записан во все ячейки, которые пересекает его круг обнаружения.
+    // Ракета проверяется только по радарам своей ячейки, поэтому работа растет с реальным перекрытием зон,
+    // а не с произведением числа радаров на число ракет. Сетка строится один раз при создании сети
+    class RadarGrid
+    {
+    public:
+        // Радары ячейки: номера от Begin до End
+        struct Span
+        {
+            const uint32_t* Begin;
+            const uint32_t* End;
+        };
+
+        RadarGrid() : originX(0.0f), originY(0.0f), invCellSize(1.0f), columns(0), rows(0) {}
+
+        // positions[k] и reach[k] - центр и дальность радара k
+        void Build(const std::vector<Vec2>& positions, const std::vector<float>& reach)
+        {
+            cellStart.clear();
+            items.clear();
+            columns = rows = 0;
+            if (positions.empty()) return;
+
+            float cellSize = 0.0f;
+            float minX = positions[0].X, maxX = positions[0].X, minY = positions[0].Y, maxY = positions[0].Y;
+            for (size_t k = 0; k < positions.size(); k++)
+            {
+                cellSize = std::max(cellSize, reach[k]);
+                minX = std::min(minX, positions[k].X - reach[k]);
+                maxX = std::max(maxX, positions[k].X + reach[k]);
+                minY = std::min(minY, positions[k].Y - reach[k]);
+                maxY = std::max(maxY, positions[k].Y + reach[k]);
+            }
+            if (cellSize <= 0.0f) cellSize = 1.0f;
+
+            originX = minX;
+            originY = minY;
+            invCellSize = 1.0f / cellSize;
+            columns = std::max(1, (int)std::ceil((maxX - minX) * invCellSize));
+            rows = std::max(1, (int)std::ceil((maxY - minY) * invCellSize));
+
+            // Два прохода: сначала число радаров в каждой ячейке, потом сами номера подряд
+            std::vector<uint32_t> counts((size_t)columns * rows, 0);
+            for (int pass = 0; pass < 2; pass++)
+            {
+                if (pass == 1)
+                {
+                    cellStart.assign(counts.size() + 1, 0);
+                    for (size_t c = 0; c < counts.size(); c++) cellStart[c + 1] = cellStart[c] + counts[c];
+                    items.resize(cellStart.back());
+                    std::fill(counts.begin(), counts.end(), 0);
+                }
+
+                for (size_t k = 0; k < positions.size(); k++)
+                {
+                    int c0 = CellX(positions[k].X - reach[k]), c1 = CellX(positions[k].X + reach[k]);
+                    int r0 = CellY(positions[k].Y - reach[k]), r1 = CellY(positions[k].Y + reach[k]);
+                    for (int r = r0; r <= r1; r++)
+                    {
+                        for (int c = c0; c <= c1; c++)
+                        {
+                            if (!DiskTouchesCell(positions[k], reach[k], c, r)) continue;
+                            size_t cell = (size_t)r * columns + c;
+                            if (pass == 1) items[cellStart[cell] + counts[cell]] = (uint32_t)k;
+                            counts[cell]++;
+                        }
+                    }
+                }
+            }
+        }
+
+        // Радары, которые могут дотянуться до точки (x, y)
+        Span At(float x, float y) const
+        {
+            float fx = (x - originX) * invCellSize;
+            float fy = (y - originY) * invCellSize;
+            if (!(fx >= 0.0f && fy >= 0.0f && fx < (float)columns && fy < (float)rows)) return Span{ nullptr, nullptr };
+            size_t cell = (size_t)(int)fy * columns + (size_t)(int)fx;
+            return Span{ items.data() + cellStart[cell], items.data() + cellStart[cell + 1] };
+        }
+
+        int Columns() const { return columns; }
+        int Rows() const { return rows; }
+
+    private:
+        float originX;
+        float originY;
+        float invCellSize;
+        int columns;
+        int rows;
+        std::vector<uint32_t> cellStart; // Начало списка ячейки c в items (cellStart[c + 1] - конец)
+        std::vector<uint32_t> items;     // Номера радаров всех ячеек подряд
+
+        int CellX(float x) const
+        {
+            return std::min(columns - 1, std::max(0, (int)std::floor((x - originX) * invCellSize)));
+        }
+
+        int CellY(float y) const
+        {
+            return std::min(rows - 1, std::max(0, (int)std::floor((y - originY) * invCellSize)));
+        }
+
+        // Пересекает ли круг прямоугольник ячейки
+        bool DiskTouchesCell(Vec2 center, float radius, int c, int r) const
+        {
+            float cellSize = 1.0f / invCellSize;
+            float left = originX + c * cellSize, top = originY + r * cellSize;
+            float nearestX = std::min(std::max(center.X, left), left + cellSize);
+            float nearestY = std::min(std::max(center.Y, top), top + cellSize);
+            return DistanceSquared(center, Vec2(nearestX, nearestY)) <= radius * radius * 1.0001f + 1e-3f;
+        }
+    };
+}
@@ -0,0 +1,463 @@
+// Запись партии в компактный двоичный файл и проигрывание через отображение файла в память
+#include "Replay.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sim
+{
+    namespace
+    {
+        const char Magic[8] = { 'R', 'D', 'R', 'R', 'E', 'P', 'L', '1' };
+        const uint32_t Version = 1;
+
+        int16_t Quantize(float value, float scale)
+        {
+            float q = std::round(value / scale);
+            return (int16_t)std::min(32767.0f, std::max(-32767.0f, q));
+        }
+
+        // Угол луча в записи - старшие 16 бит двоичного угла радара (с округлением)
+        uint16_t AngleToBam(BinaryAngle angle)
+        {
+            return (uint16_t)((angle + 0x8000u) >> 16);
+        }
+
+        BinaryAngle BamToAngle(uint16_t bam)
+        {
+            return (BinaryAngle)bam << 16;
+        }
+
+        const Radar& RadarAt(const Simulation& simulation, size_t k)
+        {
+            return k == 0 ? simulation.MainRadar : simulation.SupportRadars[k - 1];
+        }
+
+        template <typename T>
+        void Append(std::vector<uint8_t>& out, const T& value)
+        {
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+            out.insert(out.end(), bytes, bytes + sizeof(T));
+        }
+    }
+
+    ReplayRecorder::ReplayRecorder() : file(nullptr), bytesWritten(0), blockTick(0), failed(false)
+    {
+        std::memset(&header, 0, sizeof(header));
+    }
+
+    ReplayRecorder::~ReplayRecorder()
+    {
+        if (file != nullptr) std::fclose(file);
+    }
+
+    bool ReplayRecorder::Open(const std::string& path, Simulation& simulation, float stepSec, uint32_t keyframeInterval, std::string* error)
+    {
+        // Между ключевыми кадрами ракеты восстанавливаются прямым полетом, поэтому записать можно только его
+        if (!simulation.Config.RocketModel.Straight())
+        {
+            if (error) *error = "запись партии не поддерживает наведение, маневр и профиль скорости ракет (rocket_guidance и др.)";
+            return false;
+        }
+        file = std::fopen(path.c_str(), "wb");
+        if (file == nullptr)
+        {
+            if (error) *error = "не удалось создать файл записи " + path;
+            return false;
+        }
+        bytesWritten = 0;
+        failed = false;
+        index.clear();
+        events.clear();
+
+        // Квантование: координаты - в пределах полуторного размаха мира (установки, радары с зонами обнаружения),
+        // скорости - в пределах наибольшей скорости ракет
+        float extent = 1.0f;
+        for (const Launcher& launcher : simulation.Launchers)
+        {
+            extent = std::max(extent, std::max(std::fabs(launcher.Position.X), std::fabs(launcher.Position.Y)));
+        }
+        for (size_t k = 0; k <= simulation.SupportRadars.size(); k++)
+        {
+            const Radar& radar = RadarAt(simulation, k);
+            extent = std::max(extent, std::max(std::fabs(radar.Position.X), std::fabs(radar.Position.Y)) + radar.MaxDetectionRangeP);
+        }
+        float maxSpeed = std::max(1.0f, std::max(simulation.Config.RocketSpeed, simulation.Config.ScenarioInfo.FastestSpeed));
+        for (float speed : simulation.ActiveRockets.Speed) maxSpeed = std::max(maxSpeed, speed);
+
+        if (keyframeInterval == 0) keyframeInterval = (uint32_t)std::max(1.0f, std::round(2.0f / stepSec));
+        keyframeInterval = std::min<uint32_t>(keyframeInterval, 65535);
+
+        std::memcpy(header.Magic, Magic, sizeof(Magic));
+        header.Version = Version;
+        header.HeaderSize = sizeof(ReplayHeader);
+        header.StepSec = stepSec;
+        header.PositionScale = extent * 1.5f / 32767.0f;
+        header.VelocityScale = maxSpeed * 1.01f / 32767.0f;
+        header.KeyframeInterval = keyframeInterval;
+        header.RadarCount = (uint32_t)simulation.SupportRadars.size() + 1;
+        header.LauncherCount = (uint32_t)simulation.Launchers.size();
+        header.Seed = simulation.Seed;
+        header.TotalRocketsToLaunch = simulation.Config.TotalRocketsToLaunch;
+        header.Result = (uint8_t)Outcome::InProgress;
+        Write(&header, sizeof(header));
+
+        radarDestroyed.assign(header.RadarCount, 0);
+        for (size_t k = 0; k < header.RadarCount; k++)
+        {
+            const Radar& radar = RadarAt(simulation, k);
+            ReplayRadarInfo info = { radar.Position.X, radar.Position.Y, radar.RotationSpeedDps, radar.BeamWidthDegrees,
+                radar.MaxDetectionRangeP, radar.BeamEffectiveRadiusR, radar.CircularAttackRange,
+                radar.CoreVulnerabilityRadius, radar.DeadZoneRadius };
+            Write(&info, sizeof(info));
+            radarDestroyed[k] = radar.IsDestroyed ? 1 : 0;
+        }
+        for (const Launcher& launcher : simulation.Launchers)
+        {
+            ReplayLauncherInfo info = { launcher.Position.X, launcher.Position.Y, launcher.Id };
+            Write(&info, sizeof(info));
+        }
+
+        simulation.RecordEvents = true;
+        simulation.Events.clear();
+        StartBlock(simulation);
+        return !failed;
+    }
+
+    void ReplayRecorder::Record(Simulation& simulation)
+    {
+        if (file == nullptr) return;
+
+        uint16_t offset = (uint16_t)(simulation.TickCount - blockTick);
+        for (const SimEvent& e : simulation.Events)
+        {
+            ReplayEvent event = { offset, (uint8_t)e.Type, 0, e.RocketId,
+                Quantize(e.X, header.PositionScale), Quantize(e.Y, header.PositionScale),
+                Quantize(e.VX, header.VelocityScale), Quantize(e.VY, header.VelocityScale) };
+            events.push_back(event);
+        }
+        simulation.Events.clear();
+
+        // Радары, выведенные из строя на этом шаге
+        for (size_t k = 0; k < radarDestroyed.size(); k++)
+        {
+            if (!radarDestroyed[k] && RadarAt(simulation, k).IsDestroyed)
+            {
+                radarDestroyed[k] = 1;
+                ReplayEvent event = { offset, ReplayEvent::RadarDestroyed, (uint8_t)std::min<size_t>(k, 255), 0, 0, 0, 0, 0 };
+                events.push_back(event);
+            }
+        }
+
+        if (simulation.TickCount - blockTick >= header.KeyframeInterval)
+        {
+            FlushBlock();
+            StartBlock(simulation);
+        }
+    }
+
+    bool ReplayRecorder::Close(const Simulation& simulation, std::string* error)
+    {
+        if (file == nullptr) return !failed;
+        FlushBlock();
+
+        header.IndexOffset = bytesWritten;
+        header.KeyframeCount = index.size();
+        header.TickCount = simulation.TickCount;
+        header.Result = (uint8_t)simulation.Result;
+        Write(index.data(), index.size() * sizeof(uint64_t));
+
+        // Заголовок переписывается с итоговыми счетчиками
+        if (std::fseek(file, 0, SEEK_SET) != 0 || std::fwrite(&header, sizeof(header), 1, file) != 1) failed = true;
+        if (std::fclose(file) != 0) failed = true;
+        file = nullptr;
+        if (failed && error) *error = "ошибка записи файла партии";
+        return !failed;
+    }
+
+    void ReplayRecorder::StartBlock(const Simulation& simulation)
+    {
+        const RocketStore& rockets = simulation.ActiveRockets;
+        blockTick = simulation.TickCount;
+        block.clear();
+        events.clear();
+
+        ReplayKeyframeHeader keyframe = { simulation.TickCount, simulation.ElapsedSec, (uint32_t)rockets.Size(), 0,
+            simulation.RocketsLaunchedCount, simulation.RocketsInterceptedCount };
+        Append(block, keyframe);
+        for (size_t k = 0; k < radarDestroyed.size(); k++)
+        {
+            const Radar& radar = RadarAt(simulation, k);
+            ReplayRadarState state = { AngleToBam(radar.Angle), (uint8_t)(radar.IsDestroyed ? 1 : 0), 0 };
+            Append(block, state);
+        }
+
+        // Ракеты по возрастанию Id: при проигрывании погибшие ищутся двоичным поиском
+        order.resize(rockets.Size());
+        for (size_t i = 0; i < order.size(); i++) order[i] = (uint32_t)i;
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return rockets.Id[a] < rockets.Id[b]; });
+        for (uint32_t i : order) Append(block, rockets.Id[i]);
+        for (uint32_t i : order) Append(block, Quantize(rockets.X[i], header.PositionScale));
+        for (uint32_t i : order) Append(block, Quantize(rockets.Y[i], header.PositionScale));
+        for (uint32_t i : order) Append(block, Quantize(rockets.VX[i], header.VelocityScale));
+        for (uint32_t i : order) Append(block, Quantize(rockets.VY[i], header.VelocityScale));
+    }
+
+    void ReplayRecorder::FlushBlock()
+    {
+        ReplayKeyframeHeader keyframe;
+        std::memcpy(&keyframe, block.data(), sizeof(keyframe));
+        keyframe.EventCount = (uint32_t)events.size();
+        std::memcpy(block.data(), &keyframe, sizeof(keyframe));
+
+        index.push_back(bytesWritten);
+        Write(block.data(), block.size());
+        Write(events.data(), events.size() * sizeof(ReplayEvent));
+        events.clear();
+    }
+
+    void ReplayRecorder::Write(const void* bytes, size_t count)
+    {
+        if (count == 0 || failed) return;
+        if (std::fwrite(bytes, 1, count, file) != count) failed = true;
+        bytesWritten += count;
+    }
+
+    ReplayReader::ReplayReader() : data(nullptr), size(0), mapping(nullptr)
+    {
+        std::memset(&header, 0, sizeof(header));
+    }
+
+    ReplayReader::~ReplayReader()
+    {
+        Close();
+    }
+
+    bool ReplayReader::Open(const std::string& path, std::string* error)
+    {
+        Close();
+#ifdef _WIN32
+        HANDLE fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE)
+        {
+            if (error) *error = "не удалось открыть " + path;
+            return false;
+        }
+        LARGE_INTEGER fileSize;
+        GetFileSizeEx(fileHandle, &fileSize);
+        size = (size_t)fileSize.QuadPart;
+        HANDLE mappingHandle = size > 0 ? CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+        CloseHandle(fileHandle);
+        if (mappingHandle != nullptr)
+        {
+            data = static_cast<const uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+            mapping = mappingHandle;
+        }
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            if (error) *error = "не удалось открыть " + path;
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) == 0) size = (size_t)info.st_size;
+        if (size > 0)
+        {
+            void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (view != MAP_FAILED) data = static_cast<const uint8_t*>(view);
+        }
+        ::close(fd);
+#endif
+        if (data == nullptr || size < sizeof(ReplayHeader))
+        {
+            Close();
+            if (error) *error = "файл записи пуст или не читается: " + path;
+            return false;
+        }
+
+        std::memcpy(&header, data, sizeof(header));
+        size_t infoEnd = sizeof(ReplayHeader) + (size_t)header.RadarCount * sizeof(ReplayRadarInfo) + (size_t)header.LauncherCount * sizeof(ReplayLauncherInfo);
+        if (std::memcmp(header.Magic, Magic, sizeof(Magic)) != 0 || header.Version != Version || header.HeaderSize != sizeof(ReplayHeader)
+            || header.RadarCount == 0 || header.KeyframeInterval == 0 || header.KeyframeCount == 0 || infoEnd > size
+            || header.IndexOffset > size || (size - header.IndexOffset) / sizeof(uint64_t) < header.KeyframeCount)
+        {
+            Close();
+            if (error) *error = "не файл записи партии или запись не закончена: " + path;
+            return false;
+        }
+
+        radars.resize(header.RadarCount);
+        std::memcpy(radars.data(), data + sizeof(ReplayHeader), radars.size() * sizeof(ReplayRadarInfo));
+        launchers.resize(header.LauncherCount);
+        std::memcpy(launchers.data(), data + sizeof(ReplayHeader) + radars.size() * sizeof(ReplayRadarInfo), launchers.size() * sizeof(ReplayLauncherInfo));
+        return true;
+    }
+
+    void ReplayReader::Close()
+    {
+#ifdef _WIN32
+        if (data != nullptr) UnmapViewOfFile(data);
+        if (mapping != nullptr) CloseHandle((HANDLE)mapping);
+#else
+        if (data != nullptr) munmap(const_cast<uint8_t*>(data), size);
+#endif
+        data = nullptr;
+        mapping = nullptr;
+        size = 0;
+    }
+
+    bool ReplayReader::Seek(uint64_t tick, SimSnapshot& out, std::string* error)
+    {
+        if (data == nullptr)
+        {
+            if (error) *error = "файл записи не открыт";
+            return false;
+        }
+        tick = std::min(tick, header.TickCount);
+
+        // Блок опорного кадра - прямо по номеру шага
+        uint64_t blockIndex = std::min<uint64_t>(tick / header.KeyframeInterval, header.KeyframeCount - 1);
+        uint64_t offset;
+        std::memcpy(&offset, data + header.IndexOffset + blockIndex * sizeof(uint64_t), sizeof(offset));
+
+        ReplayKeyframeHeader keyframe;
+        if (offset + sizeof(keyframe) > size)
+        {
+            if (error) *error = "поврежденный индекс записи";
+            return false;
+        }
+        std::memcpy(&keyframe, data + offset, sizeof(keyframe));
+        const uint8_t* states = data + offset + sizeof(keyframe);
+        const uint8_t* rockets = states + (size_t)header.RadarCount * sizeof(ReplayRadarState);
+        size_t n = keyframe.RocketCount;
+        const uint8_t* eventData = rockets + n * (sizeof(uint32_t) + 4 * sizeof(int16_t));
+        if ((size_t)(eventData - data) + (size_t)keyframe.EventCount * sizeof(ReplayEvent) > header.IndexOffset)
+        {
+            if (error) *error = "поврежденный блок записи";
+            return false;
+        }
+
+        const float positionScale = header.PositionScale, velocityScale = header.VelocityScale;
+        const float step = header.StepSec;
+        uint64_t span = tick - keyframe.Tick;
+
+        // Радары: угол опорного кадра плюс вращение (до выхода из строя)
+        std::vector<uint64_t> destroyedAt(header.RadarCount, UINT64_MAX);
+        std::vector<Radar> radarStates;
+        radarStates.reserve(header.RadarCount);
+        for (size_t k = 0; k < header.RadarCount; k++)
+        {
+            const ReplayRadarInfo& info = radars[k];
+            ReplayRadarState state;
+            std::memcpy(&state, states + k * sizeof(state), sizeof(state));
+            Radar radar(Vec2(info.X, info.Y), info.RotationSpeedDps, info.BeamWidthDegrees, info.MaxDetectionRangeP,
+                info.BeamEffectiveRadiusR, info.CircularAttackRange, info.CoreVulnerabilityRadius, info.DeadZoneRadius);
+            radar.Angle = BamToAngle(state.AngleBam);
+            radar.IsDestroyed = state.Destroyed != 0;
+            radarStates.push_back(radar);
+        }
+
+        // Ракеты опорного кадра
+        tracks.resize(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            Track& track = tracks[i];
+            int16_t q[4];
+            std::memcpy(&track.Id, rockets + i * sizeof(uint32_t), sizeof(uint32_t));
+            for (int c = 0; c < 4; c++) std::memcpy(&q[c], rockets + n * sizeof(uint32_t) + ((size_t)c * n + i) * sizeof(int16_t), sizeof(int16_t));
+            track.X = q[0] * positionScale; track.Y = q[1] * positionScale;
+            track.VX = q[2] * velocityScale; track.VY = q[3] * velocityScale;
+            track.BaseTick = keyframe.Tick;
+            track.Gone = false;
+        }
+
+        // События до нужного шага включительно (они идут по возрастанию шага)
+        int launched = keyframe.Launched, intercepted = keyframe.Intercepted;
+        for (size_t e = 0; e < keyframe.EventCount; e++)
+        {
+            ReplayEvent event;
+            std::memcpy(&event, eventData + e * sizeof(event), sizeof(event));
+            if (event.TickOffset > span) break;
+            uint64_t eventTick = keyframe.Tick + event.TickOffset;
+            switch (event.Type)
+            {
+            case ReplayEvent::Launch:
+                // Точка запуска записана такой, что за шаг запуска ракета приходит туда, где она к концу шага
+                // (стартовав посреди шага, она отнесена назад на опоздание от начала шага, см. Simulation::LaunchRocket)
+                tracks.push_back(Track{ event.RocketId, event.X * positionScale, event.Y * positionScale,
+                    event.VX * velocityScale, event.VY * velocityScale, eventTick - 1, false });
+                launched++;
+                break;
+            case ReplayEvent::Intercept:
+            case ReplayEvent::Lost:
+            {
+                if (event.Type == ReplayEvent::Intercept) intercepted++;
+                auto found = std::lower_bound(tracks.begin(), tracks.end(), event.RocketId,
+                    [](const Track& track, uint32_t id) { return track.Id < id; });
+                if (found != tracks.end() && found->Id == event.RocketId) found->Gone = true;
+                break;
+            }
+            case ReplayEvent::RadarDestroyed:
+                if (event.Radar < radarStates.size())
+                {
+                    radarStates[event.Radar].IsDestroyed = true;
+                    destroyedAt[event.Radar] = eventTick;
+                }
+                break;
+            }
+        }
+        for (size_t k = 0; k < radarStates.size(); k++)
+        {
+            Radar& radar = radarStates[k];
+            // Угол: уничтоженный в этом блоке радар замирает на шаге уничтожения
+            bool destroyedBefore = radar.IsDestroyed && destroyedAt[k] == UINT64_MAX;
+            if (destroyedBefore) continue;
+            uint64_t until = std::min(tick, destroyedAt[k]);
+            // Поворот за шаг тот же, что в Radar::Update, поэтому шаги складываются так же точно
+            radar.Angle += BinaryAngleFromDegrees((double)radar.RotationSpeedDps * step) * (BinaryAngle)(until - keyframe.Tick);
+        }
+
+        // Снимок: прямолинейное движение от опорной точки каждой ракеты
+        out.MainRadar = radarStates[0];
+        out.SupportRadars.assign(radarStates.begin() + 1, radarStates.end());
+        out.Launchers.clear();
+        for (const ReplayLauncherInfo& info : launchers) out.Launchers.push_back(Launcher(Vec2(info.X, info.Y), info.Id, 0.0f, 0.0f, 0));
+        out.Rockets.Clear();
+        for (const Track& track : tracks)
+        {
+            if (track.Gone) continue;
+            float t = step * (float)(tick - track.BaseTick);
+            Rocket rocket(Vec2(track.X + track.VX * t, track.Y + track.VY * t), Vec2(0, 0), std::sqrt(track.VX * track.VX + track.VY * track.VY));
+            rocket.Velocity = Vec2(track.VX, track.VY);
+            out.Rockets.Add(rocket);
+            out.Rockets.Id.back() = track.Id;
+        }
+
+        out.RocketsLaunchedCount = launched;
+        out.RocketsInterceptedCount = intercepted;
+        out.TotalRocketsToLaunch = header.TotalRocketsToLaunch;
+        out.GameOver = tick == header.TickCount && header.Result != (uint8_t)Outcome::InProgress;
+        out.Result = out.GameOver ? (Outcome)header.Result : Outcome::InProgress;
+        out.TickCount = tick;
+        out.ElapsedSec = keyframe.ElapsedSec + step * (double)span;
+        out.Seed = header.Seed;
+        out.LastStepSec = step;
+        out.StepSec = step;
+        out.PublishedAtSec = 0.0;
+        out.AlphaAtPublish = 1.0f;
+        return true;
+    }
+}
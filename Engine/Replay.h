@@ -0,0 +1,178 @@
+#pragma once
+
+#include "SimSnapshot.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace sim
+{
+    // Двоичный формат записи партии. Все числа - little-endian, структуры лежат в файле как есть.
+    //
+    // Файл: ReplayHeader, ReplayRadarInfo[RadarCount], ReplayLauncherInfo[LauncherCount],
+    // затем блоки, затем индекс - uint64_t[KeyframeCount] со смещениями блоков от начала файла.
+    // Блок k начинается опорным кадром на шаге k * KeyframeInterval:
+    //   ReplayKeyframeHeader, ReplayRadarState[RadarCount],
+    //   ракеты по возрастанию Id: uint32_t Id[n], int16_t X[n], Y[n], VX[n], VY[n] (квантованные),
+    //   ReplayEvent[EventCount] - события шагов после опорного кадра до следующего включительно.
+    // Переход к любому шагу: номер блока = шаг / KeyframeInterval, смещение - из индекса,
+    // затем опорный кадр продвигается событиями и прямолинейным движением не больше чем на KeyframeInterval шагов
+    struct ReplayHeader
+    {
+        char Magic[8];              // "RDRREPL1"
+        uint32_t Version;
+        uint32_t HeaderSize;        // sizeof(ReplayHeader)
+        float StepSec;              // Длина шага партии
+        float PositionScale;        // Мировых единиц на единицу квантованной координаты
+        float VelocityScale;        // То же для скорости (единиц в секунду)
+        uint32_t KeyframeInterval;  // Шагов между опорными кадрами
+        uint32_t RadarCount;        // Главный радар и дополнительные
+        uint32_t LauncherCount;
+        uint64_t Seed;
+        uint64_t TickCount;         // Сколько шагов записано
+        uint64_t KeyframeCount;
+        uint64_t IndexOffset;       // Смещение индекса от начала файла
+        int32_t TotalRocketsToLaunch;
+        uint8_t Result;             // Outcome в конце записи
+        uint8_t Reserved[3];
+    };
+
+    // Неизменные параметры радара
+    struct ReplayRadarInfo
+    {
+        float X, Y;
+        float RotationSpeedDps;
+        float BeamWidthDegrees;
+        float MaxDetectionRangeP;
+        float BeamEffectiveRadiusR;
+        float CircularAttackRange;
+        float CoreVulnerabilityRadius;
+        float DeadZoneRadius;
+    };
+
+    struct ReplayLauncherInfo
+    {
+        float X, Y;
+        int32_t Id;
+    };
+
+    struct ReplayKeyframeHeader
+    {
+        uint64_t Tick;
+        double ElapsedSec;
+        uint32_t RocketCount;
+        uint32_t EventCount;
+        int32_t Launched;
+        int32_t Intercepted;
+    };
+
+    // Состояние радара в опорном кадре: угол луча в двоичных долях круга (65536 = 360 градусов)
+    struct ReplayRadarState
+    {
+        uint16_t AngleBam;
+        uint8_t Destroyed;
+        uint8_t Reserved;
+    };
+
+    // Событие шага, 16 байт
+    struct ReplayEvent
+    {
+        enum Kind : uint8_t
+        {
+            Launch = SimEvent::Launch,
+            Intercept = SimEvent::Intercept,
+            Lost = SimEvent::Lost,
+            RadarDestroyed = 3      // Радар Radar выведен из строя
+        };
+
+        uint16_t TickOffset;        // Шаг события минус шаг опорного кадра (1..KeyframeInterval)
+        uint8_t Type;
+        uint8_t Radar;
+        uint32_t RocketId;
+        int16_t X, Y;               // Для запуска - точка старта, для гибели - точка гибели
+        int16_t VX, VY;
+    };
+
+    static_assert(sizeof(ReplayHeader) == 80, "формат файла записи");
+    static_assert(sizeof(ReplayKeyframeHeader) == 32, "формат файла записи");
+    static_assert(sizeof(ReplayRadarState) == 4, "формат файла записи");
+    static_assert(sizeof(ReplayEvent) == 16, "формат файла записи");
+
+    // Запись партии. Вызовы: Open после Reset, Record после каждого Step, Close в конце.
+    // Пока идет запись, события шагов копятся в памяти только для текущего блока
+    class ReplayRecorder
+    {
+    public:
+        ReplayRecorder();
+        ~ReplayRecorder();
+
+        ReplayRecorder(const ReplayRecorder&) = delete;
+        ReplayRecorder& operator=(const ReplayRecorder&) = delete;
+
+        // keyframeInterval - шагов между опорными кадрами (0 - примерно две секунды игрового времени).
+        // Включает simulation.RecordEvents. При ошибке возвращает false и текст в error
+        bool Open(const std::string& path, Simulation& simulation, float stepSec, uint32_t keyframeInterval, std::string* error = nullptr);
+
+        // Забирает события последнего шага (очищает simulation.Events) и при необходимости пишет опорный кадр
+        void Record(Simulation& simulation);
+
+        // Дописывает последний блок и индекс. false - ошибка записи
+        bool Close(const Simulation& simulation, std::string* error = nullptr);
+
+        uint64_t BytesWritten() const { return bytesWritten; }
+
+    private:
+        FILE* file;
+        ReplayHeader header;
+        uint64_t bytesWritten;
+        uint64_t blockTick;                 // Шаг опорного кадра текущего блока
+        std::vector<uint8_t> block;         // Опорный кадр текущего блока
+        std::vector<ReplayEvent> events;    // События текущего блока
+        std::vector<uint64_t> index;        // Смещения записанных блоков
+        std::vector<uint8_t> radarDestroyed;
+        std::vector<uint32_t> order;        // Рабочий массив: ракеты по возрастанию Id
+        bool failed;
+
+        void StartBlock(const Simulation& simulation);
+        void FlushBlock();
+        void Write(const void* data, size_t size);
+    };
+
+    // Проигрывание записи: файл отображается в память, переход к любому шагу - через индекс
+    class ReplayReader
+    {
+    public:
+        ReplayReader();
+        ~ReplayReader();
+
+        ReplayReader(const ReplayReader&) = delete;
+        ReplayReader& operator=(const ReplayReader&) = delete;
+
+        bool Open(const std::string& path, std::string* error = nullptr);
+        void Close();
+
+        const ReplayHeader& Header() const { return header; }
+
+        // Состояние на шаге tick (0..TickCount) в виде снимка для отрисовки и разбора
+        bool Seek(uint64_t tick, SimSnapshot& out, std::string* error = nullptr);
+
+    private:
+        const uint8_t* data;
+        size_t size;
+        void* mapping;                      // Дескриптор отображения (Windows)
+        ReplayHeader header;
+        std::vector<ReplayRadarInfo> radars;
+        std::vector<ReplayLauncherInfo> launchers;
+
+        // Рабочие массивы восстановления кадра
+        struct Track
+        {
+            uint32_t Id;
+            float X, Y, VX, VY;
+            uint64_t BaseTick;              // На каком шаге ракета была в точке (X, Y)
+            bool Gone;
+        };
+        std::vector<Track> tracks;
+    };
+}
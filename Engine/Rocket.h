@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Vec2.h"
+
+namespace sim
+{
+    // Нативное состояние ракеты без зависимостей от GDI+
+    struct Rocket
+    {
+        Vec2 Position;      // Текущие координаты ракеты в игровом мире
+        Vec2 Velocity;      // Вектор скорости (направление и величина движения в секунду)
+        float Speed;        // Скалярная скорость ракеты (длина вектора скорости)
+        bool IsActive;      // Флаг, показывающий, активна ли ракета (летит ли она)
+        bool IsIntercepted; // Флаг для отслеживания, была ли ракета перехвачена радаром
+
+        Rocket(Vec2 startPos, Vec2 targetPos, float speed)
+        {
+            Position = startPos;
+            Speed = speed;
+            IsActive = true;
+            IsIntercepted = false;
+
+            // Вектор скорости направлен на цель и имеет длину Speed
+            float dx = targetPos.X - startPos.X;
+            float dy = targetPos.Y - startPos.Y;
+            float length = std::sqrt(dx * dx + dy * dy);
+
+            if (length > 0)
+            {
+                Velocity = Vec2(dx / length * Speed, dy / length * Speed);
+            }
+            else
+            {
+                // Старт совпадает с целью, скорость нулевая, чтобы избежать деления на ноль
+                Velocity = Vec2(0, 0);
+            }
+        }
+
+        // Перемещение ракеты на один шаг симуляции
+        void Update(float deltaTime)
+        {
+            if (!IsActive) return;
+            Position.X += Velocity.X * deltaTime;
+            Position.Y += Velocity.Y * deltaTime;
+        }
+
+        // Расстояние от ракеты до точки
+        float GetDistanceTo(Vec2 p) const
+        {
+            return Distance(Position, p);
+        }
+    };
+}
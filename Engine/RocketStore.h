@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Rocket.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace sim
+{
+    // Хранилище ракет в виде структуры массивов (structure of arrays).
+    // Координаты, скорости и флаги всех ракет лежат в отдельных непрерывных массивах,
+    // поэтому проход по ракетам читает память подряд, без перехода по указателям.
+    // Удаление - перестановкой последней ракеты на место удаляемой, за O(1).
+    // Массивы - пул ракет: Simulation резервирует их сразу на всю партию (по TotalRocketsToLaunch),
+    // место перехваченной ракеты занимает следующая запущенная, и в ходе боя память не выделяется
+    struct RocketStore
+    {
+        // Биты в массиве Flags
+        enum : uint8_t
+        {
+            FlagActive = 1 << 0,      // Ракета летит
+            FlagIntercepted = 1 << 1  // Ракета перехвачена радаром
+        };
+
+        std::vector<float> X;         // Координата X каждой ракеты
+        std::vector<float> Y;         // Координата Y каждой ракеты
+        std::vector<float> VX;        // Скорость по X (в секунду)
+        std::vector<float> VY;        // Скорость по Y (в секунду)
+        std::vector<float> Speed;     // Скалярная скорость (длина вектора скорости)
+        std::vector<float> Age;       // Время полета (ведет TrajectoryModel, при прямом полете не меняется)
+        std::vector<float> DirX;      // Курс наведения - единичный вектор без отклонения змейки (TrajectoryModel)
+        std::vector<float> DirY;
+        std::vector<uint8_t> Flags;   // Флаги FlagActive / FlagIntercepted
+        std::vector<uint32_t> Id;     // Порядковый номер ракеты с момента Clear (для записи партии)
+        uint32_t NextId = 0;          // Номер, который получит следующая добавленная ракета
+
+        size_t Size() const { return X.size(); }
+        size_t Capacity() const { return X.capacity(); }
+        bool Empty() const { return X.empty(); }
+
+        void Clear()
+        {
+            X.clear(); Y.clear(); VX.clear(); VY.clear(); Speed.clear(); Age.clear(); DirX.clear(); DirY.clear(); Flags.clear(); Id.clear();
+            NextId = 0;
+        }
+
+        void Reserve(size_t capacity)
+        {
+            X.reserve(capacity); Y.reserve(capacity); VX.reserve(capacity); VY.reserve(capacity);
+            Speed.reserve(capacity); Age.reserve(capacity); DirX.reserve(capacity); DirY.reserve(capacity);
+            Flags.reserve(capacity); Id.reserve(capacity);
+        }
+
+        // Добавление ракеты в конец массивов
+        void Add(const Rocket& rocket)
+        {
+            X.push_back(rocket.Position.X);
+            Y.push_back(rocket.Position.Y);
+            VX.push_back(rocket.Velocity.X);
+            VY.push_back(rocket.Velocity.Y);
+            Speed.push_back(rocket.Speed);
+            Age.push_back(0.0f);
+            float invSpeed = rocket.Speed > 0.0f ? 1.0f / rocket.Speed : 0.0f;
+            DirX.push_back(rocket.Velocity.X * invSpeed);
+            DirY.push_back(rocket.Velocity.Y * invSpeed);
+            Flags.push_back((uint8_t)((rocket.IsActive ? FlagActive : 0) | (rocket.IsIntercepted ? FlagIntercepted : 0)));
+            Id.push_back(NextId++);
+        }
+
+        // Удаление ракеты i: на ее место переносится последняя, затем массивы укорачиваются.
+        // Порядок ракет при этом меняется
+        void SwapRemove(size_t i)
+        {
+            size_t last = X.size() - 1;
+            if (i != last)
+            {
+                X[i] = X[last]; Y[i] = Y[last]; VX[i] = VX[last]; VY[i] = VY[last];
+                Speed[i] = Speed[last]; Age[i] = Age[last]; DirX[i] = DirX[last]; DirY[i] = DirY[last];
+                Flags[i] = Flags[last]; Id[i] = Id[last];
+            }
+            X.pop_back(); Y.pop_back(); VX.pop_back(); VY.pop_back(); Speed.pop_back();
+            Age.pop_back(); DirX.pop_back(); DirY.pop_back(); Flags.pop_back(); Id.pop_back();
+        }
+
+        bool IsActive(size_t i) const { return (Flags[i] & FlagActive) != 0; }
+        bool IsIntercepted(size_t i) const { return (Flags[i] & FlagIntercepted) != 0; }
+        Vec2 Position(size_t i) const { return Vec2(X[i], Y[i]); }
+
+        // Копия ракеты i в виде отдельного объекта (для отладки и внешнего кода)
+        Rocket Get(size_t i) const
+        {
+            Rocket rocket(Position(i), Position(i), Speed[i]);
+            rocket.Velocity = Vec2(VX[i], VY[i]);
+            rocket.IsActive = IsActive(i);
+            rocket.IsIntercepted = IsIntercepted(i);
+            return rocket;
+        }
+    };
+}
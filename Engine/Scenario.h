@@ -0,0 +1,402 @@
+#pragma once
+
+#include "Vec2.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace sim
+{
+    // Файл сценария (ключ scenario в settings.txt): расстановка установок и залпы по времени.
+    // Строки "команда параметры...", пустые строки и строки с # пропускаются:
+    //   launcher <x> <y>                                  - одна установка
+    //   launcher_ring <число> <радиус> [<угол первой>]    - установки поровну по окружности вокруг радара
+    //   launcher_line <число> <x0> <y0> <x1> <y1>         - установки поровну на отрезке (концы включены)
+    //   reload <мин> <макс>                               - перезарядка следующих установок (по умолчанию launch_interval_*)
+    //   salvo <время> <установки> <ракет> [<интервал> [<скорость>]]
+    //   barrage <время> <установки> <ракет> [<скорость>]
+    // Установки нумеруются с 0 в порядке описания и все описываются до первого залпа.
+    // Залп (salvo): каждая из установок (* - все, n или a-b) выпускает <ракет> ракет с шагом <интервал> секунд,
+    // начиная с <время>, без перезарядки. Обстрел (barrage): каждая из установок выпускает <ракет> ракет
+    // по готовности - первую не раньше <время>, следующие после своей случайной перезарядки.
+    // Скорость 0 или без нее - rocket_speed. Залпы и обстрелы идут по неубыванию времени:
+    // симуляция читает их из файла по мере хода времени и держит в памяти только начавшиеся
+
+    // Установка из файла сценария
+    struct ScenarioLauncher
+    {
+        Vec2 Position;
+        float ReloadMinSec;     // Перезарядка для обстрелов (меньше 0 - launch_interval_min_sec и launch_interval_max_sec)
+        float ReloadMaxSec;
+    };
+
+    // Залп или обстрел из файла сценария
+    struct ScenarioSalvo
+    {
+        bool Barrage;           // Обстрел: установки стреляют по готовности, IntervalSec не используется
+        double TimeSec;         // Время первого выстрела от начала партии
+        uint32_t First;         // Установки First..Last включительно
+        uint32_t Last;
+        uint32_t Rockets;       // Ракет от каждой установки
+        float IntervalSec;      // Шаг между выстрелами одной установки
+        float Speed;            // Скорость ракет залпа (0 - rocket_speed)
+    };
+
+    // Сводка сценария: проверяется и считается перед партией (ScanScenario через ConfigData::ScanScenarioInfo),
+    // чтобы итог партии и резерв пула были известны до ее начала
+    struct ScenarioSummary
+    {
+        uint32_t LauncherCount = 0;
+        uint64_t SalvoCount = 0;
+        int TotalRockets = 0;       // Ракет во всех залпах
+        double LastSalvoSec = 0.0;  // Время последнего залпа
+        float LaunchDistance = 0.0f; // Наибольшее расстояние установки от радара
+        float SlowestSpeed = 0.0f;  // Наименьшая и наибольшая из скоростей, заданных залпами (0 - скорость нигде не задана)
+        float FastestSpeed = 0.0f;
+    };
+
+    // Построчное чтение файла сценария. Ошибка формата - std::invalid_argument с номером строки
+    class ScenarioReader
+    {
+    public:
+        // Наибольшее число установок в сценарии
+        static const uint32_t MaxLaunchers = 1u << 20;
+
+        bool Open(const std::string& path, std::string* error = nullptr)
+        {
+            file.close();
+            file.clear();
+            file.open(path);
+            lineNumber = 0;
+            haveLine = false;
+            launcherCount = 0;
+            lastSalvoSec = 0.0;
+            if (file) return true;
+            if (error) *error = "не удалось открыть сценарий " + path;
+            return false;
+        }
+
+        // Все установки (строки до первого залпа): add(ScenarioLauncher) вызывается на каждую по порядку номеров
+        template <class Add>
+        void ReadLaunchers(Add add)
+        {
+            reloadMinSec = -1.0f;
+            reloadMaxSec = -1.0f;
+            while (NextLine())
+            {
+                std::istringstream fields(line);
+                std::string command;
+                fields >> command;
+                if (command == "salvo" || command == "barrage")
+                {
+                    haveLine = true; // Залп прочитает NextSalvo
+                    break;
+                }
+                if (command == "reload")
+                {
+                    reloadMinSec = ReadFloat(fields);
+                    reloadMaxSec = ReadFloat(fields);
+                    if (!(reloadMinSec >= 0.0f && reloadMaxSec >= reloadMinSec)) Fail("перезарядка ожидается 0 <= мин <= макс");
+                }
+                else if (command == "launcher")
+                {
+                    float x = ReadFloat(fields), y = ReadFloat(fields);
+                    AddLaunchers(1, add, [&](uint32_t) { return Vec2(x, y); });
+                }
+                else if (command == "launcher_ring")
+                {
+                    uint32_t count = ReadCount(fields);
+                    float radius = ReadFloat(fields);
+                    double first = (fields >> std::ws).eof() ? 0.0 : ReadFloat(fields);
+                    AddLaunchers(count, add, [&](uint32_t k)
+                    {
+                        double angle = (first + 360.0 * k / count) * (3.14159265358979323846 / 180.0);
+                        return Vec2((float)(radius * std::cos(angle)), (float)(radius * std::sin(angle)));
+                    });
+                }
+                else if (command == "launcher_line")
+                {
+                    uint32_t count = ReadCount(fields);
+                    float x0 = ReadFloat(fields), y0 = ReadFloat(fields), x1 = ReadFloat(fields), y1 = ReadFloat(fields);
+                    AddLaunchers(count, add, [&](uint32_t k)
+                    {
+                        float t = count > 1 ? (float)k / (float)(count - 1) : 0.0f;
+                        return Vec2(x0 + (x1 - x0) * t, y0 + (y1 - y0) * t);
+                    });
+                }
+                else
+                {
+                    Fail("неизвестная команда " + command);
+                }
+                ExpectEnd(fields);
+            }
+        }
+
+        // Следующий залп или обстрел (после ReadLaunchers). false - файл кончился
+        bool NextSalvo(ScenarioSalvo& salvo)
+        {
+            if (!NextLine()) return false;
+            std::istringstream fields(line);
+            std::string command;
+            fields >> command;
+            if (command != "salvo" && command != "barrage")
+            {
+                if (command == "launcher" || command == "launcher_ring" || command == "launcher_line" || command == "reload")
+                    Fail("установки описываются до первого залпа");
+                Fail("неизвестная команда " + command);
+            }
+
+            salvo.Barrage = command == "barrage";
+            salvo.TimeSec = ReadFloat(fields);
+            ReadLauncherRange(fields, salvo.First, salvo.Last);
+            salvo.Rockets = ReadCount(fields);
+            salvo.IntervalSec = 0.0f;
+            salvo.Speed = 0.0f;
+            if (!salvo.Barrage && !(fields >> std::ws).eof()) salvo.IntervalSec = ReadFloat(fields);
+            if (!(fields >> std::ws).eof()) salvo.Speed = ReadFloat(fields);
+            ExpectEnd(fields);
+
+            if (!(salvo.TimeSec >= 0.0) || !std::isfinite(salvo.TimeSec)) Fail("время залпа ожидается не меньше 0");
+            if (salvo.TimeSec < lastSalvoSec) Fail("залпы ожидаются по неубыванию времени");
+            if (!(salvo.IntervalSec >= 0.0f) || !std::isfinite(salvo.IntervalSec)) Fail("интервал залпа ожидается не меньше 0");
+            if (!(salvo.Speed >= 0.0f) || !std::isfinite(salvo.Speed)) Fail("скорость залпа ожидается не меньше 0");
+            lastSalvoSec = salvo.TimeSec;
+            return true;
+        }
+
+        uint32_t LauncherCount() const { return launcherCount; }
+
+    private:
+        std::ifstream file;
+        std::string line;
+        size_t lineNumber = 0;
+        bool haveLine = false;      // Строка уже прочитана и ждет разбора
+        uint32_t launcherCount = 0;
+        double lastSalvoSec = 0.0;
+        float reloadMinSec = -1.0f;     // Перезарядка для следующих установок (команда reload)
+        float reloadMaxSec = -1.0f;
+
+        // Следующая значимая строка (без комментария)
+        bool NextLine()
+        {
+            if (haveLine)
+            {
+                haveLine = false;
+                return true;
+            }
+            while (std::getline(file, line))
+            {
+                lineNumber++;
+                size_t comment = line.find('#');
+                if (comment != std::string::npos) line.erase(comment);
+                if (line.find_first_not_of(" \t\r\n") != std::string::npos) return true;
+            }
+            return false;
+        }
+
+        [[noreturn]] void Fail(const std::string& problem) const
+        {
+            throw std::invalid_argument("сценарий, строка " + std::to_string(lineNumber) + ": " + problem);
+        }
+
+        float ReadFloat(std::istringstream& fields) const
+        {
+            std::string token;
+            if (!(fields >> token)) Fail("не хватает чисел");
+            size_t used = 0;
+            float value = 0.0f;
+            try { value = std::stof(token, &used); }
+            catch (const std::logic_error&) { used = 0; }
+            if (used == 0 || used != token.size() || !std::isfinite(value)) Fail("некорректное число: " + token);
+            return value;
+        }
+
+        uint32_t ReadIndex(const std::string& token) const
+        {
+            size_t used = 0;
+            unsigned long long value = 0;
+            if (!token.empty() && token[0] != '-')
+            {
+                try { value = std::stoull(token, &used); }
+                catch (const std::logic_error&) { used = 0; }
+            }
+            if (used == 0 || used != token.size() || value > std::numeric_limits<uint32_t>::max()) Fail("некорректное целое: " + token);
+            return (uint32_t)value;
+        }
+
+        uint32_t ReadCount(std::istringstream& fields) const
+        {
+            std::string token;
+            if (!(fields >> token)) Fail("не хватает чисел");
+            return ReadIndex(token);
+        }
+
+        // "*", "n" или "a-b"
+        void ReadLauncherRange(std::istringstream& fields, uint32_t& first, uint32_t& last) const
+        {
+            std::string token;
+            if (!(fields >> token)) Fail("не указаны установки залпа");
+            if (launcherCount == 0) Fail("залп без установок");
+            if (token == "*")
+            {
+                first = 0;
+                last = launcherCount - 1;
+                return;
+            }
+            size_t dash = token.find('-', 1);
+            first = ReadIndex(token.substr(0, dash));
+            last = dash == std::string::npos ? first : ReadIndex(token.substr(dash + 1));
+            if (first > last || last >= launcherCount) Fail("нет установок " + token + " (всего " + std::to_string(launcherCount) + ")");
+        }
+
+        void ExpectEnd(std::istringstream& fields) const
+        {
+            std::string extra;
+            if (fields >> extra) Fail("лишнее поле " + extra);
+        }
+
+        template <class Add, class At>
+        void AddLaunchers(uint32_t count, Add& add, At at)
+        {
+            if (count == 0 || count > MaxLaunchers - launcherCount) Fail("число установок ожидается от 1, всего не больше " + std::to_string(MaxLaunchers));
+            for (uint32_t k = 0; k < count; k++) add(ScenarioLauncher{ at(k), reloadMinSec, reloadMaxSec });
+            launcherCount += count;
+        }
+    };
+
+    // Проверка сценария и его сводка: файл читается целиком, но в памяти ничего не копится.
+    // При ошибке бросает std::invalid_argument
+    inline ScenarioSummary ScanScenario(const std::string& path)
+    {
+        ScenarioReader reader;
+        std::string error;
+        if (!reader.Open(path, &error)) throw std::invalid_argument(error);
+
+        ScenarioSummary summary;
+        float distanceSq = 0.0f;
+        reader.ReadLaunchers([&](const ScenarioLauncher& launcher) { distanceSq = std::max(distanceSq, DistanceSquared(launcher.Position, Vec2(0.0f, 0.0f))); });
+        summary.LauncherCount = reader.LauncherCount();
+        summary.LaunchDistance = std::sqrt(distanceSq);
+
+        uint64_t total = 0;
+        ScenarioSalvo salvo;
+        while (reader.NextSalvo(salvo))
+        {
+            summary.SalvoCount++;
+            summary.LastSalvoSec = salvo.TimeSec;
+            total += (uint64_t)(salvo.Last - salvo.First + 1) * salvo.Rockets;
+            if (total > (uint64_t)std::numeric_limits<int>::max())
+                throw std::invalid_argument("сценарий: больше " + std::to_string(std::numeric_limits<int>::max()) + " ракет");
+            if (salvo.Speed > 0.0f)
+            {
+                summary.SlowestSpeed = summary.SlowestSpeed > 0.0f ? std::min(summary.SlowestSpeed, salvo.Speed) : salvo.Speed;
+                summary.FastestSpeed = std::max(summary.FastestSpeed, salvo.Speed);
+            }
+        }
+        summary.TotalRockets = (int)total;
+        return summary;
+    }
+
+    // Залпы сценария во время партии. Файл читается по ходу времени: следующий залп берется из файла,
+    // только когда наступает его время, и хранится до последнего выстрела. Поэтому память зависит
+    // от числа одновременно идущих залпов, а не от длины сценария. Обстрелы передаются дальше
+    // в момент начала (очередь готовности установок - LaunchQueue)
+    class ScenarioStream
+    {
+    public:
+        // Открытие сценария и чтение установок. При ошибке возвращает false, установок нет
+        bool Open(const std::string& path, std::vector<ScenarioLauncher>& launchers, std::string* error = nullptr)
+        {
+            launchers.clear();
+            active.clear();
+            pendingReady = false;
+            ended = false;
+            problem.clear();
+            try
+            {
+                if (!reader.Open(path, &problem)) throw std::invalid_argument(problem);
+                reader.ReadLaunchers([&](const ScenarioLauncher& launcher) { launchers.push_back(launcher); });
+                return true;
+            }
+            catch (const std::exception& ex)
+            {
+                problem = ex.what();
+                if (error) *error = problem;
+                launchers.clear();
+                ended = true;
+                return false;
+            }
+        }
+
+        // Выстрелы, время которых наступило к nowSec: fire(номер установки, скорость) по порядку залпов,
+        // внутри выстрела - по номерам установок. Начавшиеся обстрелы - barrage(залп) по порядку в файле.
+        // Ошибка в файле (он изменился после ScanScenario) заканчивает сценарий, текст ошибки - в Error()
+        template <class Fire, class Barrage>
+        void Advance(double nowSec, Fire fire, Barrage barrage)
+        {
+            while (!ended)
+            {
+                if (!pendingReady)
+                {
+                    try { pendingReady = reader.NextSalvo(pending); }
+                    catch (const std::exception& ex) { problem = ex.what(); }
+                    if (!pendingReady)
+                    {
+                        ended = true;
+                        break;
+                    }
+                }
+                if (pending.TimeSec > nowSec) break;
+                if (pending.Barrage) barrage(pending);
+                else active.push_back(ActiveSalvo{ pending.TimeSec, pending.First, pending.Last, pending.Rockets, pending.IntervalSec, pending.Speed });
+                pendingReady = false;
+            }
+
+            for (size_t k = 0; k < active.size(); )
+            {
+                ActiveSalvo& salvo = active[k];
+                while (salvo.ShotsLeft > 0 && salvo.NextShotSec <= nowSec)
+                {
+                    for (uint32_t launcher = salvo.First; launcher <= salvo.Last; launcher++) fire(launcher, salvo.Speed);
+                    salvo.NextShotSec += salvo.IntervalSec;
+                    salvo.ShotsLeft--;
+                }
+                // Порядок залпов сохраняется: от него зависят номера ракет
+                if (salvo.ShotsLeft == 0) active.erase(active.begin() + k);
+                else k++;
+            }
+        }
+
+        // Файл прочитан и все залпы отстреляны (обстрелы - забота LaunchQueue)
+        bool Finished() const { return ended && active.empty(); }
+
+        // Сколько залпов идет сейчас
+        size_t ActiveSalvoCount() const { return active.size(); }
+
+        const std::string& Error() const { return problem; }
+
+    private:
+        struct ActiveSalvo
+        {
+            double NextShotSec;
+            uint32_t First;
+            uint32_t Last;
+            uint32_t ShotsLeft;
+            float IntervalSec;
+            float Speed;
+        };
+
+        ScenarioReader reader;
+        ScenarioSalvo pending;      // Прочитанный, но еще не начавшийся залп
+        bool pendingReady = false;
+        bool ended = true;
+        std::vector<ActiveSalvo> active;
+        std::string problem;
+    };
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+
+namespace sim
+{
+    // Перемешивание 64-битного числа (финализатор SplitMix64)
+    inline uint64_t Mix64(uint64_t z)
+    {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Счетный (counter-based) генератор случайных чисел: i-е число потока - это Mix64(ключ + i * константа).
+    // Состояние - два 64-битных числа, без общих таблиц и блокировок, поэтому у каждой симуляции
+    // и у каждой пусковой установки свой независимый поток, а сотни параллельных симуляций не делят память.
+    // Последовательность полностью определяется (seed, номер потока) и одинакова на любой платформе
+    struct RandomStream
+    {
+        uint64_t Key;     // Ключ потока, выведенный из seed и номера потока
+        uint64_t Counter; // Сколько чисел уже выдано
+
+        RandomStream() : Key(0), Counter(0) {}
+
+        RandomStream(uint64_t seed, uint64_t streamId)
+        {
+            Key = Mix64(seed ^ Mix64(streamId + 0x632BE59BD9B4E019ull));
+            Counter = 0;
+        }
+
+        // Число с произвольным номером, без изменения состояния
+        uint64_t At(uint64_t index) const
+        {
+            return Mix64(Key + (index + 1) * 0x9E3779B97F4A7C15ull);
+        }
+
+        uint64_t NextU64()
+        {
+            return At(Counter++);
+        }
+
+        // Равномерное число в [0, 1) с 24 значащими битами (точно представимо во float)
+        float NextFloat()
+        {
+            return (float)(NextU64() >> 40) * (1.0f / 16777216.0f);
+        }
+
+        // Равномерное число в [min, max]
+        float NextRange(float min, float max)
+        {
+            return NextFloat() * (max - min) + min;
+        }
+    };
+
+    // Номера потоков внутри одной симуляции
+    enum : uint64_t
+    {
+        StreamLaunchSchedule = 0,   // Общий таймер запуска
+        StreamLauncherBase = 1,     // Поток пусковой установки с номером Id - StreamLauncherBase + Id
+        StreamLaunchHeading = 1ull << 40 // Разброс курса ракет (rocket_launch_spread_degrees), число - по номеру ракеты
+    };
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Simulation.h"
+#include <vector>
+#include <cstdint>
+
+namespace sim
+{
+    // Неизменяемый снимок состояния партии для отрисовки.
+    // Поток симуляции заполняет снимок после шагов и передает его окну (SimulationThread);
+    // окно рисует снимок, не трогая саму симуляцию, без копирования и без блокировок.
+    // Массивы переиспользуются между снимками, поэтому после разгона заполнение не выделяет память
+    struct SimSnapshot
+    {
+        Radar MainRadar;                  // Радар в центре
+        std::vector<Radar> SupportRadars; // Дополнительные радары сети
+        std::vector<Launcher> Launchers;  // Пусковые установки
+        RocketStore Rockets;              // Ракеты в полете
+
+        int RocketsLaunchedCount;
+        int RocketsInterceptedCount;
+        int TotalRocketsToLaunch;
+        bool GameOver;
+        Outcome Result;
+        uint64_t TickCount;
+        double ElapsedSec;
+        uint64_t Seed;
+        float LastStepSec;                // Длительность последнего шага (для интерполяции)
+        uint32_t ConfigVersion;           // Меняется, когда к партии применена новая конфигурация (зоны радаров, установки)
+        float RenderRateHz;               // Частота перерисовки окна из текущей конфигурации
+
+        ProfileSummary Profile;           // Замеры фаз шага потока симуляции (обновляются несколько раз в секунду)
+
+        double StepSec;                   // Длина фиксированного шага потока симуляции
+        double PublishedAtSec;            // Когда снимок опубликован (по часам SimulationThread::NowSec)
+        float AlphaAtPublish;             // Доля шага, накопленная к моменту публикации
+        bool Warping;                     // Поток симуляции перематывает партию (SimulationThread::Warp)
+        uint32_t WarpSerial;              // Последний запрос перемотки, принятый потоком
+
+        SimSnapshot()
+            : MainRadar(Vec2(0, 0), 0, 0, 0, 0, 0, 0, 0),
+              RocketsLaunchedCount(0), RocketsInterceptedCount(0), TotalRocketsToLaunch(0),
+              GameOver(false), Result(Outcome::InProgress), TickCount(0), ElapsedSec(0.0), Seed(0),
+              LastStepSec(0.0f), ConfigVersion(0), RenderRateHz(0.0f), StepSec(0.0), PublishedAtSec(0.0), AlphaAtPublish(0.0f), Warping(false), WarpSerial(0) {}
+
+        // Заполнение снимка текущим состоянием симуляции
+        void CaptureFrom(const Simulation& simulation)
+        {
+            MainRadar = simulation.MainRadar;
+            SupportRadars = simulation.SupportRadars;
+            Launchers = simulation.Launchers;
+            Rockets = simulation.ActiveRockets;
+
+            RocketsLaunchedCount = simulation.RocketsLaunchedCount;
+            RocketsInterceptedCount = simulation.RocketsInterceptedCount;
+            TotalRocketsToLaunch = simulation.Config.TotalRocketsToLaunch;
+            GameOver = simulation.GameOver;
+            Result = simulation.Result;
+            TickCount = simulation.TickCount;
+            ElapsedSec = simulation.ElapsedSec;
+            Seed = simulation.Seed;
+            LastStepSec = simulation.LastStepSec;
+            ConfigVersion = simulation.ConfigVersion;
+            RenderRateHz = simulation.Config.RenderRateHz;
+        }
+
+        // Доля шага в момент nowSec: снимок опубликован с долей AlphaAtPublish,
+        // а дальше реальное время идет, пока поток симуляции ждет следующего шага
+        float AlphaAt(double nowSec) const
+        {
+            if (GameOver || StepSec <= 0.0) return 1.0f;
+            double alpha = AlphaAtPublish + (nowSec - PublishedAtSec) / StepSec;
+            return alpha < 0.0 ? 0.0f : (alpha > 1.0 ? 1.0f : (float)alpha);
+        }
+
+        // Интерполяция между шагами, как Simulation::InterpolationBackstepSec
+        float InterpolationBackstepSec(float alpha) const
+        {
+            return (1.0f - alpha) * LastStepSec;
+        }
+
+        // Угол луча радара в момент отрисовки, как Simulation::BeamAngleAt
+        float BeamAngleAt(const Radar& radar, float alpha) const
+        {
+            if (radar.IsDestroyed) return radar.AngleDegrees();
+            return BinaryAngleToDegrees(radar.Angle - BinaryAngleFromDegrees((double)radar.RotationSpeedDps * InterpolationBackstepSec(alpha)));
+        }
+
+        // Сколько радаров сети уничтожено (главный и дополнительные)
+        int DestroyedRadarCount() const
+        {
+            int destroyed = MainRadar.IsDestroyed ? 1 : 0;
+            for (const Radar& radar : SupportRadars)
+            {
+                if (radar.IsDestroyed) destroyed++;
+            }
+            return destroyed;
+        }
+    };
+}
@@ -0,0 +1,1135 @@
+#pragma once
+
+#include "ConfigData.h"
+#include "Radar.h"
+#include "Launcher.h"
+#include "RocketStore.h"
+#include "BeamBucketIndex.h"
+#include "RadarGrid.h"
+#include "SimRandom.h"
+#include "TickProfiler.h"
+#include "Trajectory.h"
+#include "Scenario.h"
+#include "LaunchScheduler.h"
+#include <algorithm>
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+namespace sim
+{
+    // Итог партии
+    enum class Outcome
+    {
+        InProgress,     // Игра продолжается
+        Victory,        // Все ракеты перехвачены
+        DefenseFailed,  // Все ракеты запущены и исчезли, но перехвачены не все
+        RadarDestroyed  // Ракета долетела до ядра радара
+    };
+
+    // Событие шага для записи партии (Simulation::RecordEvents)
+    struct SimEvent
+    {
+        enum Kind : uint8_t
+        {
+            Launch,     // Ракета появилась (X, Y, VX, VY - точка старта и скорость)
+            Intercept,  // Ракета перехвачена лучом (X, Y - где)
+            Lost        // Ракета погибла на ядре дополнительного радара сети или самоуничтожилась (rocket_max_flight_sec)
+        };
+
+        Kind Type;
+        uint32_t RocketId;  // RocketStore::Id
+        float X, Y;
+        float VX, VY;
+    };
+
+    // Перемотка партии без отрисовки до события (Simulation::WarpStep, RunUntil)
+    struct WarpGoal
+    {
+        enum Kind
+        {
+            Detection,      // Ракета вошла в зону обнаружения (MaxDetectionRangeP) какого-либо радара
+            Interception,   // Перехват
+            Tick            // Шаг партии с номером TargetTick
+        };
+
+        Kind Target;
+        uint64_t TargetTick;
+
+        WarpGoal(Kind target = Detection, uint64_t targetTick = 0) : Target(target), TargetTick(targetTick) {}
+    };
+
+    // Четыре пусковые установки по углам квадрата вокруг центра (Id 0..3: верхняя левая, верхняя правая,
+    // нижняя правая, нижняя левая). Общая расстановка для пошагового и событийного движков без сценария
+    inline std::vector<Launcher> MakeCornerLaunchers(const ConfigData& config, uint64_t seed)
+    {
+        std::vector<Launcher> launchers;
+        float d = (float)(config.DistanceCornerToCenter / std::sqrt(2.0));
+        launchers.push_back(Launcher(Vec2(-d, -d), 0, config.LaunchIntervalMinSec, config.LaunchIntervalMaxSec, seed)); // Верхняя левая
+        launchers.push_back(Launcher(Vec2(d, -d), 1, config.LaunchIntervalMinSec, config.LaunchIntervalMaxSec, seed));  // Верхняя правая
+        launchers.push_back(Launcher(Vec2(d, d), 2, config.LaunchIntervalMinSec, config.LaunchIntervalMaxSec, seed));   // Нижняя правая
+        launchers.push_back(Launcher(Vec2(-d, d), 3, config.LaunchIntervalMinSec, config.LaunchIntervalMaxSec, seed));  // Нижняя левая
+        return launchers;
+    }
+
+    // Игровая логика, вынесенная из MyForm::GameTimer_Tick.
+    // Не знает ни об окне, ни о таймере: шаг симуляции выполняется вызовом Step(deltaTime),
+    // поэтому одна и та же логика работает и в окне, и в консольном прогоне без ограничения реальным временем
+    class Simulation
+    {
+    public:
+        ConfigData Config;              // Параметры партии
+        Radar MainRadar;                // Радар в центре игрового мира (цель всех ракет)
+        std::vector<Radar> SupportRadars; // Дополнительные радары сети из radar_site (перехватывают, но не являются целью)
+        std::vector<Launcher> Launchers; // Все пусковые установки
+        RocketStore ActiveRockets;      // Все активные ракеты в данный момент (структура массивов)
+
+        // Счетчики и флаги состояния игры
+        int RocketsLaunchedCount;       // Сколько всего ракет было запущено
+        int RocketsInterceptedCount;    // Сколько ракет было перехвачено
+        bool GameOver;                  // Флаг, который становится true, когда игра окончена
+        Outcome Result;                 // Итог партии
+        uint64_t TickCount;             // Сколько шагов симуляции выполнено
+        double ElapsedSec;              // Сколько игрового времени прошло
+        uint64_t Seed;                  // seed партии: по нему партия воспроизводится в точности
+        float LastStepSec;              // Длительность последнего шага (для интерполяции при отрисовке)
+
+        uint32_t ConfigVersion;         // Сколько раз к партии применялась новая конфигурация (ApplyConfig)
+
+        // Запись событий (для ReplayRecorder): при RecordEvents в Events складываются запуски и гибель ракет.
+        // Очищает Events тот, кто их читает
+        bool RecordEvents = false;
+        std::vector<SimEvent> Events;
+
+        // Замеры фаз шага (не владеет; nullptr - без замеров)
+        TickProfiler* Profiler = nullptr;
+
+        Simulation()
+            : MainRadar(Vec2(0, 0), 0, 0, 0, 0, 0, 0, 0)
+        {
+            Reset(ConfigData());
+        }
+
+        Simulation(const ConfigData& config, uint64_t seed)
+            : MainRadar(Vec2(0, 0), 0, 0, 0, 0, 0, 0, 0)
+        {
+            Reset(config, seed);
+        }
+
+        // Инициализация партии с seed из конфигурации (random_seed),
+        // а если он не задан - со случайным seed
+        void Reset(const ConfigData& config)
+        {
+            uint64_t seed = config.HasRandomSeed ? config.RandomSeed
+                : ((uint64_t)std::random_device()() << 32) ^ std::random_device()();
+            Reset(config, seed);
+        }
+
+        // Инициализация или перезапуск партии
+        void Reset(const ConfigData& config, uint64_t seed)
+        {
+            Config = config;
+            Seed = seed;
+            // Сводка сценария нужна траектории и пулу ракет; пакет и перебор передают уже проверенную конфигурацию
+            scenarioProblem.clear();
+            bool scenarioOpened = Config.ScanScenarioInfo(&scenarioProblem);
+            launchRandom = RandomStream(seed, StreamLaunchSchedule);
+            headingRandom = RandomStream(seed, StreamLaunchHeading);
+            trajectory.Configure(Config);
+
+            // Радар в центре игрового мира с параметрами из конфига
+            MainRadar = Radar(Vec2(0, 0), Config.RadarRotationSpeedDps, Config.RadarBeamWidthDegrees,
+                Config.RadarMaxDetectionRangeP, Config.RadarBeamEffectiveRadiusR,
+                Config.RadarCircularAttackRange, Config.RadarCoreVulnerabilityRadius,
+                Config.RadarDeadZoneRadius);
+
+            // Дополнительные радары сети: незаданные параметры берутся у главного
+            SupportRadars.clear();
+            for (const RadarSite& site : Config.RadarSites)
+            {
+                Radar radar = MainRadar;
+                radar.Position = Vec2(site.X, site.Y);
+                ApplySiteParameters(radar, site);
+                radar.SetAngleDegrees(site.StartAngleDegrees);
+                SupportRadars.push_back(radar);
+            }
+            BuildRadarGrid();
+
+            // Пусковые установки по углам квадрата вокруг центра или из сценария.
+            // Залпы сценария задают и число ракет: total_rockets_to_launch не действует
+            scenarioActive = Config.HasScenario();
+            if (scenarioActive)
+            {
+                std::vector<ScenarioLauncher> layout;
+                if (scenarioOpened) scenarioOpened = scenario.Open(Config.ScenarioPath, layout);
+                Launchers.clear();
+                Launchers.reserve(layout.size());
+                for (size_t k = 0; k < layout.size(); k++)
+                {
+                    // Без reload в сценарии установка перезаряжается, как по углам
+                    bool own = layout[k].ReloadMinSec >= 0.0f;
+                    Launchers.push_back(Launcher(layout[k].Position, (int)k, own ? layout[k].ReloadMinSec : Config.LaunchIntervalMinSec,
+                        own ? layout[k].ReloadMaxSec : Config.LaunchIntervalMaxSec, seed));
+                }
+                Config.TotalRocketsToLaunch = Launchers.empty() ? 0 : Config.ScenarioInfo.TotalRockets;
+                launchQueue.Reset(Launchers.size());
+            }
+            else
+            {
+                Launchers = MakeCornerLaunchers(Config, seed);
+            }
+            // Таймеры перезарядки считаются сразу до шага готовности. Установки сценария (их может быть миллион)
+            // стреляют из очереди launchQueue, таймеры им не нужны
+            launchTimers.Reset(scenarioActive ? 0 : Launchers.size(), FixedStepSec());
+            if (!scenarioActive)
+            {
+                for (size_t k = 0; k < Launchers.size(); k++) launchTimers.Schedule(k, Launchers[k].TimeToNextLaunchSec, 0);
+            }
+
+            ActiveRockets.Clear();
+            // Индекс по секторам строится вокруг одного радара, в сети радаров ракеты ищутся по сетке
+            bucketIndexActive = Config.RadarBucketIndex && SupportRadars.empty();
+            rocketIndex.Reset(MainRadar.Position, MainRadar.BeamWidthDegrees, MainRadar.BeamEffectiveRadiusR);
+            rocketIndex.NoteSpeed(trajectory.MaxSpeed());
+            ReserveRocketPool();
+
+            RocketsLaunchedCount = 0;
+            RocketsInterceptedCount = 0;
+            ConfigVersion = 0;
+            GameOver = false;
+            Result = Outcome::InProgress;
+            TickCount = 0;
+            ElapsedSec = 0.0;
+            LastStepSec = 0.0f;
+
+            // Первая ракета может стартовать немедленно
+            timeUntilNextPossibleLaunchSec = 0;
+            nextLauncherIndex = 0;
+
+            // Сценарий не открылся: партия не начинается. Без установок и ракет она иначе сразу кончилась бы
+            // "победой", поэтому итог остается InProgress, а причина - в ScenarioError
+            if (!scenarioOpened) GameOver = true;
+        }
+
+        // Один шаг игровой логики длительностью deltaTime секунд
+        void Step(float deltaTime)
+        {
+            if (GameOver) return;
+            RADAR_PROFILE_SCOPE(Profiler, Step);
+
+            TickCount++;
+            ElapsedSec += deltaTime;
+            LastStepSec = deltaTime;
+
+            // 1. Вращение радаров
+            {
+                RADAR_PROFILE_SCOPE(Profiler, RadarRotation);
+                MainRadar.Update(deltaTime);
+                for (Radar& radar : SupportRadars)
+                {
+                    radar.Update(deltaTime);
+                }
+            }
+
+            // 2. Собственные таймеры пусковых установок: номер шага готовности известен заранее (LaunchTimers),
+            // поэтому на шаге обходить установки не нужно. Пересчет - только если изменилась длина шага
+            if (deltaTime != launchTimers.StepSec() && !scenarioActive)
+            {
+                RADAR_PROFILE_SCOPE(Profiler, LauncherTimers);
+                launchTimers.ChangeStep(deltaTime, TickCount - 1);
+            }
+
+            // 3. Последовательный запуск ракет или залпы сценария
+            {
+                RADAR_PROFILE_SCOPE(Profiler, LaunchSchedule);
+                if (scenarioActive) UpdateScenarioLaunches();
+                else UpdateLaunchSchedule(deltaTime);
+            }
+
+            // 4. Наведение, маневр и скорость ракет (при прямом полете не нужны).
+            // Ракеты, летящие дольше rocket_max_flight_sec, самоуничтожаются
+            if (!trajectory.Straight())
+            {
+                RADAR_PROFILE_SCOPE(Profiler, Guidance);
+                if (trajectory.Advance(ActiveRockets, MainRadar.Position, deltaTime) > 0) RemoveExpired();
+            }
+
+            // 5. Движение ракет, проверка столкновений и перехват
+            bool radarAlive;
+            if (!SupportRadars.empty())
+            {
+                radarAlive = MoveNetworkAndIntercept(deltaTime);
+            }
+            else if (bucketIndexActive)
+            {
+                radarAlive = Config.RadarSweptBeam ? SweepIndexedAndIntercept(deltaTime) : MoveIndexedAndIntercept(deltaTime);
+            }
+            else
+            {
+                radarAlive = Config.RadarSweptBeam ? SweepRocketsAndIntercept(deltaTime) : MoveRocketsAndIntercept(deltaTime);
+            }
+            if (!radarAlive) return;
+
+            // 6. Проверка условий победы или поражения
+            if (RocketsLaunchedCount >= Config.TotalRocketsToLaunch && ActiveRockets.Empty())
+            {
+                Result = RocketsInterceptedCount == Config.TotalRocketsToLaunch ? Outcome::Victory : Outcome::DefenseFailed;
+                GameOver = true;
+            }
+        }
+
+        // Прогон партии до конца без окна. maxTicks ограничивает число шагов (0 - без ограничения).
+        // Возвращает итог партии (InProgress, если сработало ограничение)
+        Outcome RunToEnd(float deltaTime, uint64_t maxTicks = 0)
+        {
+            while (!GameOver && (maxTicks == 0 || TickCount < maxTicks))
+            {
+                Step(deltaTime);
+            }
+            return Result;
+        }
+
+        // Шаг перемотки: Step и проверка цели после него. Возвращает true, если цель достигнута
+        // или партия окончена (тогда дальше перематывать некуда)
+        bool WarpStep(const WarpGoal& goal, float deltaTime)
+        {
+            if (GameOver) return true;
+            if (goal.Target == WarpGoal::Tick && TickCount >= goal.TargetTick) return true;
+            const int interceptedBefore = RocketsInterceptedCount;
+            const uint32_t firstNewId = ActiveRockets.NextId;
+            Step(deltaTime);
+            if (GameOver) return true;
+            switch (goal.Target)
+            {
+            case WarpGoal::Detection: return RocketEnteredDetection(deltaTime, firstNewId);
+            case WarpGoal::Interception: return RocketsInterceptedCount > interceptedBefore;
+            default: return TickCount >= goal.TargetTick;
+            }
+        }
+
+        // Перемотка без отрисовки до цели, не дольше maxTicks шагов (0 - без ограничения).
+        // Возвращает true, если цель достигнута или партия окончена
+        bool RunUntil(const WarpGoal& goal, float deltaTime, uint64_t maxTicks = 0)
+        {
+            for (uint64_t ticks = 0; maxTicks == 0 || ticks < maxTicks; ticks++)
+            {
+                if (WarpStep(goal, deltaTime)) return true;
+            }
+            return false;
+        }
+
+        // Добавление ракеты в игру (в хранилище и, если включен, в индекс по секторам)
+        void AddRocket(const Rocket& rocket)
+        {
+            if (bucketIndexActive)
+            {
+                rocketIndex.Insert((uint32_t)ActiveRockets.Size(), rocket.Position.X, rocket.Position.Y, rocket.Speed);
+            }
+            if (RecordEvents)
+            {
+                Events.push_back(SimEvent{ SimEvent::Launch, ActiveRockets.NextId, rocket.Position.X, rocket.Position.Y,
+                    rocket.Velocity.X, rocket.Velocity.Y });
+            }
+            ActiveRockets.Add(rocket);
+        }
+
+        // Применение новой конфигурации к идущей партии (правка settings.txt, см. ConfigWatcher).
+        // Вызывается между шагами. Партия не перезапускается: обновляются только объекты, которых касаются
+        // изменившиеся ключи, а углы лучей, ракеты в полете, таймеры установок и счетчики сохраняются.
+        // rocket_speed действует на следующие запуски, модель полета (rocket_guidance и др.) - сразу на все ракеты,
+        // random_seed, record_replay и scenario - только на следующую партию.
+        // Возвращает число изменившихся ключей, их имена через запятую добавляются в changedKeys
+        int ApplyConfig(const ConfigData& next, std::string* changedKeys = nullptr)
+        {
+            const ConfigData previous = Config;
+            int changed = 0;
+            auto differs = [&](bool different, const char* key)
+            {
+                if (!different) return false;
+                if (changedKeys)
+                {
+                    if (!changedKeys->empty()) changedKeys->append(",");
+                    changedKeys->append(key);
+                }
+                changed++;
+                return true;
+            };
+
+            bool radarChanged = false;
+            radarChanged |= differs(next.RadarRotationSpeedDps != previous.RadarRotationSpeedDps, "radar_rotation_speed_dps");
+            bool beamChanged = differs(next.RadarBeamWidthDegrees != previous.RadarBeamWidthDegrees, "radar_beam_width_degrees");
+            beamChanged |= differs(next.RadarMaxDetectionRangeP != previous.RadarMaxDetectionRangeP, "radar_max_detection_range_P");
+            radarChanged |= beamChanged;
+            radarChanged |= differs(next.RadarCircularAttackRange != previous.RadarCircularAttackRange, "radar_circular_attack_range");
+            radarChanged |= differs(next.RadarCoreVulnerabilityRadius != previous.RadarCoreVulnerabilityRadius, "radar_core_vulnerability_radius");
+            radarChanged |= differs(next.RadarDeadZoneRadius != previous.RadarDeadZoneRadius, "radar_dead_zone_radius");
+            bool sitesChanged = differs(!SameSites(next.RadarSites, previous.RadarSites), "radar_site");
+            bool cornersChanged = differs(next.DistanceCornerToCenter != previous.DistanceCornerToCenter, "distance_corner_to_center");
+            bool intervalsChanged = differs(next.LaunchIntervalMinSec != previous.LaunchIntervalMinSec, "launch_interval_min_sec");
+            intervalsChanged |= differs(next.LaunchIntervalMaxSec != previous.LaunchIntervalMaxSec, "launch_interval_max_sec");
+            bool indexChanged = differs(next.RadarBucketIndex != previous.RadarBucketIndex, "radar_bucket_index");
+            differs(next.RocketSpeed != previous.RocketSpeed, "rocket_speed");
+            differs(next.TotalRocketsToLaunch != previous.TotalRocketsToLaunch, "total_rockets_to_launch");
+            differs(next.RadarSweptBeam != previous.RadarSweptBeam, "radar_swept_beam");
+            differs(next.SimRateHz != previous.SimRateHz, "sim_rate_hz");
+            differs(next.RenderRateHz != previous.RenderRateHz, "render_rate_hz");
+            const RocketModelConfig& nextModel = next.RocketModel;
+            const RocketModelConfig& previousModel = previous.RocketModel;
+            bool modelChanged = differs(nextModel.Guidance != previousModel.Guidance, "rocket_guidance");
+            modelChanged |= differs(nextModel.TurnRateDps != previousModel.TurnRateDps, "rocket_turn_rate_dps");
+            modelChanged |= differs(nextModel.LaunchSpreadDegrees != previousModel.LaunchSpreadDegrees, "rocket_launch_spread_degrees");
+            modelChanged |= differs(nextModel.WeaveAmplitudeDegrees != previousModel.WeaveAmplitudeDegrees, "rocket_weave_amplitude_degrees");
+            modelChanged |= differs(nextModel.WeavePeriodSec != previousModel.WeavePeriodSec, "rocket_weave_period_sec");
+            modelChanged |= differs(nextModel.SpeedProfile != previousModel.SpeedProfile, "rocket_speed_profile");
+            modelChanged |= differs(nextModel.MaxFlightSec != previousModel.MaxFlightSec, "rocket_max_flight_sec");
+            if (changed == 0) return 0;
+
+            Config = next;
+            // Уже запущенные ракеты остаются в партии, иначе итог не сойдется с числом перехватов
+            Config.TotalRocketsToLaunch = std::max(next.TotalRocketsToLaunch, RocketsLaunchedCount);
+            // Сценарий партии остается прежним, и число ракет в нем тоже
+            Config.ScenarioPath = previous.ScenarioPath;
+            Config.ScenarioInfo = previous.ScenarioInfo;
+            Config.ScenarioScanned = previous.ScenarioScanned;
+            if (scenarioActive) Config.TotalRocketsToLaunch = previous.TotalRocketsToLaunch;
+
+            // Радары: меняются только параметры, угол луча и состояние остаются
+            if (radarChanged)
+            {
+                MainRadar.RotationSpeedDps = Config.RadarRotationSpeedDps;
+                MainRadar.BeamWidthDegrees = Config.RadarBeamWidthDegrees;
+                MainRadar.MaxDetectionRangeP = Config.RadarMaxDetectionRangeP;
+                MainRadar.BeamEffectiveRadiusR = Config.RadarBeamEffectiveRadiusR;
+                MainRadar.CircularAttackRange = Config.RadarCircularAttackRange;
+                MainRadar.CoreVulnerabilityRadius = Config.RadarCoreVulnerabilityRadius;
+                MainRadar.DeadZoneRadius = Config.RadarDeadZoneRadius;
+            }
+            if (radarChanged || sitesChanged)
+            {
+                // Радар сети, оставшийся на прежнем месте, сохраняет угол и повреждение; новый начинает с начального угла
+                std::vector<Radar> radars;
+                radars.reserve(Config.RadarSites.size());
+                for (size_t k = 0; k < Config.RadarSites.size(); k++)
+                {
+                    const RadarSite& site = Config.RadarSites[k];
+                    bool kept = k < SupportRadars.size() && site.X == previous.RadarSites[k].X && site.Y == previous.RadarSites[k].Y;
+                    Radar radar = kept ? SupportRadars[k] : MainRadar;
+                    if (!kept)
+                    {
+                        radar.Position = Vec2(site.X, site.Y);
+                        radar.SetAngleDegrees(site.StartAngleDegrees);
+                        radar.IsDestroyed = false;
+                    }
+                    ApplySiteParameters(radar, site);
+                    radars.push_back(radar);
+                }
+                SupportRadars.swap(radars);
+                BuildRadarGrid();
+            }
+
+            // Модель полета действует сразу и на ракеты в полете (их возраст сохраняется), rocket_speed - на следующие запуски
+            if (modelChanged || next.RocketSpeed != previous.RocketSpeed || cornersChanged) trajectory.Configure(Config);
+
+            // Пул ракет растет вместе с total_rockets_to_launch (уменьшение ничего не освобождает)
+            ReserveRocketPool();
+
+            // Индекс по секторам зависит от ширины и дальности луча: перестраивается по текущим ракетам
+            if (beamChanged || sitesChanged || indexChanged)
+            {
+                bucketIndexActive = Config.RadarBucketIndex && SupportRadars.empty();
+                rocketIndex.Reset(MainRadar.Position, MainRadar.BeamWidthDegrees, MainRadar.BeamEffectiveRadiusR);
+                if (bucketIndexActive)
+                {
+                    const RocketStore& rockets = ActiveRockets;
+                    for (size_t i = 0; i < rockets.Size(); i++)
+                    {
+                        rocketIndex.Insert((uint32_t)i, rockets.X[i], rockets.Y[i], rockets.Speed[i]);
+                    }
+                }
+            }
+            rocketIndex.NoteSpeed(trajectory.MaxSpeed());
+
+            // Установки: таймеры перезарядки и потоки случайных чисел не трогаем. Установки сценария не меняются
+            if (cornersChanged && !scenarioActive)
+            {
+                std::vector<Launcher> corners = MakeCornerLaunchers(Config, Seed);
+                for (size_t k = 0; k < Launchers.size(); k++) Launchers[k].Position = corners[k].Position;
+            }
+            if (intervalsChanged && !scenarioActive)
+            {
+                for (Launcher& launcher : Launchers)
+                {
+                    launcher.MinLaunchIntervalSec = Config.LaunchIntervalMinSec;
+                    launcher.MaxLaunchIntervalSec = Config.LaunchIntervalMaxSec;
+                }
+            }
+
+            ConfigVersion++;
+            return changed;
+        }
+
+        // Длина фиксированного шага из конфигурации
+        float FixedStepSec() const
+        {
+            return Config.SimRateHz > 0.0f ? 1.0f / Config.SimRateHz : 0.033f;
+        }
+
+        // Интерполяция для отрисовки между шагами: alpha - доля шага, прошедшая после последнего Step.
+        // Картинка показывает момент между предыдущим и текущим состоянием, поэтому объекты
+        // отодвигаются назад по своему движению на (1 - alpha) шага
+        float InterpolationBackstepSec(float alpha) const
+        {
+            return (1.0f - alpha) * LastStepSec;
+        }
+
+        // Угол луча в момент отрисовки
+        float BeamAngleAt(float alpha) const
+        {
+            return BeamAngleAt(MainRadar, alpha);
+        }
+
+        // То же для любого радара сети
+        float BeamAngleAt(const Radar& radar, float alpha) const
+        {
+            if (radar.IsDestroyed) return radar.AngleDegrees();
+            return BinaryAngleToDegrees(radar.Angle - BinaryAngleFromDegrees((double)radar.RotationSpeedDps * InterpolationBackstepSec(alpha)));
+        }
+
+        // Радар сети с номером k: 0 - главный, затем SupportRadars
+        Radar& NetworkRadar(size_t k)
+        {
+            return k == 0 ? MainRadar : SupportRadars[k - 1];
+        }
+
+        // Ошибка чтения сценария: файл не открылся или не прошел проверку при Reset (партия окончена с итогом
+        // InProgress) или изменился во время партии; пусто - ошибок нет
+        const std::string& ScenarioError() const { return scenarioProblem.empty() ? scenario.Error() : scenarioProblem; }
+
+    private:
+        RandomStream launchRandom; // Поток случайных чисел общего таймера запуска
+        RandomStream headingRandom; // Разброс курса при запуске: число берется по номеру ракеты
+        TrajectoryModel trajectory; // Модель полета ракет (rocket_guidance, rocket_weave_*, rocket_speed_profile)
+
+        // Переменные для управления последовательным запуском ракет
+        float timeUntilNextPossibleLaunchSec; // Общий таймер до следующего запуска (ниже нуля - запуск уже разрешен)
+        int nextLauncherIndex;                // Индекс следующей пусковой установки, которая будет стрелять
+
+        LaunchTimers launchTimers;            // Шаг, с которого каждая установка перезарядится
+
+        // Залпы сценария (Config.ScenarioPath) вместо общего таймера и установки, стреляющие по готовности
+        bool scenarioActive;
+        ScenarioStream scenario;
+        std::string scenarioProblem;          // Ошибка проверки сценария при Reset
+        LaunchQueue launchQueue;
+
+        std::vector<uint8_t> interceptMask; // Результат пакетной проверки луча: 1 - ракета перехвачена
+
+        // Индекс ракет по секторам и кольцам (при Config.RadarBucketIndex) и рабочие массивы для него
+        bool bucketIndexActive;
+        BeamBucketIndex rocketIndex;
+        std::vector<uint32_t> candidates;   // Ракеты из корзин, которые покрывает луч
+        std::vector<float> candidateX;      // Их координаты подряд для DetectBatch
+        std::vector<float> candidateY;
+        std::vector<uint32_t> hitIndices;   // Перехваченные ракеты
+        std::vector<float> hitTimes;        // Доля шага, на которой перехвачена каждая из них (непрерывная проверка)
+
+        // Сеть радаров: сетка по дальности обнаружения и лучи всех радаров на текущем шаге
+        RadarGrid radarGrid;
+        float gridSlack;                    // Наименьший запас P - R: на сколько ракета может сместиться за шаг, не выйдя из своей ячейки
+        std::vector<BeamSector> networkBeams;
+        std::vector<SweptBeam> networkSweeps;
+        std::vector<uint32_t> allRadars;    // Все радары подряд, когда сетка не годится
+
+        // Движение всех ракет, проверка попадания в ядро и пакетный перехват лучом.
+        // Возвращает false, если радар уничтожен и игра окончена
+        bool MoveRocketsAndIntercept(float deltaTime)
+        {
+            RocketStore& rockets = ActiveRockets;
+            const size_t count = rockets.Size();
+            if (count == 0) return true;
+
+            // Проход 1: перемещение (простой цикл по массивам, компилятор его векторизует)
+            float* x = rockets.X.data();
+            float* y = rockets.Y.data();
+            {
+                RADAR_PROFILE_SCOPE(Profiler, RocketMove);
+                const float* vx = rockets.VX.data();
+                const float* vy = rockets.VY.data();
+                for (size_t i = 0; i < count; i++)
+                {
+                    x[i] += vx[i] * deltaTime;
+                    y[i] += vy[i] * deltaTime;
+                }
+            }
+
+            size_t hits;
+            {
+                RADAR_PROFILE_SCOPE(Profiler, Interception);
+                // Проход 2: попадание в ядро. Как и в оконной версии, ракеты обходятся с конца,
+                // поэтому засчитываются перехваты только тех, что стоят после долетевшей
+                // Грубый отсев - по концу шага: дальше от центра, чем радиус ядра плюс путь за шаг, ракета в ядро не входила
+                const float cx = MainRadar.Position.X, cy = MainRadar.Position.Y;
+                const float coreRadius = MainRadar.CoreVulnerabilityRadius;
+                const float* speed = rockets.Speed.data();
+                size_t firstChecked = 0;
+                for (size_t i = count; i-- > 0; )
+                {
+                    float dx = x[i] - cx, dy = y[i] - cy;
+                    float reach = coreRadius + speed[i] * deltaTime;
+                    if (dx * dx + dy * dy > reach * reach) continue;
+                    float entryTime;
+                    if (EnteredCore(i, deltaTime, entryTime))
+                    {
+                        MainRadar.IsDestroyed = true;
+                        GameOver = true;
+                        Result = Outcome::RadarDestroyed;
+                        firstChecked = i + 1;
+                        break;
+                    }
+                }
+
+                // Проход 3: пакетная проверка луча без тригонометрии для каждой ракеты
+                interceptMask.resize(count);
+                BeamSector beam = MainRadar.GetBeamSector();
+                hits = DetectBatch(beam, x + firstChecked, y + firstChecked, count - firstChecked, interceptMask.data() + firstChecked);
+                RocketsInterceptedCount += (int)hits;
+            }
+            if (GameOver) return false;
+
+            // Проход 4: удаление перехваченных
+            RemoveIntercepted(hits);
+            return true;
+        }
+
+        // Вариант для больших шагов: перехват проверяется непрерывно по всему повороту луча
+        // и по всему отрезку, пройденному ракетой за шаг. Перехваченная в течение шага ракета
+        // уже не может долететь до ядра позже в этом шаге, а вошедшая в ядро раньше перехвата - уничтожает радар.
+        // Возвращает false, если радар уничтожен и игра окончена
+        bool SweepRocketsAndIntercept(float deltaTime)
+        {
+            RocketStore& rockets = ActiveRockets;
+            const size_t count = rockets.Size();
+            if (count == 0) return true;
+
+            interceptMask.resize(count);
+            SweptBeam beam = MainRadar.GetSweptBeam(deltaTime);
+            size_t hits = 0;
+            bool destroyed = false;
+            {
+                RADAR_PROFILE_SCOPE(Profiler, RocketMove);
+                for (size_t i = count; i-- > 0; )
+                {
+                    Vec2 from = rockets.Position(i);
+                    Vec2 to(from.X + rockets.VX[i] * deltaTime, from.Y + rockets.VY[i] * deltaTime);
+                    rockets.X[i] = to.X;
+                    rockets.Y[i] = to.Y;
+
+                    // Грубый отсев: расстояние от радара в конце шага минус пройденный путь больше дальности луча
+                    float travel = rockets.Speed[i] * deltaTime;
+                    float reach = beam.RangeR + travel;
+                    float hitTime = 0.0f;
+                    uint8_t hit = 0;
+                    if (DistanceSquared(to, beam.Center) <= reach * reach && SweptBeamHit(beam, from, to, hitTime)) hit = 1;
+
+                    // Ядро: решает, что случилось раньше - вход в ядро или перехват
+                    float entryTime;
+                    if (EnteredCore(i, deltaTime, entryTime) && !(hit && hitTime <= entryTime))
+                    {
+                        hit = 0;
+                        destroyed = true;
+                    }
+                    interceptMask[i] = hit;
+                    hits += hit;
+                }
+            }
+            RocketsInterceptedCount += (int)hits;
+
+            if (destroyed)
+            {
+                MainRadar.IsDestroyed = true;
+                GameOver = true;
+                Result = Outcome::RadarDestroyed;
+                return false;
+            }
+
+            RemoveIntercepted(hits);
+            return true;
+        }
+
+        // То же, что MoveRocketsAndIntercept, но луч и ядро проверяют только ракеты из своих корзин индекса.
+        // Проверки те же самые, поэтому итог совпадает с полным перебором
+        bool MoveIndexedAndIntercept(float deltaTime)
+        {
+            RocketStore& rockets = ActiveRockets;
+            const size_t count = rockets.Size();
+            if (count == 0) return true;
+
+            float* x = rockets.X.data();
+            float* y = rockets.Y.data();
+            {
+                RADAR_PROFILE_SCOPE(Profiler, RocketMove);
+                rocketIndex.MoveAndRefresh(x, y, rockets.VX.data(), rockets.VY.data(), count, deltaTime);
+            }
+            size_t kept = 0;
+            {
+                RADAR_PROFILE_SCOPE(Profiler, Interception);
+                // Попадание в ядро: как и при полном переборе, засчитываются перехваты только ракет
+                // с номерами после последней долетевшей
+                size_t firstChecked = 0;
+                float entryTime;
+                candidates.clear();
+                rocketIndex.GatherDisk(MainRadar.CoreVulnerabilityRadius + rocketIndex.MaxSpeed() * deltaTime, candidates);
+                for (uint32_t i : candidates)
+                {
+                    if (i >= firstChecked && EnteredCore(i, deltaTime, entryTime))
+                    {
+                        MainRadar.IsDestroyed = true;
+                        GameOver = true;
+                        Result = Outcome::RadarDestroyed;
+                        firstChecked = i + 1;
+                    }
+                }
+
+                // Луч: кандидаты из покрытых секторов собираются подряд и проверяются тем же DetectBatch
+                float halfWidth = MainRadar.BeamWidthDegrees / 2.0f;
+                candidates.clear();
+                rocketIndex.GatherWedge(MainRadar.AngleDegrees() - halfWidth, MainRadar.AngleDegrees() + halfWidth,
+                    MainRadar.DeadZoneRadius, MainRadar.BeamEffectiveRadiusR, candidates);
+                candidateX.clear();
+                candidateY.clear();
+                for (uint32_t i : candidates)
+                {
+                    if (i < firstChecked) continue;
+                    candidates[kept++] = i;
+                    candidateX.push_back(x[i]);
+                    candidateY.push_back(y[i]);
+                }
+                interceptMask.resize(kept);
+                size_t hits = DetectBatch(MainRadar.GetBeamSector(), candidateX.data(), candidateY.data(), kept, interceptMask.data());
+                RocketsInterceptedCount += (int)hits;
+            }
+            if (GameOver) return false;
+
+            hitIndices.clear();
+            for (size_t k = 0; k < kept; k++)
+            {
+                if (interceptMask[k]) hitIndices.push_back(candidates[k]);
+            }
+            RemoveIndexed();
+            return true;
+        }
+
+        // То же, что SweepRocketsAndIntercept, но с индексом. Кандидаты собираются до движения:
+        // перехваченная за шаг ракета была в луче в точке не дальше пройденного пути от начала шага,
+        // поэтому клин расширяется на этот путь по дальности и по углу
+        bool SweepIndexedAndIntercept(float deltaTime)
+        {
+            RocketStore& rockets = ActiveRockets;
+            const size_t count = rockets.Size();
+            if (count == 0) return true;
+
+            // Движение и перехват здесь неразделимы: кандидаты собираются до движения, проверяются после
+            {
+                RADAR_PROFILE_SCOPE(Profiler, RocketMove);
+                SweptBeam beam = MainRadar.GetSweptBeam(deltaTime);
+                float travel = rocketIndex.MaxSpeed() * deltaTime;
+                float from = std::min(beam.StartAngleDegrees, beam.StartAngleDegrees + beam.SweepDegrees);
+                float to = std::max(beam.StartAngleDegrees, beam.StartAngleDegrees + beam.SweepDegrees);
+                // Угловой запас: из точки дальше мертвой зоны смещение на travel видно под углом не больше asin(travel / DeadZone)
+                float margin = travel < beam.DeadZoneRadius ? std::asin(travel / beam.DeadZoneRadius) * 180.0f / (float)M_PI : 180.0f;
+                from -= beam.HalfWidthDegrees + margin;
+                to += beam.HalfWidthDegrees + margin;
+
+                candidates.clear();
+                rocketIndex.GatherWedge(from, to, beam.DeadZoneRadius - travel, beam.RangeR + travel, candidates);
+                candidateX.clear();
+                candidateY.clear();
+                for (uint32_t i : candidates)
+                {
+                    candidateX.push_back(rockets.X[i]);
+                    candidateY.push_back(rockets.Y[i]);
+                }
+
+                float* x = rockets.X.data();
+                float* y = rockets.Y.data();
+                rocketIndex.MoveAndRefresh(x, y, rockets.VX.data(), rockets.VY.data(), count, deltaTime);
+
+                hitIndices.clear();
+                hitTimes.clear();
+                for (size_t k = 0; k < candidates.size(); k++)
+                {
+                    uint32_t i = candidates[k];
+                    float hitTime = 0.0f;
+                    if (SweptBeamHit(beam, Vec2(candidateX[k], candidateY[k]), rockets.Position(i), hitTime))
+                    {
+                        hitIndices.push_back(i);
+                        hitTimes.push_back(hitTime);
+                    }
+                }
+                RocketsInterceptedCount += (int)hitIndices.size();
+
+                // Ядро: вошедшая в него раньше перехвата ракета не перехвачена, а радар уничтожен
+                bool destroyed = false;
+                candidates.clear();
+                rocketIndex.GatherDisk(MainRadar.CoreVulnerabilityRadius + travel, candidates);
+                for (uint32_t i : candidates)
+                {
+                    float entryTime;
+                    if (!EnteredCore(i, deltaTime, entryTime)) continue;
+                    size_t k = (size_t)(std::find(hitIndices.begin(), hitIndices.end(), i) - hitIndices.begin());
+                    bool hit = k < hitIndices.size();
+                    if (hit && hitTimes[k] <= entryTime) continue;
+                    if (hit) RocketsInterceptedCount--;
+                    destroyed = true;
+                }
+                if (destroyed)
+                {
+                    MainRadar.IsDestroyed = true;
+                    GameOver = true;
+                    Result = Outcome::RadarDestroyed;
+                    return false;
+                }
+            }
+
+            RemoveIndexed();
+            return true;
+        }
+
+        // Параметры радара сети из radar_site; незаданные (NaN) берутся у главного радара
+        void ApplySiteParameters(Radar& radar, const RadarSite& site) const
+        {
+            float range = std::isnan(site.MaxDetectionRangeP) ? Config.RadarMaxDetectionRangeP : site.MaxDetectionRangeP;
+            radar.RotationSpeedDps = std::isnan(site.RotationSpeedDps) ? Config.RadarRotationSpeedDps : site.RotationSpeedDps;
+            radar.BeamWidthDegrees = std::isnan(site.BeamWidthDegrees) ? Config.RadarBeamWidthDegrees : site.BeamWidthDegrees;
+            radar.MaxDetectionRangeP = range;
+            radar.BeamEffectiveRadiusR = range / 1.5f;
+            radar.CircularAttackRange = Config.RadarCircularAttackRange;
+            radar.CoreVulnerabilityRadius = Config.RadarCoreVulnerabilityRadius;
+            radar.DeadZoneRadius = Config.RadarDeadZoneRadius;
+        }
+
+        // Резерв пула ракет на всю партию: ракет в полете не бывает больше, чем всего запусков.
+        // Для огромных партий резерв ограничен, дальше массивы растут как обычно
+        static const size_t MaxPooledRockets = 1 << 20;
+
+        void ReserveRocketPool()
+        {
+            size_t capacity = std::min((size_t)std::max(Config.TotalRocketsToLaunch, 0), MaxPooledRockets);
+            ActiveRockets.Reserve(capacity);
+            interceptMask.reserve(capacity);
+            if (bucketIndexActive)
+            {
+                rocketIndex.Reserve(capacity);
+                candidates.reserve(capacity);
+                candidateX.reserve(capacity);
+                candidateY.reserve(capacity);
+                hitIndices.reserve(capacity);
+                hitTimes.reserve(capacity);
+            }
+        }
+
+        // Совпадают ли списки radar_site (NaN - "как у главного" - равен NaN)
+        static bool SameSites(const std::vector<RadarSite>& a, const std::vector<RadarSite>& b)
+        {
+            auto same = [](float x, float y) { return x == y || (std::isnan(x) && std::isnan(y)); };
+            if (a.size() != b.size()) return false;
+            for (size_t k = 0; k < a.size(); k++)
+            {
+                if (!same(a[k].X, b[k].X) || !same(a[k].Y, b[k].Y) || !same(a[k].RotationSpeedDps, b[k].RotationSpeedDps)
+                    || !same(a[k].BeamWidthDegrees, b[k].BeamWidthDegrees) || !same(a[k].MaxDetectionRangeP, b[k].MaxDetectionRangeP)
+                    || !same(a[k].StartAngleDegrees, b[k].StartAngleDegrees)) return false;
+            }
+            return true;
+        }
+
+        void BuildRadarGrid()
+        {
+            std::vector<Vec2> positions;
+            std::vector<float> reach;
+            gridSlack = 0.0f;
+            for (size_t k = 0; k <= SupportRadars.size(); k++)
+            {
+                const Radar& radar = NetworkRadar(k);
+                // Ячейка должна покрывать и луч, и ядро
+                float range = std::max(radar.MaxDetectionRangeP, std::max(radar.BeamEffectiveRadiusR, radar.CoreVulnerabilityRadius));
+                positions.push_back(radar.Position);
+                reach.push_back(range);
+                float slack = range - std::max(radar.BeamEffectiveRadiusR, radar.CoreVulnerabilityRadius);
+                gridSlack = k == 0 ? slack : std::min(gridSlack, slack);
+            }
+            radarGrid.Build(positions, reach);
+        }
+
+        // Движение и перехват в сети радаров. Каждая ракета проверяется только радарами своей ячейки сетки:
+        // сначала попадание в ядро, затем луч, до первого срабатывания. Долетевшая до ядра дополнительного
+        // радара ракета выводит его из строя и гибнет сама; игра проиграна, только если уничтожен главный радар.
+        // Возвращает false, если главный радар уничтожен и игра окончена
+        bool MoveNetworkAndIntercept(float deltaTime)
+        {
+            RocketStore& rockets = ActiveRockets;
+            const size_t count = rockets.Size();
+            if (count == 0) return true;
+
+            const size_t radarCount = SupportRadars.size() + 1;
+            const bool swept = Config.RadarSweptBeam;
+            networkBeams.resize(radarCount);
+            networkSweeps.resize(radarCount);
+            for (size_t k = 0; k < radarCount; k++)
+            {
+                const Radar& radar = NetworkRadar(k);
+                if (swept) networkSweeps[k] = radar.GetSweptBeam(deltaTime);
+                else networkBeams[k] = radar.GetBeamSector();
+            }
+
+            // Ядра проверяются по всему отрезку шага: если ракета за шаг может уйти дальше запаса ячейки,
+            // проверка идет по всем радарам
+            bool useGrid = gridSlack >= MaxRocketTravel(deltaTime);
+            if (!useGrid)
+            {
+                allRadars.resize(radarCount);
+                for (size_t k = 0; k < radarCount; k++) allRadars[k] = (uint32_t)k;
+            }
+
+            interceptMask.resize(count);
+            size_t removed = 0;
+            bool mainDestroyed = false;
+            {
+                RADAR_PROFILE_SCOPE(Profiler, RocketMove);
+                for (size_t i = 0; i < count; i++)
+                {
+                    Vec2 from = rockets.Position(i);
+                    Vec2 to(from.X + rockets.VX[i] * deltaTime, from.Y + rockets.VY[i] * deltaTime);
+                    rockets.X[i] = to.X;
+                    rockets.Y[i] = to.Y;
+
+                    RadarGrid::Span span = useGrid ? radarGrid.At(to.X, to.Y) : RadarGrid::Span{ allRadars.data(), allRadars.data() + allRadars.size() };
+                    // Судьбу ракеты решает самое раннее событие шага: вход в ядро какого-нибудь радара или перехват
+                    // (без непрерывной проверки луч смотрит только в конце шага). При равенстве ядро раньше луча
+                    const float travel = rockets.Speed[i] * deltaTime;
+                    float firstTime = 2.0f;
+                    uint8_t gone = 0;
+                    uint32_t goneRadar = 0;
+                    for (const uint32_t* k = span.Begin; k != span.End; k++)
+                    {
+                        const Radar& radar = NetworkRadar(*k);
+                        if (radar.IsDestroyed) continue;
+
+                        float reach = radar.CoreVulnerabilityRadius + travel;
+                        float entryTime;
+                        if (DistanceSquared(to, radar.Position) <= reach * reach
+                            && CoreEntry(radar.Position, radar.CoreVulnerabilityRadius, from, to, entryTime) && entryTime < firstTime)
+                        {
+                            firstTime = entryTime;
+                            gone = 2; // Погибла на ядре (1 - перехвачена)
+                            goneRadar = *k;
+                        }
+
+                        float hitTime = 1.0f;
+                        bool hit = swept ? SweptBeamHit(networkSweeps[*k], from, to, hitTime) : BeamSectorContains(networkBeams[*k], to.X, to.Y);
+                        if (hit && hitTime < firstTime)
+                        {
+                            firstTime = hitTime;
+                            gone = 1;
+                        }
+                    }
+                    if (gone == 1) RocketsInterceptedCount++;
+                    if (gone == 2)
+                    {
+                        NetworkRadar(goneRadar).IsDestroyed = true;
+                        if (goneRadar == 0) mainDestroyed = true;
+                    }
+                    interceptMask[i] = gone;
+                    removed += gone;
+                }
+            }
+
+            if (mainDestroyed)
+            {
+                GameOver = true;
+                Result = Outcome::RadarDestroyed;
+                return false;
+            }
+
+            RemoveIntercepted(removed);
+            return true;
+        }
+
+        // Вошла ли за последний шаг какая-нибудь ракета в зону обнаружения радара сети: в конце шага она в зоне,
+        // а в начале (позиция минус скорость на шаг) была вне ее. Ракета, запущенная на этом шаге
+        // (номер не меньше firstNewId), считается вошедшей, если оказалась в зоне сразу
+        bool RocketEnteredDetection(float deltaTime, uint32_t firstNewId) const
+        {
+            const RocketStore& rockets = ActiveRockets;
+            const size_t count = rockets.Size();
+            const float* x = rockets.X.data();
+            const float* y = rockets.Y.data();
+            const float* vx = rockets.VX.data();
+            const float* vy = rockets.VY.data();
+            const uint32_t* id = rockets.Id.data();
+            for (size_t k = 0; k <= SupportRadars.size(); k++)
+            {
+                const Radar& radar = k == 0 ? MainRadar : SupportRadars[k - 1];
+                if (radar.IsDestroyed) continue;
+                const float cx = radar.Position.X, cy = radar.Position.Y;
+                const float rangeSq = radar.MaxDetectionRangeP * radar.MaxDetectionRangeP;
+                size_t entered = 0;
+                for (size_t i = 0; i < count; i++)
+                {
+                    float px = x[i] - cx, py = y[i] - cy;
+                    float qx = px - vx[i] * deltaTime, qy = py - vy[i] * deltaTime;
+                    bool inside = px * px + py * py <= rangeSq;
+                    bool wasOutside = qx * qx + qy * qy > rangeSq || id[i] >= firstNewId;
+                    entered += inside && wasOutside ? 1 : 0;
+                }
+                if (entered > 0) return true;
+            }
+            return false;
+        }
+
+        // Наибольший путь ракеты за шаг
+        float MaxRocketTravel(float deltaTime) const
+        {
+            float speed = 0.0f;
+            for (float s : ActiveRockets.Speed) speed = std::max(speed, s);
+            return speed * deltaTime;
+        }
+
+        // Удаление ракет из hitIndices из хранилища и индекса. Номера идут по убыванию,
+        // поэтому переставляемая на место удаляемой последняя ракета не перехвачена
+        void RemoveIndexed()
+        {
+            RADAR_PROFILE_SCOPE(Profiler, Compaction);
+            std::sort(hitIndices.begin(), hitIndices.end());
+            for (size_t k = hitIndices.size(); k-- > 0; )
+            {
+                if (RecordEvents) RecordRemoval(hitIndices[k], SimEvent::Intercept);
+                rocketIndex.SwapRemove(hitIndices[k]);
+                ActiveRockets.SwapRemove(hitIndices[k]);
+            }
+        }
+
+        // Удаление ракет, отмеченных в interceptMask (перехваченных или погибших), перестановкой последней ракеты на их место.
+        // Идем с конца, поэтому переставленная ракета уже проверена
+        void RemoveIntercepted(size_t hits)
+        {
+            RADAR_PROFILE_SCOPE(Profiler, Compaction);
+            for (size_t i = ActiveRockets.Size(); hits > 0 && i-- > 0; )
+            {
+                if (interceptMask[i])
+                {
+                    if (RecordEvents) RecordRemoval(i, interceptMask[i] == 2 ? SimEvent::Lost : SimEvent::Intercept);
+                    ActiveRockets.SwapRemove(i);
+                    hits--;
+                }
+            }
+        }
+
+        // Удаление ракет, которые летят дольше rocket_max_flight_sec (самоуничтожение), как в RemoveIntercepted
+        void RemoveExpired()
+        {
+            RADAR_PROFILE_SCOPE(Profiler, Compaction);
+            const float limit = trajectory.MaxFlightSec();
+            for (size_t i = ActiveRockets.Size(); i-- > 0; )
+            {
+                if (ActiveRockets.Age[i] > limit)
+                {
+                    if (RecordEvents) RecordRemoval(i, SimEvent::Lost);
+                    if (bucketIndexActive) rocketIndex.SwapRemove((uint32_t)i);
+                    ActiveRockets.SwapRemove(i);
+                }
+            }
+        }
+
+        // Вошла ли ракета i (уже сдвинутая на шаг) в ядро главного радара за этот шаг; entryTime - доля шага.
+        // Начало отрезка - конец минус скорость на шаг, как в RocketEnteredDetection: полный перебор и индекс
+        // считают его одинаково
+        bool EnteredCore(size_t i, float deltaTime, float& entryTime) const
+        {
+            const RocketStore& rockets = ActiveRockets;
+            Vec2 to = rockets.Position(i);
+            float reach = MainRadar.CoreVulnerabilityRadius + rockets.Speed[i] * deltaTime;
+            if (DistanceSquared(to, MainRadar.Position) > reach * reach) return false;
+            Vec2 from(to.X - rockets.VX[i] * deltaTime, to.Y - rockets.VY[i] * deltaTime);
+            return CoreEntry(MainRadar.Position, MainRadar.CoreVulnerabilityRadius, from, to, entryTime);
+        }
+
+        void RecordRemoval(size_t i, SimEvent::Kind kind)
+        {
+            const RocketStore& rockets = ActiveRockets;
+            Events.push_back(SimEvent{ kind, rockets.Id[i], rockets.X[i], rockets.Y[i], rockets.VX[i], rockets.VY[i] });
+        }
+
+        void UpdateLaunchSchedule(float deltaTime)
+        {
+            // Общий таймер отсчитывает и ниже нуля: насколько он ушел ниже нуля, настолько раньше конца шага
+            // запуск уже разрешен. Поэтому запуск не откладывается на следующий шаг, а при большом шаге
+            // (swept-проверка с --dt 0.5..1) в один шаг может уложиться несколько запусков
+            timeUntilNextPossibleLaunchSec -= deltaTime;
+
+            float previousFlownSec = std::numeric_limits<float>::infinity();
+            while (timeUntilNextPossibleLaunchSec <= 0 && RocketsLaunchedCount < Config.TotalRocketsToLaunch)
+            {
+                // Стрелять может только установка, чья очередь, и только если она перезарядилась
+                if (!launchTimers.Ready(nextLauncherIndex, TickCount)) return;
+
+                // Ракета стартует, когда готовы и общий таймер, и установка (что позже), и к концу шага уже летит flownSec
+                float flownSec = std::min(-timeUntilNextPossibleLaunchSec, launchTimers.OvershootSec(nextLauncherIndex, TickCount));
+                flownSec = std::min(std::max(flownSec, 0.0f), deltaTime);
+
+                // Еще один запуск в этом шаге - только строго позже предыдущего. При нулевых интервалах и перезарядке
+                // (или старте, прижатом к началу шага) время не движется: дальше - по запуску за шаг, как до переноса
+                if (!(flownSec < previousFlownSec)) return;
+                previousFlownSec = flownSec;
+
+                Launcher& currentLauncher = Launchers[nextLauncherIndex];
+                LaunchRocket(currentLauncher.Fire(MainRadar.Position, trajectory.LaunchSpeed()), deltaTime - flownSec);
+                // Перезарядка установки и общая задержка до следующего ВОЗМОЖНОГО запуска - от момента старта
+                launchTimers.Schedule(nextLauncherIndex, currentLauncher.TimeToNextLaunchSec - flownSec, TickCount);
+                timeUntilNextPossibleLaunchSec = launchRandom.NextRange(Config.LaunchIntervalMinSec, Config.LaunchIntervalMaxSec) - flownSec;
+
+                // Переходим к следующей установке по кругу
+                nextLauncherIndex = (nextLauncherIndex + 1) % (int)Launchers.size();
+            }
+        }
+
+        // Запуск ракеты: курс по модели полета, ракета - в хранилище. lateSec - на сколько ракета стартовала позже
+        // начала шага: она ставится на lateSec полета назад, и движение этого шага доводит ее туда,
+        // где она и должна быть к концу шага (время полета при маневрах - так же)
+        void LaunchRocket(Rocket rocket, float lateSec = 0.0f)
+        {
+            Vec2 heading = trajectory.Launch(rocket, MainRadar.Position, headingRandom.At(ActiveRockets.NextId));
+            rocket.Position = Vec2(rocket.Position.X - rocket.Velocity.X * lateSec, rocket.Position.Y - rocket.Velocity.Y * lateSec);
+            AddRocket(rocket);
+            ActiveRockets.DirX.back() = heading.X;
+            ActiveRockets.DirY.back() = heading.Y;
+            if (!trajectory.Straight()) ActiveRockets.Age.back() = -lateSec;
+            RocketsLaunchedCount++;
+        }
+
+        // Выстрелы залпов сценария, время которых наступило, и установок из обстрелов, которые перезарядились.
+        // Залпы читаются из файла по ходу партии, установки обстрелов ждут в очереди по времени готовности
+        void UpdateScenarioLaunches()
+        {
+            auto fire = [&](uint32_t launcher, float speed)
+            {
+                // Файл мог вырасти после проверки: ракет не больше, чем насчитала сводка
+                if (RocketsLaunchedCount >= Config.TotalRocketsToLaunch) return;
+                LaunchRocket(Rocket(Launchers[launcher].Position, MainRadar.Position, speed > 0.0f ? speed : trajectory.LaunchSpeed()));
+            };
+            scenario.Advance(ElapsedSec, fire, [&](const ScenarioSalvo& barrage)
+            {
+                for (uint32_t k = barrage.First; k <= barrage.Last; k++) launchQueue.Add(k, barrage.Rockets, barrage.Speed, barrage.TimeSec);
+            });
+            launchQueue.Advance(ElapsedSec, [&](uint32_t launcher, float speed)
+            {
+                fire(launcher, speed);
+                Launchers[launcher].ResetLaunchTimer();
+                return Launchers[launcher].TimeToNextLaunchSec;
+            });
+            // ...или укоротиться: тогда партия кончается на последнем прочитанном залпе
+            if (scenario.Finished() && launchQueue.Empty()) Config.TotalRocketsToLaunch = RocketsLaunchedCount;
+        }
+    };
+}
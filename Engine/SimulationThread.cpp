@@ -0,0 +1,315 @@
+// Поток симуляции и тройной буфер снимков для окна
+#include "SimulationThread.h"
+#include "ConfigWatcher.h"
+#include "FixedStepClock.h"
+#include "Replay.h"
+#include "StateStream.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace sim
+{
+    namespace
+    {
+        // Состояние обменного буфера: номер буфера в младших битах и флаг "свежий снимок"
+        const uint32_t SlotMask = 3;
+        const uint32_t FreshFlag = 4;
+        // Как часто пересчитывать итог замеров фаз для окна
+        const double ProfileRefreshSec = 0.25;
+        // Шагов перемотки между проверками часов, отмены и правок settings.txt
+        const int WarpChunkTicks = 256;
+
+        std::chrono::steady_clock::time_point ClockOrigin()
+        {
+            static const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+            return origin;
+        }
+    }
+
+    struct SimulationThread::Impl
+    {
+        Simulation Game;                // Партия (меняется только в потоке симуляции)
+        SimSnapshot Slots[3];
+        std::atomic<uint32_t> Middle;   // Обменный буфер (и флаг свежести)
+        uint32_t Back;                  // Буфер писателя (только поток симуляции)
+        uint32_t Front;                 // Буфер читателя (только окно)
+        std::atomic<bool> StopRequested;
+        std::thread Worker;
+        ReplayRecorder Recorder;        // Запись партии при record_replay в settings.txt
+        bool Recording = false;
+        StateServer Stream;             // Раздача состояния зрителям при stream_address в settings.txt
+        size_t StreamBufferBytes = 0;   // Под какую партию подобран буфер сервера
+
+        // Правки файла настроек: разбираются в потоке ConfigWatcher, применяются здесь между шагами
+        ConfigWatcher Watcher;
+        ConfigData Update;              // Рабочая копия для TakeUpdate
+        std::mutex MessageLock;         // Сообщение о применении правки для окна
+        std::string Message;
+        std::atomic<bool> MessageReady;
+        uint64_t RejectedSeen = 0;      // Сколько отказов ConfigWatcher окно уже показало
+
+        // Перемотка: запрос окна под WarpLock, номер запроса меняется при каждом запросе и отмене
+        std::mutex WarpLock;
+        WarpGoal RequestedWarp;
+        bool WarpRequested = false;
+        std::atomic<uint32_t> WarpSerial;
+        uint32_t WarpSeen = 0;          // Последний обработанный номер запроса (только поток симуляции)
+        bool Warping = false;
+
+        // Замеры фаз шага: гистограммы пишет только этот поток, окну уходит готовый итог в снимке
+        TickProfiler Profiler;
+        ProfileSummary ProfileState;
+        double ProfileSummarizedSec = 0.0;
+
+        Impl() : Middle(1), Back(2), Front(0), StopRequested(false), MessageReady(false), WarpSerial(0) {}
+
+        // Применение правки к партии. Длина шага могла измениться (sim_rate_hz) - тогда часы начинают отсчет заново
+        bool ApplyUpdate(FixedStepClock& clock)
+        {
+            // Шаг записи партии задан в заголовке файла и меняться не может, а запись поддерживает только прямой полет
+            if (Recording)
+            {
+                Update.SimRateHz = Game.Config.SimRateHz;
+                Update.RocketModel = Game.Config.RocketModel;
+            }
+            std::string keys;
+            if (Game.ApplyConfig(Update, &keys) == 0) return false;
+            if (clock.StepSec != Game.FixedStepSec()) clock.Reset(Game.FixedStepSec(), clock.MaxCatchUpSec);
+            std::lock_guard<std::mutex> lock(MessageLock);
+            Message = "применено: " + keys;
+            MessageReady.store(true, std::memory_order_release);
+            return true;
+        }
+
+        // Снимок текущего состояния в буфер писателя и обмен с обменным буфером
+        void Publish(double stepSec, float alpha)
+        {
+            RADAR_PROFILE_SCOPE(&Profiler, Publish);
+            SimSnapshot& snapshot = Slots[Back];
+            snapshot.CaptureFrom(Game);
+            double nowSec = SimulationThread::NowSec();
+#if RADAR_PROFILE
+            // Квантили пересчитываются несколько раз в секунду, а не при каждой публикации
+            if (nowSec - ProfileSummarizedSec >= ProfileRefreshSec)
+            {
+                Profiler.Summarize(ProfileState);
+                ProfileSummarizedSec = nowSec;
+            }
+            snapshot.Profile = ProfileState;
+#endif
+            snapshot.StepSec = stepSec;
+            snapshot.AlphaAtPublish = alpha;
+            snapshot.Warping = Warping;
+            snapshot.WarpSerial = WarpSeen;
+            snapshot.PublishedAtSec = nowSec;
+            Back = Middle.exchange(Back | FreshFlag, std::memory_order_acq_rel) & SlotMask;
+        }
+
+        void Run()
+        {
+            FixedStepClock clock(Game.FixedStepSec(), 0.5);
+            double lastSec = SimulationThread::NowSec();
+            while (!StopRequested.load(std::memory_order_relaxed) && !Game.GameOver)
+            {
+                // Граница шага: правка применяется целиком, и окно сразу получает снимок с ней
+                if (Watcher.TakeUpdate(Update) && ApplyUpdate(clock)) Publish(clock.StepSec, clock.Alpha());
+
+                // Запрос перемотки: после нее отсчет реального времени начинается заново
+                uint32_t serial = WarpSerial.load(std::memory_order_acquire);
+                if (serial != WarpSeen)
+                {
+                    WarpSeen = serial;
+                    WarpGoal goal;
+                    bool requested;
+                    {
+                        std::lock_guard<std::mutex> lock(WarpLock);
+                        requested = WarpRequested;
+                        goal = RequestedWarp;
+                        WarpRequested = false;
+                    }
+                    if (requested) RunWarp(goal, serial, clock);
+                    lastSec = SimulationThread::NowSec();
+                    continue;
+                }
+
+                double nowSec = SimulationThread::NowSec();
+                int steps = clock.Advance(nowSec - lastSec);
+                lastSec = nowSec;
+                for (int i = 0; i < steps && !Game.GameOver; i++)
+                {
+                    Game.Step((float)clock.StepSec);
+                    if (Recording) Recorder.Record(Game);
+                    Stream.Publish(Game, (float)clock.StepSec);
+                }
+                if (steps > 0) Publish(clock.StepSec, clock.Alpha());
+
+                // Ждем до момента, когда накопится следующий шаг
+                double waitSec = (1.0 - clock.Alpha()) * clock.StepSec;
+                std::this_thread::sleep_for(std::chrono::duration<double>(waitSec));
+            }
+
+            // Партия окончена или остановлена: запись дописывается здесь же, в потоке симуляции
+            if (Recording) Recorder.Close(Game);
+            Recording = false;
+        }
+
+        // Перемотка до цели: шаги порциями без сна, снимок - не чаще кадров окна. Останавливается на цели,
+        // в конце партии, при остановке потока и при новом запросе или отмене (номер запроса сменился)
+        void RunWarp(const WarpGoal& goal, uint32_t serial, FixedStepClock& clock)
+        {
+            Warping = true;
+            const double publishEverySec = Game.Config.RenderRateHz > 0.0f ? 1.0 / Game.Config.RenderRateHz : 1.0 / 30.0;
+            double publishedSec = SimulationThread::NowSec();
+            bool reached = goal.Target == WarpGoal::Tick && Game.TickCount >= goal.TargetTick;
+            while (!reached && !Game.GameOver && !StopRequested.load(std::memory_order_relaxed)
+                && WarpSerial.load(std::memory_order_relaxed) == serial)
+            {
+                if (Watcher.TakeUpdate(Update)) ApplyUpdate(clock);
+                for (int i = 0; i < WarpChunkTicks && !reached && !Game.GameOver; i++)
+                {
+                    reached = Game.WarpStep(goal, (float)clock.StepSec);
+                    if (Recording) Recorder.Record(Game);
+                }
+                double nowSec = SimulationThread::NowSec();
+                if (nowSec - publishedSec >= publishEverySec)
+                {
+                    // Зрителям - тоже с частотой кадров: сообщение несет разницу с прошлым, а не с прошлым шагом
+                    Stream.Publish(Game, (float)clock.StepSec);
+                    Publish(clock.StepSec, 1.0f);
+                    publishedSec = nowSec;
+                }
+            }
+            Warping = false;
+            Stream.Publish(Game, (float)clock.StepSec);
+            clock.Reset(clock.StepSec, clock.MaxCatchUpSec);
+            Publish(clock.StepSec, clock.Alpha());
+        }
+    };
+
+    SimulationThread::SimulationThread() : impl(new Impl()) {}
+
+    SimulationThread::~SimulationThread()
+    {
+        Stop();
+        delete impl;
+    }
+
+    void SimulationThread::Start(const ConfigData& config, const std::string& watchPath)
+    {
+        Stop();
+        // Слежение переживает перезапуск партии; правка, пришедшая между партиями, уже прочитана в config
+        if (watchPath.empty()) impl->Watcher.Stop();
+        else if (!impl->Watcher.Watching() || impl->Watcher.Path() != watchPath)
+        {
+            impl->Watcher.Start(watchPath);
+            impl->RejectedSeen = 0;
+        }
+        impl->Watcher.TakeUpdate(impl->Update);
+
+        impl->Game.Reset(config);
+        impl->Game.Profiler = &impl->Profiler;
+        {
+            // Перемотка, запрошенная до перезапуска, к новой партии не относится
+            std::lock_guard<std::mutex> lock(impl->WarpLock);
+            impl->WarpRequested = false;
+            impl->WarpSeen = impl->WarpSerial.load(std::memory_order_relaxed);
+            impl->Warping = false;
+        }
+        impl->Profiler.Reset();
+        impl->ProfileState.Clear();
+        impl->Recording = !config.RecordReplayPath.empty()
+            && impl->Recorder.Open(config.RecordReplayPath, impl->Game, impl->Game.FixedStepSec(), 0);
+
+        // Сервер потока состояния переживает перезапуск партии, и зрители остаются подключены; он открывается
+        // заново, только если сменился адрес или новой партии нужен буфер больше
+        size_t streamBytes = StateServer::BufferBytesFor(impl->Game);
+        if (config.StreamAddress.empty()) impl->Stream.Stop();
+        else if (!impl->Stream.Running() || impl->Stream.Address() != config.StreamAddress || streamBytes > impl->StreamBufferBytes)
+        {
+            std::string error;
+            impl->StreamBufferBytes = streamBytes;
+            if (!impl->Stream.Start(config.StreamAddress, streamBytes, &error))
+            {
+                std::lock_guard<std::mutex> lock(impl->MessageLock);
+                impl->Message = "stream_address: " + error;
+                impl->MessageReady.store(true, std::memory_order_release);
+            }
+        }
+        impl->Stream.Restart();
+        impl->Stream.Publish(impl->Game, (float)impl->Game.FixedStepSec());
+
+        // Все три буфера получают начальное состояние: окно видит его до первого шага.
+        // Ракеты в снимке резервируются по пулу партии, чтобы публикация в ходе боя не выделяла память
+        double stepSec = impl->Game.FixedStepSec();
+        for (SimSnapshot& snapshot : impl->Slots)
+        {
+            snapshot.Rockets.Reserve(impl->Game.ActiveRockets.Capacity());
+            snapshot.CaptureFrom(impl->Game);
+            snapshot.Profile.Clear();
+            snapshot.StepSec = stepSec;
+            snapshot.AlphaAtPublish = 0.0f;
+            snapshot.PublishedAtSec = NowSec();
+            snapshot.Warping = false;
+            snapshot.WarpSerial = impl->WarpSeen;
+        }
+        impl->Front = 0;
+        impl->Middle.store(1, std::memory_order_relaxed);
+        impl->Back = 2;
+
+        impl->StopRequested.store(false, std::memory_order_relaxed);
+        impl->Worker = std::thread([this]() { impl->Run(); });
+    }
+
+    void SimulationThread::Stop()
+    {
+        if (!impl->Worker.joinable()) return;
+        impl->StopRequested.store(true, std::memory_order_relaxed);
+        impl->Worker.join();
+    }
+
+    const SimSnapshot& SimulationThread::AcquireSnapshot()
+    {
+        if (impl->Middle.load(std::memory_order_relaxed) & FreshFlag)
+        {
+            impl->Front = impl->Middle.exchange(impl->Front, std::memory_order_acq_rel) & SlotMask;
+        }
+        return impl->Slots[impl->Front];
+    }
+
+    uint32_t SimulationThread::Warp(const WarpGoal& goal)
+    {
+        std::lock_guard<std::mutex> lock(impl->WarpLock);
+        impl->RequestedWarp = goal;
+        impl->WarpRequested = true;
+        return impl->WarpSerial.fetch_add(1, std::memory_order_release) + 1;
+    }
+
+    void SimulationThread::CancelWarp()
+    {
+        std::lock_guard<std::mutex> lock(impl->WarpLock);
+        impl->WarpRequested = false;
+        impl->WarpSerial.fetch_add(1, std::memory_order_release);
+    }
+
+    std::string SimulationThread::TakeConfigMessage()
+    {
+        uint64_t rejected = impl->Watcher.Rejected();
+        if (rejected != impl->RejectedSeen)
+        {
+            impl->RejectedSeen = rejected;
+            return "ошибка: " + impl->Watcher.LastError();
+        }
+        if (!impl->MessageReady.load(std::memory_order_acquire)) return std::string();
+        std::lock_guard<std::mutex> lock(impl->MessageLock);
+        impl->MessageReady.store(false, std::memory_order_relaxed);
+        return impl->Message;
+    }
+
+    double SimulationThread::NowSec()
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - ClockOrigin()).count();
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "SimSnapshot.h"
+#include <string>
+
+namespace sim
+{
+    // Симуляция в отдельном потоке с передачей снимков окну через тройной буфер.
+    // Поток сам отмеряет фиксированные шаги по реальному времени и после каждой порции шагов
+    // публикует снимок состояния. Окно забирает последний опубликованный снимок без блокировок:
+    // у писателя и читателя по своему буферу, третий - обменный, буферы меняются одной атомарной операцией.
+    // Перетаскивание окна, модальные окна и медленная отрисовка больше не останавливают симуляцию.
+    // Потоки и атомарные переменные спрятаны в SimulationThread.cpp (нативный файл):
+    // заголовок подключается из C++/CLI, где <thread> и <atomic> недоступны
+    class SimulationThread
+    {
+    public:
+        SimulationThread();
+        ~SimulationThread();
+
+        SimulationThread(const SimulationThread&) = delete;
+        SimulationThread& operator=(const SimulationThread&) = delete;
+
+        // Запуск новой партии (текущая останавливается). seed - из random_seed или случайный, как в Simulation::Reset.
+        // До возврата все буферы заполнены начальным состоянием, поэтому снимок доступен сразу.
+        // watchPath - файл настроек, правки которого применяются к идущей партии между шагами (пусто - не следить).
+        // При stream_address в config поток симуляции раздает состояние после каждого шага зрителям (StateServer)
+        void Start(const ConfigData& config, const std::string& watchPath = std::string());
+
+        // Остановка потока симуляции (последний снимок остается доступен)
+        void Stop();
+
+        // Последний опубликованный снимок. Вызывается только из одного потока (окна);
+        // снимок не меняется до следующего вызова AcquireSnapshot
+        const SimSnapshot& AcquireSnapshot();
+
+        // Перемотка: поток симуляции шагает без ожидания реального времени, пока не выполнится цель
+        // (обнаружение, перехват, шаг с номером), затем партия снова идет в реальном времени.
+        // Снимки во время перемотки публикуются с частотой кадров окна, SimSnapshot::Warping - признак перемотки.
+        // Новый запрос заменяет идущую перемотку. Возвращает номер запроса: перемотка окончена,
+        // когда в снимке WarpSerial не меньше него и Warping сброшен
+        uint32_t Warp(const WarpGoal& goal);
+
+        // Отмена перемотки: партия продолжается в реальном времени с того места, куда успела дойти
+        void CancelWarp();
+
+        // Сообщение о последней правке файла настроек: какие ключи применены или почему файл отвергнут.
+        // Пустая строка, если нового сообщения нет. Вызывается из потока окна
+        std::string TakeConfigMessage();
+
+        // Текущее время по часам, которыми поток симуляции отмечает публикацию снимков
+        static double NowSec();
+
+    private:
+        struct Impl;
+        Impl* impl;
+    };
+}
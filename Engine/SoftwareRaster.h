@@ -0,0 +1,275 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace sim
+{
+    // Цвет пикселя (8 бит на канал)
+    struct Rgb
+    {
+        uint8_t R, G, B;
+    };
+
+    // Программная растеризация в память: те же фигуры, что рисует окно через GDI+
+    // (круги зон, сектор луча, квадраты установок, кружки ракет), но без Windows и без видеокарты.
+    // Кадр - массив RGB по строкам сверху вниз, как в PPM и в сыром видеопотоке rgb24.
+    // Края фигур сглаживаются по доле покрытия пикселя, как при SmoothingMode::AntiAlias
+    class SoftwareRaster
+    {
+    public:
+        SoftwareRaster() : width(0), height(0), stampRadius(-1.0f), stampSize(0) {}
+
+        void Resize(int width, int height)
+        {
+            this->width = std::max(1, width);
+            this->height = std::max(1, height);
+            pixels.assign((size_t)this->width * this->height * 3, 0);
+        }
+
+        int Width() const { return width; }
+        int Height() const { return height; }
+        const uint8_t* Data() const { return pixels.data(); }
+        size_t ByteSize() const { return pixels.size(); }
+
+        // Копия другого кадра того же размера (готовый фоновый слой)
+        void CopyFrom(const SoftwareRaster& other)
+        {
+            if (other.width != width || other.height != height) Resize(other.width, other.height);
+            std::memcpy(pixels.data(), other.pixels.data(), pixels.size());
+        }
+
+        void Clear(Rgb color)
+        {
+            for (size_t i = 0; i < pixels.size(); i += 3)
+            {
+                pixels[i] = color.R; pixels[i + 1] = color.G; pixels[i + 2] = color.B;
+            }
+        }
+
+        // Прямоугольник без сглаживания (границы по целым пикселям, как у установок в окне)
+        void FillRect(float left, float top, float w, float h, Rgb color)
+        {
+            int x0 = std::max(0, (int)std::floor(left + 0.5f)), x1 = std::min(width, (int)std::floor(left + w + 0.5f));
+            int y0 = std::max(0, (int)std::floor(top + 0.5f)), y1 = std::min(height, (int)std::floor(top + h + 0.5f));
+            for (int y = y0; y < y1; y++)
+            {
+                for (int x = x0; x < x1; x++) Put(x, y, color);
+            }
+        }
+
+        // Закрашенный круг
+        void FillDisk(float cx, float cy, float radius, Rgb color, uint8_t alpha = 255)
+        {
+            int x0, y0, x1, y1;
+            if (!Bounds(cx - radius - 1, cy - radius - 1, cx + radius + 1, cy + radius + 1, x0, y0, x1, y1)) return;
+            for (int y = y0; y <= y1; y++)
+            {
+                for (int x = x0; x <= x1; x++)
+                {
+                    float d = std::sqrt(Sq(x + 0.5f - cx) + Sq(y + 0.5f - cy));
+                    float coverage = Clamp01(radius + 0.5f - d);
+                    if (coverage > 0.0f) Blend(x, y, color, coverage * alpha / 255.0f);
+                }
+            }
+        }
+
+        // Окружность пером толщиной penWidth с пунктиром. dashPattern - длины штрихов и пробелов
+        // в толщинах пера, как DashPattern в GDI+ (Dot = {1, 1}, Dash = {3, 1}, DashDot = {3, 1, 1, 1});
+        // пустой шаблон - сплошная линия
+        void StrokeCircle(float cx, float cy, float radius, float penWidth, Rgb color, uint8_t alpha,
+            const float* dashPattern = nullptr, int dashCount = 0)
+        {
+            float half = penWidth * 0.5f;
+            float patternLength = 0.0f;
+            for (int k = 0; k < dashCount; k++) patternLength += dashPattern[k] * penWidth;
+
+            int x0, y0, x1, y1;
+            float outer = radius + half + 1.0f;
+            if (!Bounds(cx - outer, cy - outer, cx + outer, cy + outer, x0, y0, x1, y1)) return;
+            for (int y = y0; y <= y1; y++)
+            {
+                for (int x = x0; x <= x1; x++)
+                {
+                    float dx = x + 0.5f - cx, dy = y + 0.5f - cy;
+                    float d = std::sqrt(dx * dx + dy * dy);
+                    float coverage = Clamp01(half + 0.5f - std::fabs(d - radius));
+                    if (coverage <= 0.0f) continue;
+                    if (patternLength > 0.0f)
+                    {
+                        // Положение вдоль окружности (длина дуги от оси X) внутри шаблона пунктира
+                        float angle = std::atan2(dy, dx);
+                        if (angle < 0.0f) angle += 6.28318530718f;
+                        float along = std::fmod(angle * radius, patternLength);
+                        if (!InDash(along, dashPattern, dashCount, penWidth)) continue;
+                    }
+                    Blend(x, y, color, coverage * alpha / 255.0f);
+                }
+            }
+        }
+
+        // Закрашенный треугольник (сектор луча): сглаживание по расстоянию до ребер
+        void FillTriangle(float ax, float ay, float bx, float by, float cx, float cy, Rgb color, uint8_t alpha)
+        {
+            // Ребра в виде nx * x + ny * y + c >= 0 внутри, с единичной нормалью (значение - расстояние до ребра)
+            float area = (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+            if (area == 0.0f) return;
+            float sign = area > 0.0f ? 1.0f : -1.0f;
+            float ex[3], ey[3], ec[3];
+            const float px[3] = { ax, bx, cx }, py[3] = { ay, by, cy };
+            for (int k = 0; k < 3; k++)
+            {
+                int n = (k + 1) % 3;
+                float nx = -(py[n] - py[k]) * sign, ny = (px[n] - px[k]) * sign;
+                float length = std::sqrt(nx * nx + ny * ny);
+                if (length == 0.0f) return;
+                ex[k] = nx / length; ey[k] = ny / length;
+                ec[k] = -(ex[k] * px[k] + ey[k] * py[k]);
+            }
+
+            int x0, y0, x1, y1;
+            if (!Bounds(std::min(ax, std::min(bx, cx)) - 1, std::min(ay, std::min(by, cy)) - 1,
+                std::max(ax, std::max(bx, cx)) + 1, std::max(ay, std::max(by, cy)) + 1, x0, y0, x1, y1)) return;
+            float a = alpha / 255.0f;
+            for (int y = y0; y <= y1; y++)
+            {
+                float fy = y + 0.5f;
+                for (int x = x0; x <= x1; x++)
+                {
+                    float fx = x + 0.5f;
+                    float coverage = 1.0f;
+                    for (int k = 0; k < 3; k++) coverage = std::min(coverage, Clamp01(ex[k] * fx + ey[k] * fy + ec[k] + 0.5f));
+                    if (coverage > 0.0f) Blend(x, y, color, coverage * a);
+                }
+            }
+        }
+
+        // Отрезок толщиной в пиксель со сглаживанием
+        void DrawLine(float ax, float ay, float bx, float by, Rgb color)
+        {
+            int x0, y0, x1, y1;
+            if (!Bounds(std::min(ax, bx) - 1, std::min(ay, by) - 1, std::max(ax, bx) + 1, std::max(ay, by) + 1, x0, y0, x1, y1)) return;
+            float dx = bx - ax, dy = by - ay;
+            float lengthSq = dx * dx + dy * dy;
+            for (int y = y0; y <= y1; y++)
+            {
+                for (int x = x0; x <= x1; x++)
+                {
+                    float px = x + 0.5f - ax, py = y + 0.5f - ay;
+                    float t = lengthSq > 0.0f ? std::min(1.0f, std::max(0.0f, (px * dx + py * dy) / lengthSq)) : 0.0f;
+                    float d = std::sqrt(Sq(px - t * dx) + Sq(py - t * dy));
+                    float coverage = Clamp01(1.0f - d);
+                    if (coverage > 0.0f) Blend(x, y, color, coverage);
+                }
+            }
+        }
+
+        // Пакет одинаковых кружков (ракеты): маска покрытия для радиуса считается один раз,
+        // затем накладывается по каждой точке без вычисления корней и без проверок на каждый пиксель,
+        // кроме кружков у края кадра
+        void FillDisks(const float* xs, const float* ys, size_t count, float radius, Rgb color)
+        {
+            PrepareStamp(radius);
+            int reach = stampSize / 2;
+            for (size_t i = 0; i < count; i++)
+            {
+                int cx = (int)std::floor(xs[i]), cy = (int)std::floor(ys[i]);
+                int left = cx - reach, top = cy - reach;
+                if (left >= 0 && top >= 0 && left + stampSize <= width && top + stampSize <= height)
+                {
+                    for (int sy = 0; sy < stampSize; sy++)
+                    {
+                        uint8_t* row = &pixels[((size_t)(top + sy) * width + left) * 3];
+                        const uint8_t* mask = &stamp[(size_t)sy * stampSize];
+                        for (int sx = 0; sx < stampSize; sx++, row += 3)
+                        {
+                            unsigned m = mask[sx];
+                            row[0] = (uint8_t)((row[0] * (255 - m) + color.R * m + 127) / 255);
+                            row[1] = (uint8_t)((row[1] * (255 - m) + color.G * m + 127) / 255);
+                            row[2] = (uint8_t)((row[2] * (255 - m) + color.B * m + 127) / 255);
+                        }
+                    }
+                }
+                else
+                {
+                    for (int sy = 0; sy < stampSize; sy++)
+                    {
+                        for (int sx = 0; sx < stampSize; sx++)
+                        {
+                            int x = left + sx, y = top + sy;
+                            if (x < 0 || y < 0 || x >= width || y >= height) continue;
+                            Blend(x, y, color, stamp[(size_t)sy * stampSize + sx] / 255.0f);
+                        }
+                    }
+                }
+            }
+        }
+
+    private:
+        int width;
+        int height;
+        std::vector<uint8_t> pixels;
+
+        float stampRadius;          // Для какого радиуса посчитана маска кружка
+        int stampSize;              // Сторона маски в пикселях
+        std::vector<uint8_t> stamp; // Покрытие пикселей маски (0..255)
+
+        static float Sq(float v) { return v * v; }
+        static float Clamp01(float v) { return v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v); }
+
+        static bool InDash(float along, const float* pattern, int count, float penWidth)
+        {
+            for (int k = 0; k < count; k++)
+            {
+                along -= pattern[k] * penWidth;
+                if (along < 0.0f) return (k & 1) == 0; // Четные элементы - штрихи, нечетные - пробелы
+            }
+            return false;
+        }
+
+        // Пиксельный прямоугольник, покрывающий [left, right] x [top, bottom], обрезанный по кадру
+        bool Bounds(float left, float top, float right, float bottom, int& x0, int& y0, int& x1, int& y1) const
+        {
+            x0 = std::max(0, (int)std::floor(left));
+            y0 = std::max(0, (int)std::floor(top));
+            x1 = std::min(width - 1, (int)std::ceil(right));
+            y1 = std::min(height - 1, (int)std::ceil(bottom));
+            return x0 <= x1 && y0 <= y1;
+        }
+
+        void Put(int x, int y, Rgb color)
+        {
+            uint8_t* p = &pixels[((size_t)y * width + x) * 3];
+            p[0] = color.R; p[1] = color.G; p[2] = color.B;
+        }
+
+        void Blend(int x, int y, Rgb color, float a)
+        {
+            uint8_t* p = &pixels[((size_t)y * width + x) * 3];
+            p[0] = (uint8_t)(p[0] + (color.R - p[0]) * a + 0.5f);
+            p[1] = (uint8_t)(p[1] + (color.G - p[1]) * a + 0.5f);
+            p[2] = (uint8_t)(p[2] + (color.B - p[2]) * a + 0.5f);
+        }
+
+        // Маска покрытия кружка: центр кружка - центр пикселя (floor(x), floor(y))
+        void PrepareStamp(float radius)
+        {
+            if (radius == stampRadius) return;
+            stampRadius = radius;
+            int reach = (int)std::ceil(radius + 0.5f);
+            stampSize = 2 * reach + 1;
+            stamp.assign((size_t)stampSize * stampSize, 0);
+            for (int sy = 0; sy < stampSize; sy++)
+            {
+                for (int sx = 0; sx < stampSize; sx++)
+                {
+                    float d = std::sqrt(Sq((float)(sx - reach)) + Sq((float)(sy - reach)));
+                    stamp[(size_t)sy * stampSize + sx] = (uint8_t)(Clamp01(radius + 0.5f - d) * 255.0f + 0.5f);
+                }
+            }
+        }
+    };
+}
@@ -0,0 +1,985 @@
+// Поток состояния партии: кодирование сообщений и раздача их зрителям через сокет
+#include "StateStream.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace sim
+{
+    namespace
+    {
+        // Сообщение длиннее этого считается повреждением потока
+        const uint64_t MaxMessageBytes = 1ull << 30;
+        // Наименьший кольцевой буфер сервера
+        const size_t MinBufferBytes = 1u << 20;
+        // Сколько байтов поток раздачи копирует из буфера на один send
+        const size_t SendChunkBytes = 64u << 10;
+        // Игрового времени между опорными кадрами: столько в худшем случае ждет новый зритель
+        const double KeyframeEverySec = 2.0;
+#ifdef _WIN32
+        // В Windows поток раздачи не будится из Publish, а просыпается сам
+        const int PollTimeoutMs = 5;
+#else
+        const int PollTimeoutMs = 200;
+#endif
+
+        const Radar& RadarAt(const Simulation& simulation, size_t k)
+        {
+            return k == 0 ? simulation.MainRadar : simulation.SupportRadars[k - 1];
+        }
+
+        int32_t QuantizePosition(float value)
+        {
+            float q = std::round(value / StatePositionUnit);
+            return (int32_t)std::min(1.0e9f, std::max(-1.0e9f, q));
+        }
+
+        void PutVarint(std::vector<uint8_t>& out, uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                out.push_back((uint8_t)(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back((uint8_t)value);
+        }
+
+        void PutSigned(std::vector<uint8_t>& out, int64_t value)
+        {
+            PutVarint(out, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+        }
+
+        void PutFloat(std::vector<uint8_t>& out, float value)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            for (int k = 0; k < 4; k++) out.push_back((uint8_t)(bits >> (8 * k)));
+        }
+
+        // Чтение тела сообщения; после первой ошибки все чтения возвращают 0, а Ok - false
+        struct MessageReader
+        {
+            const uint8_t* At;
+            const uint8_t* End;
+            bool Ok = true;
+
+            MessageReader(const uint8_t* data, size_t size) : At(data), End(data + size) {}
+
+            size_t Left() const { return (size_t)(End - At); }
+
+            uint8_t Byte()
+            {
+                if (At == End) { Ok = false; return 0; }
+                return *At++;
+            }
+
+            uint64_t Varint()
+            {
+                uint64_t value = 0;
+                for (int shift = 0; shift < 64; shift += 7)
+                {
+                    uint8_t byte = Byte();
+                    value |= (uint64_t)(byte & 0x7f) << shift;
+                    if (!(byte & 0x80)) return value;
+                }
+                Ok = false;
+                return 0;
+            }
+
+            int64_t Signed()
+            {
+                uint64_t value = Varint();
+                return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+            }
+
+            float Float()
+            {
+                uint32_t bits = 0;
+                for (int k = 0; k < 4; k++) bits |= (uint32_t)Byte() << (8 * k);
+                float value;
+                std::memcpy(&value, &bits, sizeof(value));
+                return value;
+            }
+
+            // Число элементов, каждый из которых занимает хотя бы байт: защита от огромных размеров в поврежденном потоке
+            size_t Count()
+            {
+                uint64_t count = Varint();
+                if (count > Left()) { Ok = false; return 0; }
+                return (size_t)count;
+            }
+        };
+
+        // Сокеты: в Windows - Winsock, в остальных системах - POSIX
+#ifdef _WIN32
+        typedef SOCKET SocketHandle;
+        const SocketHandle NoSocket = INVALID_SOCKET;
+
+        bool StartSockets()
+        {
+            static const bool started = []() { WSADATA data; return WSAStartup(MAKEWORD(2, 2), &data) == 0; }();
+            return started;
+        }
+
+        void CloseSocket(SocketHandle socket) { closesocket(socket); }
+        bool SetNonBlocking(SocketHandle socket) { u_long on = 1; return ioctlsocket(socket, FIONBIO, &on) == 0; }
+        bool WouldBlock() { return WSAGetLastError() == WSAEWOULDBLOCK; }
+        int PollSockets(pollfd* fds, size_t count, int timeoutMs) { return WSAPoll(fds, (ULONG)count, timeoutMs); }
+
+        long SendSome(SocketHandle socket, const uint8_t* data, size_t size)
+        {
+            return send(socket, (const char*)data, (int)std::min(size, (size_t)1 << 30), 0);
+        }
+
+        long ReceiveSome(SocketHandle socket, uint8_t* data, size_t size)
+        {
+            return recv(socket, (char*)data, (int)std::min(size, (size_t)1 << 30), 0);
+        }
+
+        std::string SocketError(const char* what) { return std::string(what) + ": ошибка " + std::to_string(WSAGetLastError()); }
+#else
+        typedef int SocketHandle;
+        const SocketHandle NoSocket = -1;
+
+        bool StartSockets() { return true; }
+        void CloseSocket(SocketHandle socket) { close(socket); }
+        bool SetNonBlocking(SocketHandle socket) { return fcntl(socket, F_SETFL, fcntl(socket, F_GETFL) | O_NONBLOCK) == 0; }
+        bool WouldBlock() { return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR; }
+        int PollSockets(pollfd* fds, size_t count, int timeoutMs) { return poll(fds, (nfds_t)count, timeoutMs); }
+
+        long SendSome(SocketHandle socket, const uint8_t* data, size_t size)
+        {
+            // Закрытый зрителем сокет не должен завершать процесс сигналом SIGPIPE
+#ifdef MSG_NOSIGNAL
+            return (long)send(socket, data, size, MSG_NOSIGNAL);
+#else
+            return (long)send(socket, data, size, 0);
+#endif
+        }
+
+        long ReceiveSome(SocketHandle socket, uint8_t* data, size_t size)
+        {
+            return (long)recv(socket, data, size, 0);
+        }
+
+        std::string SocketError(const char* what) { return std::string(what) + ": " + std::strerror(errno); }
+#endif
+
+        // Разобранный адрес сервера
+        struct Endpoint
+        {
+            bool Unix = false;
+            std::string Path;
+            uint16_t Port = 0;
+        };
+
+        bool ParseAddress(const std::string& address, Endpoint& endpoint, std::string* error)
+        {
+            if (address.compare(0, 5, "unix:") == 0 && address.size() > 5)
+            {
+#ifdef _WIN32
+                if (error) *error = "адрес unix: в Windows не поддерживается, используйте tcp:порт";
+                return false;
+#else
+                endpoint.Unix = true;
+                endpoint.Path = address.substr(5);
+                if (endpoint.Path.size() >= sizeof(sockaddr_un().sun_path))
+                {
+                    if (error) *error = "слишком длинный путь сокета: " + endpoint.Path;
+                    return false;
+                }
+                return true;
+#endif
+            }
+            if (address.compare(0, 4, "tcp:") == 0)
+            {
+                char* end = nullptr;
+                unsigned long port = std::strtoul(address.c_str() + 4, &end, 10);
+                if (end != address.c_str() + 4 && *end == '\0' && port >= 1 && port <= 65535)
+                {
+                    endpoint.Port = (uint16_t)port;
+                    return true;
+                }
+            }
+            if (error) *error = "адрес потока состояния - unix:/путь или tcp:порт, получено: " + address;
+            return false;
+        }
+
+        // Сокет с адресом endpoint: слушающий (listen) или подключенный к серверу
+        SocketHandle OpenSocket(const Endpoint& endpoint, bool listen, std::string* error)
+        {
+            if (!StartSockets())
+            {
+                if (error) *error = "сокеты недоступны";
+                return NoSocket;
+            }
+            SocketHandle socket = NoSocket;
+            int result;
+#ifndef _WIN32
+            if (endpoint.Unix)
+            {
+                sockaddr_un address;
+                std::memset(&address, 0, sizeof(address));
+                address.sun_family = AF_UNIX;
+                std::memcpy(address.sun_path, endpoint.Path.c_str(), endpoint.Path.size());
+                socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+                if (socket == NoSocket)
+                {
+                    if (error) *error = SocketError("socket");
+                    return NoSocket;
+                }
+                // Сокет прошлого запуска остается в файловой системе и мешает bind
+                if (listen) unlink(endpoint.Path.c_str());
+                result = listen ? bind(socket, (const sockaddr*)&address, sizeof(address))
+                    : connect(socket, (const sockaddr*)&address, sizeof(address));
+            }
+            else
+#endif
+            {
+                sockaddr_in address;
+                std::memset(&address, 0, sizeof(address));
+                address.sin_family = AF_INET;
+                address.sin_port = htons(endpoint.Port);
+                address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+                socket = ::socket(AF_INET, SOCK_STREAM, 0);
+                if (socket == NoSocket)
+                {
+                    if (error) *error = SocketError("socket");
+                    return NoSocket;
+                }
+                int on = 1;
+                if (listen) setsockopt(socket, SOL_SOCKET, SO_REUSEADDR, (const char*)&on, sizeof(on));
+                else setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, (const char*)&on, sizeof(on));
+                result = listen ? bind(socket, (const sockaddr*)&address, sizeof(address))
+                    : connect(socket, (const sockaddr*)&address, sizeof(address));
+            }
+            if (result != 0 || (listen && ::listen(socket, 16) != 0))
+            {
+                if (error) *error = SocketError(listen ? "bind" : "connect");
+                CloseSocket(socket);
+                return NoSocket;
+            }
+            return socket;
+        }
+    }
+
+    bool StateStreamEncoder::Encode(const Simulation& simulation, float stepSec, bool keyframe, std::vector<uint8_t>& out)
+    {
+        // Опорный кадр и при смене радаров: их положение передается только в нем
+        const size_t radarCount = 1 + simulation.SupportRadars.size();
+        bool layoutChanged = radarPositions.size() != radarCount;
+        for (size_t k = 0; k < radarCount && !layoutChanged; k++)
+        {
+            const Vec2& position = RadarAt(simulation, k).Position;
+            layoutChanged = position.X != radarPositions[k].X || position.Y != radarPositions[k].Y;
+        }
+        keyframe = keyframe || keyframeDue || layoutChanged;
+        keyframeDue = false;
+        if (keyframe)
+        {
+            tracks.clear();
+            radarPositions.resize(radarCount);
+            radarAngles.assign(radarCount, 0);
+            radarTurns.assign(radarCount, 0);
+            radarDestroyed.assign(radarCount, 0);
+        }
+
+        body.clear();
+        body.push_back((uint8_t)(keyframe ? StateMessage::Keyframe : StateMessage::Delta));
+        PutVarint(body, simulation.TickCount);
+        if (keyframe)
+        {
+            PutFloat(body, stepSec);
+            PutVarint(body, radarCount);
+            for (size_t k = 0; k < radarCount; k++)
+            {
+                const Radar& radar = RadarAt(simulation, k);
+                PutFloat(body, radar.Position.X);
+                PutFloat(body, radar.Position.Y);
+                PutFloat(body, radar.MaxDetectionRangeP);
+                radarPositions[k] = radar.Position;
+            }
+        }
+
+        // Счетчики
+        PutVarint(body, (uint32_t)std::max(0, simulation.RocketsLaunchedCount));
+        PutVarint(body, (uint32_t)std::max(0, simulation.RocketsInterceptedCount));
+        PutVarint(body, (uint32_t)std::max(0, simulation.Config.TotalRocketsToLaunch));
+        body.push_back((uint8_t)((simulation.GameOver ? 1 : 0) | ((uint8_t)simulation.Result << 1)));
+
+        // Радары: смены состояния "уничтожен", затем остатки углов
+        size_t toggled = 0;
+        for (size_t k = 0; k < radarCount; k++) toggled += RadarAt(simulation, k).IsDestroyed != (radarDestroyed[k] != 0) ? 1 : 0;
+        PutVarint(body, toggled);
+        for (size_t k = 0, previous = 0; k < radarCount; k++)
+        {
+            uint8_t destroyed = RadarAt(simulation, k).IsDestroyed ? 1 : 0;
+            if (destroyed == radarDestroyed[k]) continue;
+            PutVarint(body, k - previous);
+            previous = k;
+            radarDestroyed[k] = destroyed;
+        }
+        for (size_t k = 0; k < radarCount; k++)
+        {
+            BinaryAngle angle = RadarAt(simulation, k).Angle;
+            uint32_t turn = angle - radarAngles[k];
+            PutSigned(body, (int32_t)(turn - radarTurns[k]));
+            radarAngles[k] = angle;
+            radarTurns[k] = keyframe ? 0 : turn;
+        }
+
+        // Ракеты по возрастанию Id, слиянием с ракетами прошлого сообщения
+        const RocketStore& rockets = simulation.ActiveRockets;
+        order.resize(rockets.Size());
+        for (size_t i = 0; i < order.size(); i++) order[i] = (uint32_t)i;
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return rockets.Id[a] < rockets.Id[b]; });
+        removed.clear();
+        added.clear();
+        nextTracks.clear();
+        size_t t = 0;
+        for (uint32_t i : order)
+        {
+            const uint32_t id = rockets.Id[i];
+            while (t < tracks.size() && tracks[t].Id < id) removed.push_back(tracks[t++].Id);
+            Track next = { id, QuantizePosition(rockets.X[i]), QuantizePosition(rockets.Y[i]), 0, 0 };
+            if (t < tracks.size() && tracks[t].Id == id)
+            {
+                const Track& previous = tracks[t++];
+                next.DX = next.X - previous.X;
+                next.DY = next.Y - previous.Y;
+            }
+            else added.push_back((uint32_t)nextTracks.size());
+            nextTracks.push_back(next);
+        }
+        while (t < tracks.size()) removed.push_back(tracks[t++].Id);
+
+        PutVarint(body, removed.size());
+        for (size_t k = 0, previous = 0; k < removed.size(); k++)
+        {
+            PutVarint(body, removed[k] - previous);
+            previous = removed[k];
+        }
+        PutVarint(body, added.size());
+        for (size_t k = 0, previous = 0; k < added.size(); k++)
+        {
+            const Track& track = nextTracks[added[k]];
+            PutVarint(body, track.Id - previous);
+            PutSigned(body, track.X);
+            PutSigned(body, track.Y);
+            previous = track.Id;
+        }
+        // Остатки прогноза у ракет, бывших в прошлом сообщении: прогноз - прежний сдвиг
+        t = 0;
+        for (const Track& track : nextTracks)
+        {
+            while (t < tracks.size() && tracks[t].Id < track.Id) t++;
+            if (t == tracks.size() || tracks[t].Id != track.Id) continue;
+            const Track& previous = tracks[t];
+            PutSigned(body, (int64_t)track.DX - previous.DX);
+            PutSigned(body, (int64_t)track.DY - previous.DY);
+        }
+        tracks.swap(nextTracks);
+
+        out.clear();
+        PutVarint(out, body.size());
+        out.insert(out.end(), body.begin(), body.end());
+        return keyframe;
+    }
+
+    void StateStreamDecoder::Feed(const uint8_t* data, size_t size)
+    {
+        // Разобранные байты отбрасываются перед добавлением новых
+        if (offset > 0)
+        {
+            pending.erase(pending.begin(), pending.begin() + (ptrdiff_t)offset);
+            offset = 0;
+        }
+        pending.insert(pending.end(), data, data + size);
+    }
+
+    int StateStreamDecoder::Next(std::string* error)
+    {
+        for (;;)
+        {
+            MessageReader header(pending.data() + offset, pending.size() - offset);
+            uint64_t length = 0;
+            int shift = 0;
+            for (;; shift += 7)
+            {
+                if (header.Left() == 0) return 0;
+                if (shift >= 64)
+                {
+                    if (error) *error = "поврежденная длина сообщения";
+                    return -1;
+                }
+                uint8_t byte = header.Byte();
+                length |= (uint64_t)(byte & 0x7f) << shift;
+                if (!(byte & 0x80)) break;
+            }
+            if (length == 0 || length > MaxMessageBytes)
+            {
+                if (error) *error = "недопустимая длина сообщения";
+                return -1;
+            }
+            if (header.Left() < length) return 0;
+            const uint8_t* body = header.At;
+            offset = (size_t)(body - pending.data()) + (size_t)length;
+
+            // До первого опорного кадра разницы не к чему применять
+            if (!Synced() && body[0] != (uint8_t)StateMessage::Keyframe) continue;
+            if (!Apply(body, (size_t)length, error)) return -1;
+            Messages++;
+            return 1;
+        }
+    }
+
+    bool StateStreamDecoder::Apply(const uint8_t* data, size_t size, std::string* error)
+    {
+        MessageReader reader(data, size);
+        uint8_t kind = reader.Byte();
+        if (kind != (uint8_t)StateMessage::Keyframe && kind != (uint8_t)StateMessage::Delta)
+        {
+            if (error) *error = "неизвестный вид сообщения " + std::to_string(kind);
+            return false;
+        }
+        const bool keyframe = kind == (uint8_t)StateMessage::Keyframe;
+        uint64_t tick = reader.Varint();
+        if (keyframe)
+        {
+            StepSec = reader.Float();
+            size_t radarCount = reader.Count();
+            if (radarCount == 0) reader.Ok = false;
+            Radars.resize(radarCount);
+            for (StreamRadar& radar : Radars)
+            {
+                radar.X = reader.Float();
+                radar.Y = reader.Float();
+                radar.MaxDetectionRangeP = reader.Float();
+                radar.Angle = 0;
+                radar.Destroyed = false;
+            }
+            radarTurns.assign(radarCount, 0);
+            Rockets.clear();
+            rocketQX.clear(); rocketQY.clear(); rocketDX.clear(); rocketDY.clear();
+        }
+
+        int launched = (int)reader.Varint();
+        int intercepted = (int)reader.Varint();
+        int total = (int)reader.Varint();
+        uint8_t flags = reader.Byte();
+
+        size_t toggled = reader.Count();
+        for (size_t k = 0, index = 0; k < toggled && reader.Ok; k++)
+        {
+            index += (size_t)reader.Varint();
+            if (index >= Radars.size()) reader.Ok = false;
+            else Radars[index].Destroyed = !Radars[index].Destroyed;
+        }
+        for (size_t k = 0; k < Radars.size(); k++)
+        {
+            uint32_t turn = radarTurns[k] + (uint32_t)reader.Signed();
+            Radars[k].Angle += turn;
+            radarTurns[k] = keyframe ? 0 : turn;
+        }
+
+        // Исчезнувшие ракеты: отмечаются слиянием списка Id с текущими ракетами
+        removed.clear();
+        size_t removedCount = reader.Count();
+        for (size_t k = 0, id = 0; k < removedCount && reader.Ok; k++)
+        {
+            id += (size_t)reader.Varint();
+            removed.push_back((uint32_t)id);
+        }
+        size_t addedCount = reader.Count();
+        nextRockets.clear();
+        nextQX.clear(); nextQY.clear(); nextDX.clear(); nextDY.clear();
+
+        // Новые ракеты - в начало рабочих массивов, за ними оставшиеся
+        for (size_t k = 0, id = 0; k < addedCount && reader.Ok; k++)
+        {
+            id += (size_t)reader.Varint();
+            int32_t qx = (int32_t)reader.Signed();
+            int32_t qy = (int32_t)reader.Signed();
+            nextRockets.push_back(StreamRocket{ (uint32_t)id, qx * StatePositionUnit, qy * StatePositionUnit });
+            nextQX.push_back(qx);
+            nextQY.push_back(qy);
+        }
+        const size_t addedEnd = nextRockets.size();
+
+        // Оставшиеся ракеты - по остаткам прогноза; затем слияние с новыми по Id
+        size_t r = 0;
+        for (size_t i = 0; i < Rockets.size() && reader.Ok; i++)
+        {
+            while (r < removed.size() && removed[r] < Rockets[i].Id) r++;
+            if (r < removed.size() && removed[r] == Rockets[i].Id) continue;
+            int32_t dx = (int32_t)(rocketDX[i] + reader.Signed());
+            int32_t dy = (int32_t)(rocketDY[i] + reader.Signed());
+            int32_t qx = rocketQX[i] + dx, qy = rocketQY[i] + dy;
+            nextRockets.push_back(StreamRocket{ Rockets[i].Id, qx * StatePositionUnit, qy * StatePositionUnit });
+            nextQX.push_back(qx);
+            nextQY.push_back(qy);
+            nextDX.push_back(dx);
+            nextDY.push_back(dy);
+        }
+        if (!reader.Ok || reader.Left() != 0)
+        {
+            if (error) *error = "поврежденное сообщение на шаге " + std::to_string(tick);
+            return false;
+        }
+
+        // Новые (с нулевым сдвигом) и оставшиеся - каждые по возрастанию Id; общий порядок - слиянием
+        const size_t count = nextRockets.size();
+        Rockets.resize(count);
+        rocketQX.resize(count); rocketQY.resize(count); rocketDX.resize(count); rocketDY.resize(count);
+        size_t a = 0, s = addedEnd;
+        for (size_t k = 0; k < count; k++)
+        {
+            bool takeAdded = s == count || (a < addedEnd && nextRockets[a].Id < nextRockets[s].Id);
+            size_t from = takeAdded ? a++ : s++;
+            Rockets[k] = nextRockets[from];
+            rocketQX[k] = nextQX[from];
+            rocketQY[k] = nextQY[from];
+            rocketDX[k] = takeAdded ? 0 : nextDX[from - addedEnd];
+            rocketDY[k] = takeAdded ? 0 : nextDY[from - addedEnd];
+        }
+
+        TickCount = tick;
+        Launched = launched;
+        Intercepted = intercepted;
+        Total = total;
+        GameOver = (flags & 1) != 0;
+        Result = (Outcome)((flags >> 1) & 3);
+        if (keyframe) Keyframes++;
+        return true;
+    }
+
+    struct StateServer::Impl
+    {
+        std::string Address;
+        Endpoint Where;
+        SocketHandle Listener = NoSocket;
+        std::thread Worker;
+        std::atomic<bool> StopRequested;
+        bool Running = false;
+#ifndef _WIN32
+        int WakeRead = -1, WakeWrite = -1;  // Publish будит поток раздачи байтом в канал
+#endif
+
+        // Кольцевой буфер сообщений (seqlock). Смещения растут монотонно, байт смещения p лежит в слове
+        // Ring[(p & (Capacity - 1)) / 8], младшие байты слова - младшие смещения. Писатель (Publish) объявляет
+        // Reserved, ставит барьер release и пишет слова; поток раздачи читает слова (RingRead), ставит барьер acquire
+        // и сверяет Reserved. Слова атомарные (relaxed), поэтому гонки нет: если чтение застало хоть одно новое
+        // слово, барьеры гарантируют, что сверка увидит и новый Reserved, и копия будет отброшена
+        std::vector<std::atomic<uint64_t>> Ring;
+        size_t Capacity = 0;
+        std::atomic<uint64_t> Head;
+        std::atomic<uint64_t> Reserved;
+        std::atomic<uint64_t> LatestKeyframe;   // Смещение начала последнего опорного кадра
+
+        // Только поток симуляции
+        StateStreamEncoder Encoder;
+        std::vector<uint8_t> Message;
+        uint64_t KeyframeTick = 0;              // Шаг, с которого следующее сообщение - опорный кадр
+
+        // Только поток раздачи
+        struct Viewer
+        {
+            SocketHandle Socket;
+            uint64_t Cursor;        // Следующий байт для отправки
+            uint64_t Boundary;      // Граница сообщения, до которой все отправлено
+            uint64_t JumpAt;        // Отставший зритель: граница, после которой он переносится на опорный кадр
+            bool Lagging;           // JumpAt задан
+            bool Blocked;           // Сокет полон, ждем POLLOUT
+            bool Closed;
+        };
+        std::vector<Viewer> Viewers;
+        std::vector<pollfd> Fds;
+        std::vector<uint8_t> Outgoing;      // Проверенная копия байтов из Ring для send
+
+        std::atomic<size_t> ViewerCount;
+        std::atomic<uint64_t> ResyncCount;
+        std::atomic<uint64_t> DroppedCount;
+
+        // Запись байтов data в буфер со смещения position. Неполные слова на краях сливаются с их прежними байтами:
+        // там могут лежать уже опубликованные байты, которые зрители еще читают
+        void RingWrite(uint64_t position, const uint8_t* data, size_t size)
+        {
+            while (size > 0)
+            {
+                size_t at = (size_t)(position & (Capacity - 1));
+                size_t shift = at & 7;
+                size_t take = std::min(size, 8 - shift);
+                std::atomic<uint64_t>& word = Ring[at >> 3];
+                uint64_t value = take == 8 ? 0 : word.load(std::memory_order_relaxed);
+                for (size_t k = 0; k < take; k++)
+                {
+                    unsigned bit = (unsigned)(shift + k) * 8;
+                    value = (value & ~(0xffull << bit)) | ((uint64_t)data[k] << bit);
+                }
+                word.store(value, std::memory_order_relaxed);
+                position += take;
+                data += take;
+                size -= take;
+            }
+        }
+
+        // Чтение size байтов со смещения position в out. Без сверки Reserved прочитанному верить нельзя
+        void RingRead(uint64_t position, uint8_t* out, size_t size) const
+        {
+            for (size_t k = 0; k < size; )
+            {
+                size_t at = (size_t)((position + k) & (Capacity - 1));
+                uint64_t value = Ring[at >> 3].load(std::memory_order_relaxed);
+                for (size_t bit = (at & 7) * 8; bit < 64 && k < size; bit += 8) out[k++] = (uint8_t)(value >> bit);
+            }
+        }
+
+        Impl() : StopRequested(false), Head(0), Reserved(0), LatestKeyframe(0), ViewerCount(0), ResyncCount(0), DroppedCount(0) {}
+
+        // Граница сообщения, внутри которого смещение position: сообщения перебираются от известной границы from
+        // по их длинам. false - длины уже перезаписаны писателем
+        bool MessageEnd(uint64_t from, uint64_t position, uint64_t head, uint64_t& end)
+        {
+            end = from;
+            while (end < position && end < head)
+            {
+                uint64_t length = 0;
+                uint64_t at = end;
+                for (int shift = 0; shift < 64 && at < head; shift += 7)
+                {
+                    uint8_t byte;
+                    RingRead(at++, &byte, 1);
+                    length |= (uint64_t)(byte & 0x7f) << shift;
+                    if (!(byte & 0x80)) break;
+                }
+                end = at + length;
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return Reserved.load(std::memory_order_relaxed) <= from + Capacity && end <= head;
+        }
+
+        // Досылает зрителю опубликованные байты, сколько примет сокет
+        void Send(Viewer& viewer)
+        {
+            const uint64_t head = Head.load(std::memory_order_acquire);
+            if (!viewer.Lagging && head - viewer.Cursor > Capacity / 2)
+            {
+                // Отставший зритель: дослать начатое сообщение и перенести его на последний опорный кадр
+                uint64_t end;
+                if (!MessageEnd(viewer.Boundary, viewer.Cursor, head, end))
+                {
+                    viewer.Closed = true;
+                    DroppedCount.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                viewer.JumpAt = end;
+                viewer.Lagging = true;
+            }
+            if (viewer.Lagging && viewer.Cursor == viewer.JumpAt)
+            {
+                viewer.Cursor = viewer.Boundary = LatestKeyframe.load(std::memory_order_acquire);
+                viewer.Lagging = false;
+                ResyncCount.fetch_add(1, std::memory_order_relaxed);
+            }
+            const uint64_t target = viewer.Lagging ? viewer.JumpAt : head;
+            if (viewer.Cursor >= target) return;
+
+            while (viewer.Cursor < target)
+            {
+                // Копия куска из Ring, затем проверка: писатель не успел объявить запись поверх его байтов
+                size_t size = (size_t)std::min<uint64_t>(target - viewer.Cursor, Outgoing.size());
+                RingRead(viewer.Cursor, Outgoing.data(), size);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (Reserved.load(std::memory_order_relaxed) > viewer.Cursor + Capacity)
+                {
+                    // Буфер обогнал зрителя: копия может быть испорчена, отдавать ее нельзя
+                    viewer.Closed = true;
+                    DroppedCount.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                long sent = SendSome(viewer.Socket, Outgoing.data(), size);
+                if (sent < 0)
+                {
+                    if (WouldBlock()) viewer.Blocked = true;
+                    else viewer.Closed = true;
+                    break;
+                }
+                viewer.Cursor += (uint64_t)sent;
+            }
+            if (viewer.Cursor == target) viewer.Boundary = target;
+            // Начатое сообщение дослано: перенос на опорный кадр сразу, не дожидаясь следующей публикации
+            if (viewer.Lagging && viewer.Cursor == viewer.JumpAt) Send(viewer);
+        }
+
+        void Accept()
+        {
+            for (;;)
+            {
+                SocketHandle socket = accept(Listener, nullptr, nullptr);
+                if (socket == NoSocket) return;
+                SetNonBlocking(socket);
+                if (!Where.Unix)
+                {
+                    int on = 1;
+                    setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, (const char*)&on, sizeof(on));
+                }
+#ifdef SO_NOSIGPIPE
+                int on = 1;
+                setsockopt(socket, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+                uint64_t start = LatestKeyframe.load(std::memory_order_acquire);
+                Viewers.push_back(Viewer{ socket, start, start, 0, false, false, false });
+                ViewerCount.store(Viewers.size(), std::memory_order_relaxed);
+            }
+        }
+
+        void Run()
+        {
+            uint8_t discard[512];
+            for (;;)
+            {
+                // Все, что опубликовано до остановки, досылается
+                const bool stopping = StopRequested.load(std::memory_order_acquire);
+                for (Viewer& viewer : Viewers)
+                {
+                    if (!viewer.Blocked && !viewer.Closed) Send(viewer);
+                }
+                size_t kept = 0;
+                for (Viewer& viewer : Viewers)
+                {
+                    if (viewer.Closed) CloseSocket(viewer.Socket);
+                    else Viewers[kept++] = viewer;
+                }
+                Viewers.resize(kept);
+                ViewerCount.store(kept, std::memory_order_relaxed);
+                if (stopping) break;
+
+                Fds.clear();
+                Fds.push_back(pollfd{ Listener, POLLIN, 0 });
+#ifndef _WIN32
+                Fds.push_back(pollfd{ WakeRead, POLLIN, 0 });
+#endif
+                const size_t first = Fds.size();
+                for (const Viewer& viewer : Viewers)
+                {
+                    Fds.push_back(pollfd{ viewer.Socket, (short)(POLLIN | (viewer.Blocked ? POLLOUT : 0)), 0 });
+                }
+                if (PollSockets(Fds.data(), Fds.size(), PollTimeoutMs) <= 0) continue;
+
+#ifndef _WIN32
+                if (Fds[1].revents & POLLIN)
+                {
+                    while (read(WakeRead, discard, sizeof(discard)) > 0) {}
+                }
+#endif
+                for (size_t k = 0; k < Viewers.size(); k++)
+                {
+                    Viewer& viewer = Viewers[k];
+                    short events = Fds[first + k].revents;
+                    if (events & (POLLERR | POLLNVAL)) viewer.Closed = true;
+                    if (events & POLLOUT) viewer.Blocked = false;
+                    if (events & (POLLIN | POLLHUP))
+                    {
+                        // Зрители ничего не присылают: входящие байты отбрасываются, 0 - зритель отключился
+                        long got = ReceiveSome(viewer.Socket, discard, sizeof(discard));
+                        if (got == 0 || (got < 0 && !WouldBlock())) viewer.Closed = true;
+                    }
+                }
+                if (Fds[0].revents & POLLIN) Accept();
+            }
+            for (Viewer& viewer : Viewers) CloseSocket(viewer.Socket);
+            Viewers.clear();
+            ViewerCount.store(0, std::memory_order_relaxed);
+        }
+    };
+
+    StateServer::StateServer() : impl(new Impl()) {}
+
+    StateServer::~StateServer()
+    {
+        Stop();
+        delete impl;
+    }
+
+    bool StateServer::Start(const std::string& address, size_t bufferBytes, std::string* error)
+    {
+        Stop();
+        Endpoint where;
+        if (!ParseAddress(address, where, error)) return false;
+        SocketHandle listener = OpenSocket(where, true, error);
+        if (listener == NoSocket) return false;
+        SetNonBlocking(listener);
+#ifndef _WIN32
+        int wake[2];
+        if (pipe(wake) != 0)
+        {
+            if (error) *error = SocketError("pipe");
+            CloseSocket(listener);
+            return false;
+        }
+        fcntl(wake[0], F_SETFL, O_NONBLOCK);
+        fcntl(wake[1], F_SETFL, O_NONBLOCK);
+        impl->WakeRead = wake[0];
+        impl->WakeWrite = wake[1];
+#endif
+
+        size_t capacity = MinBufferBytes;
+        while (capacity < bufferBytes) capacity *= 2;
+        impl->Ring = std::vector<std::atomic<uint64_t>>(capacity / 8);
+        impl->Outgoing.resize(SendChunkBytes);
+        impl->Capacity = capacity;
+        impl->Head.store(0);
+        impl->Reserved.store(0);
+        impl->LatestKeyframe.store(0);
+        impl->ResyncCount.store(0);
+        impl->DroppedCount.store(0);
+        impl->Encoder.Reset();
+        impl->KeyframeTick = 0;
+        impl->Address = address;
+        impl->Where = where;
+        impl->Listener = listener;
+        impl->StopRequested.store(false);
+        impl->Running = true;
+        impl->Worker = std::thread([this]() { impl->Run(); });
+        return true;
+    }
+
+    void StateServer::Stop()
+    {
+        if (!impl->Running) return;
+        impl->StopRequested.store(true, std::memory_order_release);
+#ifndef _WIN32
+        uint8_t byte = 0;
+        (void)!write(impl->WakeWrite, &byte, 1);
+#endif
+        impl->Worker.join();
+        CloseSocket(impl->Listener);
+        impl->Listener = NoSocket;
+#ifndef _WIN32
+        close(impl->WakeRead);
+        close(impl->WakeWrite);
+        impl->WakeRead = impl->WakeWrite = -1;
+        if (impl->Where.Unix) unlink(impl->Where.Path.c_str());
+#endif
+        impl->Running = false;
+    }
+
+    bool StateServer::Running() const { return impl->Running; }
+    const std::string& StateServer::Address() const { return impl->Address; }
+
+    void StateServer::Restart()
+    {
+        impl->Encoder.Reset();
+        impl->KeyframeTick = 0;
+    }
+
+    void StateServer::Publish(const Simulation& simulation, float stepSec)
+    {
+        Impl& server = *impl;
+        if (!server.Running) return;
+
+        // Опорный кадр - раз в KeyframeEverySec игрового времени и не реже чем через четверть буфера:
+        // тогда отставшего зрителя всегда есть куда перенести
+        const uint64_t head = server.Head.load(std::memory_order_relaxed);
+        bool keyframe = simulation.TickCount >= server.KeyframeTick
+            || head - server.LatestKeyframe.load(std::memory_order_relaxed) > server.Capacity / 4;
+        keyframe = server.Encoder.Encode(simulation, stepSec, keyframe, server.Message);
+        const size_t size = server.Message.size();
+        if (size > server.Capacity / 4)
+        {
+            // Не помещается (буфер меньше BufferBytesFor): сообщение пропускается, следующее - опорный кадр
+            server.Encoder.Reset();
+            return;
+        }
+        if (keyframe)
+        {
+            uint64_t every = stepSec > 0.0f ? (uint64_t)std::ceil(KeyframeEverySec / stepSec) : 1;
+            server.KeyframeTick = simulation.TickCount + std::max<uint64_t>(every, 1);
+        }
+
+        server.Reserved.store(head + size, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        server.RingWrite(head, server.Message.data(), size);
+        if (keyframe) server.LatestKeyframe.store(head, std::memory_order_release);
+        server.Head.store(head + size, std::memory_order_release);
+
+#ifndef _WIN32
+        if (server.ViewerCount.load(std::memory_order_relaxed) > 0)
+        {
+            uint8_t byte = 0;
+            (void)!write(server.WakeWrite, &byte, 1);
+        }
+#endif
+    }
+
+    size_t StateServer::Viewers() const { return impl->ViewerCount.load(std::memory_order_relaxed); }
+    uint64_t StateServer::BytesPublished() const { return impl->Head.load(std::memory_order_relaxed); }
+    uint64_t StateServer::Resyncs() const { return impl->ResyncCount.load(std::memory_order_relaxed); }
+    uint64_t StateServer::Dropped() const { return impl->DroppedCount.load(std::memory_order_relaxed); }
+
+    size_t StateServer::BufferBytesFor(const Simulation& simulation)
+    {
+        // Опорный кадр: до 15 байт на ракету (Id и две координаты), до 17 байт на радар и заголовок
+        size_t keyframe = 64 + 17 * (1 + simulation.SupportRadars.size())
+            + 15 * std::max(simulation.ActiveRockets.Capacity(), simulation.ActiveRockets.Size());
+        return std::max(MinBufferBytes, 4 * keyframe);
+    }
+
+    StateClient::StateClient() : socket((intptr_t)NoSocket) {}
+
+    StateClient::~StateClient()
+    {
+        Close();
+    }
+
+    bool StateClient::Connect(const std::string& address, std::string* error)
+    {
+        Close();
+        Endpoint where;
+        if (!ParseAddress(address, where, error)) return false;
+        SocketHandle connected = OpenSocket(where, false, error);
+        if (connected == NoSocket) return false;
+        socket = (intptr_t)connected;
+        return true;
+    }
+
+    void StateClient::Close()
+    {
+        if ((SocketHandle)socket == NoSocket) return;
+        CloseSocket((SocketHandle)socket);
+        socket = (intptr_t)NoSocket;
+    }
+
+    long StateClient::Receive(uint8_t* buffer, size_t size, std::string* error)
+    {
+        if ((SocketHandle)socket == NoSocket)
+        {
+            if (error) *error = "нет подключения";
+            return -1;
+        }
+        long got = ReceiveSome((SocketHandle)socket, buffer, size);
+        if (got < 0 && error) *error = SocketError("recv");
+        return got;
+    }
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "Simulation.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sim
+{
+    // Поток состояния партии для внешних зрителей и программ разбора: угол лучей, ракеты и счетчики
+    // после каждого шага, сжатые разницей с предыдущим сообщением.
+    //
+    // Поток - последовательность сообщений: varint длины тела, затем тело. Целые - varint (7 бит на байт,
+    // младшие вперед), знаковые - zigzag varint, float - 4 байта little-endian.
+    //   uint8 вид (StateMessage), varint шаг партии,
+    //   опорный кадр: float длина шага, varint число радаров, по радару float X, Y, MaxDetectionRangeP;
+    //   varint запущено, перехвачено, всего ракет; uint8 флаги (бит 0 - конец партии, биты 1..2 - Outcome);
+    //   varint число радаров, сменивших состояние "уничтожен", и их номера (разностями по возрастанию);
+    //   по радару zigzag остаток угла луча (двоичные единицы, оборот - 2^32);
+    //   ракеты по возрастанию Id: varint число исчезнувших и их Id разностями, varint число новых и для каждой
+    //   Id разностью и zigzag квантованные X, Y; затем для каждой ракеты, бывшей и в прошлом сообщении, -
+    //   zigzag остатки X, Y.
+    // Остаток - разница с прогнозом "сдвиг как в прошлый раз": ракета на прямом курсе и равномерно вращающийся
+    // луч дают нулевые остатки (байт на число). Опорный кадр кодируется как разница с пустым состоянием,
+    // после него зритель знает все. Сообщение может пропускать шаги (перемотка): разница - с прошлым сообщением
+    enum class StateMessage : uint8_t
+    {
+        Keyframe = 1,
+        Delta = 2
+    };
+
+    // Мировых единиц на единицу квантованной координаты ракеты
+    const float StatePositionUnit = 1.0f / 16.0f;
+
+    // Кодирование состояния партии в сообщения потока. Рабочие массивы переиспользуются: после первых шагов
+    // кодирование не выделяет память
+    class StateStreamEncoder
+    {
+    public:
+        // Следующее сообщение - опорный кадр (новая партия или пропущенное сообщение)
+        void Reset() { keyframeDue = true; }
+
+        // Сообщение с состоянием simulation (длина впереди) в out. keyframe - опорный кадр; он получается и сам,
+        // если с прошлого сообщения сменились радары. Возвращает true, если записан опорный кадр
+        bool Encode(const Simulation& simulation, float stepSec, bool keyframe, std::vector<uint8_t>& out);
+
+    private:
+        struct Track
+        {
+            uint32_t Id;
+            int32_t X, Y;       // Квантованное положение в прошлом сообщении
+            int32_t DX, DY;     // Сдвиг к нему от позапрошлого
+        };
+
+        bool keyframeDue = true;
+        std::vector<Track> tracks;          // Ракеты прошлого сообщения по возрастанию Id
+        std::vector<Track> nextTracks;
+        std::vector<uint32_t> order;        // Рабочий массив: ракеты по возрастанию Id
+        std::vector<uint32_t> removed;
+        std::vector<uint32_t> added;
+        std::vector<Vec2> radarPositions;
+        std::vector<uint32_t> radarAngles;
+        std::vector<uint32_t> radarTurns;   // Поворот луча между двумя прошлыми сообщениями
+        std::vector<uint8_t> radarDestroyed;
+        std::vector<uint8_t> body;
+    };
+
+    // Радар и ракета в разобранном состоянии
+    struct StreamRadar
+    {
+        float X, Y;
+        float MaxDetectionRangeP;
+        BinaryAngle Angle;
+        bool Destroyed;
+    };
+
+    struct StreamRocket
+    {
+        uint32_t Id;
+        float X, Y;
+    };
+
+    // Разбор потока: байты приходят кусками любой длины, Next применяет по одному сообщению.
+    // До первого опорного кадра разницы пропускаются (зритель подключился к середине потока)
+    class StateStreamDecoder
+    {
+    public:
+        // Состояние после последнего примененного сообщения
+        uint64_t TickCount = 0;
+        float StepSec = 0.0f;
+        int Launched = 0;
+        int Intercepted = 0;
+        int Total = 0;
+        bool GameOver = false;
+        Outcome Result = Outcome::InProgress;
+        std::vector<StreamRadar> Radars;    // Главный радар первым
+        std::vector<StreamRocket> Rockets;  // По возрастанию Id
+        uint64_t Keyframes = 0;             // Сколько опорных кадров применено
+        uint64_t Messages = 0;              // Сколько сообщений применено
+
+        // Добавляет пришедшие байты
+        void Feed(const uint8_t* data, size_t size);
+
+        // Применяет следующее целое сообщение: 1 - применено, 0 - нужно больше байтов, -1 - поток поврежден (error)
+        int Next(std::string* error = nullptr);
+
+        bool Synced() const { return Keyframes > 0; }
+
+    private:
+        std::vector<uint8_t> pending;
+        size_t offset = 0;                  // Начало неразобранных байтов в pending
+        std::vector<int32_t> rocketDX, rocketDY;
+        std::vector<int32_t> rocketQX, rocketQY;
+        std::vector<uint32_t> radarTurns;
+        std::vector<StreamRocket> nextRockets;
+        std::vector<int32_t> nextQX, nextQY, nextDX, nextDY;
+        std::vector<uint32_t> removed;
+
+        bool Apply(const uint8_t* data, size_t size, std::string* error);
+    };
+
+    // Сервер потока состояния для зрителей на этой же машине: Unix-сокет ("unix:/путь") или TCP на 127.0.0.1
+    // ("tcp:порт"). Поток симуляции кодирует каждое сообщение один раз и дописывает его в общий кольцевой буфер;
+    // отдельный поток сервера раздает байты из этого буфера всем зрителям неблокирующими send, у каждого зрителя
+    // только своя позиция в буфере. Симуляция никогда не ждет зрителей: медленный зритель, которого буфер
+    // обогнал больше чем на половину, переносится на последний опорный кадр, а если буфер успел перезаписать
+    // байты, которые у него в отправке, - отключается. Новый зритель начинает с последнего опорного кадра.
+    // Потоки и сокеты спрятаны в StateStream.cpp, как и в SimulationThread
+    class StateServer
+    {
+    public:
+        StateServer();
+        ~StateServer();
+
+        StateServer(const StateServer&) = delete;
+        StateServer& operator=(const StateServer&) = delete;
+
+        // Открывает адрес и запускает поток раздачи (прежний сервер останавливается). bufferBytes - размер
+        // кольцевого буфера (округляется вверх до степени двойки, см. BufferBytesFor). При ошибке - false и текст в error
+        bool Start(const std::string& address, size_t bufferBytes, std::string* error = nullptr);
+
+        // Остановка: зрителям досылается то, что уже в буфере и помещается в сокет, затем соединения закрываются
+        void Stop();
+
+        bool Running() const;
+        const std::string& Address() const;
+
+        // Новая партия: следующее сообщение - опорный кадр. Вызывается из потока, который вызывает Publish
+        void Restart();
+
+        // Кодирует состояние после шага и публикует его зрителям. Вызывается из одного потока (симуляции)
+        // и не ждет ни зрителей, ни сети
+        void Publish(const Simulation& simulation, float stepSec);
+
+        size_t Viewers() const;             // Подключенных зрителей
+        uint64_t BytesPublished() const;    // Байтов, записанных в буфер
+        uint64_t Resyncs() const;           // Сколько раз отставший зритель перенесен на опорный кадр
+        uint64_t Dropped() const;           // Сколько зрителей отключено из-за отставания
+
+        // Размер буфера, в четверть которого помещается опорный кадр с наибольшим числом ракет партии
+        static size_t BufferBytesFor(const Simulation& simulation);
+
+    private:
+        struct Impl;
+        Impl* impl;
+    };
+
+    // Подключение зрителя к StateServer (блокирующее чтение)
+    class StateClient
+    {
+    public:
+        StateClient();
+        ~StateClient();
+
+        StateClient(const StateClient&) = delete;
+        StateClient& operator=(const StateClient&) = delete;
+
+        bool Connect(const std::string& address, std::string* error = nullptr);
+        void Close();
+
+        // Ждет и читает пришедшие байты: число байтов, 0 - сервер закрыл соединение, -1 - ошибка
+        long Receive(uint8_t* buffer, size_t size, std::string* error = nullptr);
+
+    private:
+        intptr_t socket;
+    };
+}
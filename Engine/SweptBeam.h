@@ -0,0 +1,152 @@
+#pragma once
+
+#include "Vec2.h"
+#include "BinaryAngle.h"
+#include <cmath>
+
+namespace sim
+{
+    // Луч, повернувшийся за шаг симуляции от StartAngleDegrees на SweepDegrees.
+    // Нужен для непрерывной проверки перехвата: при большом шаге луч за один тик
+    // поворачивается на десятки градусов и "перепрыгивает" ракеты, если смотреть только на его конечное положение
+    struct SweptBeam
+    {
+        Vec2 Center;              // Центр радара
+        float StartAngleDegrees;  // Угол луча в начале шага
+        float SweepDegrees;       // Поворот луча за шаг (со знаком, может превышать 360)
+        float HalfWidthDegrees;   // Половина ширины луча
+        float DeadZoneRadius;     // Радиус мертвой зоны
+        float RangeR;             // Эффективная дальность луча
+    };
+
+    namespace detail
+    {
+        const float RadToDeg = 57.29577951308232f;
+
+        // Приведение угла к диапазону [-180, 180) через двоичный угол, без fmod и ветвлений
+        inline float WrapDegrees180(float angle)
+        {
+            return BinaryAngleDeltaDegrees(BinaryAngleFromDegrees(angle), 0);
+        }
+
+        // Интервал t в [lo, hi], на котором |q + v t|^2 <= r^2. Возвращает false, если он пуст
+        inline bool InsideCircleInterval(Vec2 q, Vec2 v, float r, float lo, float hi, float& t0, float& t1)
+        {
+            float a = v.X * v.X + v.Y * v.Y;
+            float b = q.X * v.X + q.Y * v.Y;
+            float c = q.X * q.X + q.Y * q.Y - r * r;
+            if (a <= 0.0f)
+            {
+                // Точка неподвижна относительно центра
+                if (c > 0.0f) return false;
+                t0 = lo; t1 = hi;
+                return true;
+            }
+            float disc = b * b - a * c;
+            if (disc < 0.0f) return false;
+            float root = std::sqrt(disc);
+            t0 = std::fmax(lo, (-b - root) / a);
+            t1 = std::fmin(hi, (-b + root) / a);
+            return t0 <= t1;
+        }
+
+        // Проверка углового окна на отрезке [s0, s1] доли шага, где дальность уже подходящая.
+        // Отрезок делится на части, за каждую из которых относительный угол "ракета - луч" меняется
+        // не больше чем на ширину окна, и внутри части угол считается линейным
+        inline bool AngularWindowHit(const SweptBeam& beam, Vec2 q, Vec2 v, float s0, float s1, float& hitTime)
+        {
+            float h = beam.HalfWidthDegrees;
+            if (h >= 180.0f)
+            {
+                hitTime = s0;
+                return true;
+            }
+            if (h <= 0.0f) return false;
+
+            Vec2 pa(q.X + v.X * s0, q.Y + v.Y * s0);
+            Vec2 pb(q.X + v.X * s1, q.Y + v.Y * s1);
+            float totalBearing = std::atan2(pa.X * pb.Y - pa.Y * pb.X, pa.X * pb.X + pa.Y * pb.Y) * RadToDeg;
+            float totalSweep = beam.SweepDegrees * (s1 - s0);
+            int parts = (int)std::ceil((std::fabs(totalBearing) + std::fabs(totalSweep)) / h);
+            if (parts < 1) parts = 1;
+            if (parts > 4096) parts = 4096;
+
+            float ds = (s1 - s0) / parts;
+            Vec2 p = pa;
+            float rel = WrapDegrees180(std::atan2(p.Y, p.X) * RadToDeg - (beam.StartAngleDegrees + beam.SweepDegrees * s0));
+            for (int k = 0; k < parts; k++)
+            {
+                float sa = s0 + ds * k;
+                float sb = (k + 1 == parts) ? s1 : sa + ds;
+                Vec2 pn(q.X + v.X * sb, q.Y + v.Y * sb);
+                float dBearing = std::atan2(p.X * pn.Y - p.Y * pn.X, p.X * pn.X + p.Y * pn.Y) * RadToDeg;
+                float relNext = rel + dBearing - beam.SweepDegrees * (sb - sa);
+
+                // Окно попадания [-h, h] повторяется через 360 градусов
+                float lo = std::fmin(rel, relNext);
+                float hi = std::fmax(rel, relNext);
+                float kMin = std::ceil((lo - h) / 360.0f);
+                float kMax = std::floor((hi + h) / 360.0f);
+                if (kMin <= kMax)
+                {
+                    // Момент входа в окно по линейной интерполяции внутри части.
+                    // Если угол убывает, первым встречается окно с наибольшим номером
+                    float window = (relNext >= rel ? kMin : kMax) * 360.0f;
+                    float target;
+                    if (rel >= window - h && rel <= window + h) target = rel;
+                    else target = rel < window ? window - h : window + h;
+                    float span = relNext - rel;
+                    float f = span != 0.0f ? (target - rel) / span : 0.0f;
+                    hitTime = sa + (sb - sa) * std::fmin(1.0f, std::fmax(0.0f, f));
+                    return true;
+                }
+
+                p = pn;
+                rel = WrapDegrees180(relNext);
+            }
+            return false;
+        }
+    }
+
+    // Непрерывная проверка перехвата за шаг: ракета летит по отрезку from -> to,
+    // а луч за это же время поворачивается на beam.SweepDegrees.
+    // Возвращает true, если в какой-то момент шага ракета была внутри луча
+    // (вне мертвой зоны, в пределах дальности, в угловом секторе); hitTime - доля шага [0, 1] в этот момент
+    inline bool SweptBeamHit(const SweptBeam& beam, Vec2 from, Vec2 to, float& hitTime)
+    {
+        Vec2 q(from.X - beam.Center.X, from.Y - beam.Center.Y);
+        Vec2 v(to.X - from.X, to.Y - from.Y);
+
+        // Интервал, на котором ракета в пределах дальности луча
+        float r0, r1;
+        if (!detail::InsideCircleInterval(q, v, beam.RangeR, 0.0f, 1.0f, r0, r1)) return false;
+
+        // Из него исключается время внутри мертвой зоны: остается до двух отрезков
+        float d0, d1;
+        if (!detail::InsideCircleInterval(q, v, beam.DeadZoneRadius, r0, r1, d0, d1))
+        {
+            return detail::AngularWindowHit(beam, q, v, r0, r1, hitTime);
+        }
+        if (d0 > r0 && detail::AngularWindowHit(beam, q, v, r0, d0, hitTime)) return true;
+        if (d1 < r1 && detail::AngularWindowHit(beam, q, v, d1, r1, hitTime)) return true;
+        return false;
+    }
+
+    // Вход ракеты в круг ядра радиуса radius за шаг: ракета летит по отрезку from -> to. При большом шаге
+    // быстрая ракета проходит ядро насквозь, и проверка одного конца шага ее пропускает.
+    // entryTime - доля шага [0, 1] в момент входа. Ракета, закончившая шаг в круге, входит всегда;
+    // ядро нулевого радиуса - точка, в нее попадает только ракета, закончившая шаг ровно в центре
+    inline bool CoreEntry(Vec2 center, float radius, Vec2 from, Vec2 to, float& entryTime)
+    {
+        bool endInside = DistanceSquared(to, center) <= radius * radius;
+        float t0 = 1.0f, t1 = 1.0f;
+        if (radius > 0.0f && detail::InsideCircleInterval(Vec2(from.X - center.X, from.Y - center.Y),
+            Vec2(to.X - from.X, to.Y - from.Y), radius, 0.0f, 1.0f, t0, t1))
+        {
+            entryTime = t0;
+            return true;
+        }
+        entryTime = 1.0f;
+        return endInside;
+    }
+}
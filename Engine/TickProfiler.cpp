@@ -0,0 +1,206 @@
+// Часы и гистограммы профилировщика фаз
+#include "TickProfiler.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define RADAR_PROFILE_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define RADAR_PROFILE_TSC 1
+#else
+#define RADAR_PROFILE_TSC 0
+#endif
+
+namespace sim
+{
+    namespace
+    {
+        uint64_t ReadClock()
+        {
+#if RADAR_PROFILE_TSC
+            return __rdtsc();
+#else
+            return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+        }
+
+        // Начальная точка для перевода тактов в наносекунды: берется при запуске программы
+        struct ClockOrigin
+        {
+            uint64_t Ticks;
+            std::chrono::steady_clock::time_point Time;
+        };
+
+        const ClockOrigin& Origin()
+        {
+            static const ClockOrigin origin = { ReadClock(), std::chrono::steady_clock::now() };
+            return origin;
+        }
+
+        const ClockOrigin& StartupOrigin = Origin();
+
+        // Наносекунд в такте: частота счетчика тактов сравнивается с монотонными часами от запуска программы
+        double NanosecondsPerTick()
+        {
+#if RADAR_PROFILE_TSC
+            const ClockOrigin& origin = Origin();
+            for (;;)
+            {
+                uint64_t ticks = ReadClock();
+                double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - origin.Time).count();
+                if (ns >= 1e6 && ticks > origin.Ticks) return ns / (double)(ticks - origin.Ticks);
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+#else
+            return 1.0;
+#endif
+        }
+
+        int HighestBit(uint64_t value)
+        {
+#if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanReverse64(&index, value);
+            return (int)index;
+#else
+            return 63 - __builtin_clzll(value);
+#endif
+        }
+
+        // Номер корзины: значения до 16 - точно, дальше по 16 корзин на степень двойки
+        int BucketOf(uint64_t value)
+        {
+            const int sub = TickProfiler::SubBuckets;
+            if (value < (uint64_t)sub) return (int)value;
+            int bit = HighestBit(value);
+            int bucket = (bit - 3) * sub + (int)((value >> (bit - 4)) & (sub - 1));
+            return bucket < TickProfiler::BucketCount ? bucket : TickProfiler::BucketCount - 1;
+        }
+
+        // Середина корзины (в тактах)
+        double BucketMiddle(int bucket)
+        {
+            const int sub = TickProfiler::SubBuckets;
+            if (bucket < sub) return bucket + 0.5;
+            int shift = bucket / sub - 1;
+            double width = (double)(1ull << shift);
+            return (double)(sub + bucket % sub) * width + width / 2.0;
+        }
+    }
+
+    const char* ProfilePhaseName(ProfilePhase phase)
+    {
+        switch (phase)
+        {
+        case ProfilePhase::Step: return "step";
+        case ProfilePhase::RadarRotation: return "radar_rotation";
+        case ProfilePhase::LauncherTimers: return "launcher_timers";
+        case ProfilePhase::LaunchSchedule: return "launch_schedule";
+        case ProfilePhase::Guidance: return "guidance";
+        case ProfilePhase::RocketMove: return "rocket_move";
+        case ProfilePhase::Interception: return "interception";
+        case ProfilePhase::Compaction: return "compaction";
+        case ProfilePhase::Publish: return "publish";
+        case ProfilePhase::TimerTick: return "timer_tick";
+        case ProfilePhase::Paint: return "paint";
+        default: return "unknown";
+        }
+    }
+
+    void ProfileSummary::Clear()
+    {
+        std::memset(Phases, 0, sizeof(Phases));
+    }
+
+    void ProfileSummary::Merge(const ProfileSummary& other)
+    {
+        for (size_t p = 0; p < (size_t)ProfilePhase::Count; p++)
+        {
+            if (other.Phases[p].Count > 0) Phases[p] = other.Phases[p];
+        }
+    }
+
+    bool ProfileSummary::WriteCsv(const std::string& path, std::string* error) const
+    {
+        FILE* file = std::fopen(path.c_str(), "w");
+        if (file == nullptr)
+        {
+            if (error) *error = "не удалось создать файл " + path;
+            return false;
+        }
+        std::fprintf(file, "phase,count,mean_us,p50_us,p99_us,max_us\n");
+        for (size_t p = 0; p < (size_t)ProfilePhase::Count; p++)
+        {
+            const PhaseSummary& phase = Phases[p];
+            if (phase.Count == 0) continue;
+            std::fprintf(file, "%s,%llu,%.3f,%.3f,%.3f,%.3f\n", ProfilePhaseName((ProfilePhase)p),
+                (unsigned long long)phase.Count, phase.MeanUs, phase.P50Us, phase.P99Us, phase.MaxUs);
+        }
+        bool written = std::fclose(file) == 0;
+        if (!written && error) *error = "ошибка записи файла " + path;
+        return written;
+    }
+
+    void TickProfiler::Reset()
+    {
+        std::memset(histograms, 0, sizeof(histograms));
+    }
+
+    void TickProfiler::Record(ProfilePhase phase, uint64_t start)
+    {
+        uint64_t now = ReadClock();
+        uint64_t elapsed = now > start ? now - start : 0;
+        Histogram& histogram = histograms[(size_t)phase];
+        histogram.Buckets[BucketOf(elapsed)]++;
+        histogram.Count++;
+        histogram.Total += elapsed;
+        if (elapsed > histogram.Max) histogram.Max = elapsed;
+    }
+
+    void TickProfiler::Summarize(ProfileSummary& out) const
+    {
+        out.Clear();
+        bool any = false;
+        for (const Histogram& histogram : histograms) any |= histogram.Count > 0;
+        if (!any) return;
+
+        const double usPerTick = NanosecondsPerTick() / 1000.0;
+        for (size_t p = 0; p < (size_t)ProfilePhase::Count; p++)
+        {
+            const Histogram& histogram = histograms[p];
+            PhaseSummary& phase = out.Phases[p];
+            phase.Count = histogram.Count;
+            if (histogram.Count == 0) continue;
+
+            // Квантиль - середина корзины, в которую попадает замер с нужным номером (не больше максимума)
+            uint64_t rank50 = (histogram.Count + 1) / 2;
+            uint64_t rank99 = histogram.Count - histogram.Count / 100;
+            double p50 = 0.0, p99 = 0.0;
+            uint64_t seen = 0;
+            for (int b = 0; b < BucketCount && seen < rank99; b++)
+            {
+                if (histogram.Buckets[b] == 0) continue;
+                uint64_t before = seen;
+                seen += histogram.Buckets[b];
+                if (before < rank50 && seen >= rank50) p50 = BucketMiddle(b);
+                if (seen >= rank99) p99 = BucketMiddle(b);
+            }
+            double max = (double)histogram.Max;
+            phase.MeanUs = (float)((double)histogram.Total / (double)histogram.Count * usPerTick);
+            phase.P50Us = (float)((p50 < max ? p50 : max) * usPerTick);
+            phase.P99Us = (float)((p99 < max ? p99 : max) * usPerTick);
+            phase.MaxUs = (float)(max * usPerTick);
+        }
+    }
+
+    uint64_t TickProfiler::ProfileClock()
+    {
+        return ReadClock();
+    }
+}
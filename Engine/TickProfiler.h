@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Профилирование фаз шага и кадра. RADAR_PROFILE=0 (опция CMake RADAR_PROFILE=OFF) убирает замеры из кода полностью
+#ifndef RADAR_PROFILE
+#define RADAR_PROFILE 1
+#endif
+
+namespace sim
+{
+    // Фазы шага симуляции и кадра окна
+    enum class ProfilePhase : uint8_t
+    {
+        Step,           // Весь Simulation::Step
+        RadarRotation,  // Вращение радаров
+        LauncherTimers, // Таймеры перезарядки установок
+        LaunchSchedule, // Общий таймер и запуск ракет
+        Guidance,       // Наведение, маневр и профиль скорости ракет (только не прямой полет)
+        RocketMove,     // Движение ракет (в непрерывной проверке и в сети радаров - вместе с перехватом)
+        Interception,   // Попадание в ядро и проверка лучом
+        Compaction,     // Удаление перехваченных ракет
+        Publish,        // Снимок состояния для окна (SimulationThread)
+        TimerTick,      // MyForm::GameTimer_Tick
+        Paint,          // MyForm::MyForm_Paint
+        Count
+    };
+
+    const char* ProfilePhaseName(ProfilePhase phase);
+
+    // Итог фазы в микросекундах
+    struct PhaseSummary
+    {
+        uint64_t Count;
+        float MeanUs;
+        float P50Us;
+        float P99Us;
+        float MaxUs;
+    };
+
+    // Итог по всем фазам: маленькая структура, ее можно копировать в каждый снимок
+    struct ProfileSummary
+    {
+        PhaseSummary Phases[(size_t)ProfilePhase::Count];
+
+        ProfileSummary() { Clear(); }
+        void Clear();
+
+        // Фазы с замерами из other заменяют свои (например, фазы окна дополняют фазы потока симуляции)
+        void Merge(const ProfileSummary& other);
+
+        // Таблица phase,count,mean_us,p50_us,p99_us,max_us; фазы без замеров пропускаются
+        bool WriteCsv(const std::string& path, std::string* error = nullptr) const;
+    };
+
+    // Гистограммы длительности фаз. Корзины логарифмические с 16 делениями на каждую степень двойки
+    // (погрешность квантиля не больше 1/16), их число постоянно, запись - без выделения памяти.
+    // Время меряется счетчиком тактов процессора (в переводе в наносекунды - только при подведении итогов),
+    // поэтому замер фазы стоит несколько наносекунд. Один профилировщик пишется из одного потока
+    class TickProfiler
+    {
+    public:
+        static const int SubBuckets = 16;
+        static const int BucketCount = SubBuckets * 45;
+
+        TickProfiler() : Enabled(true) { Reset(); }
+
+        bool Enabled; // Выключенный профилировщик ничего не записывает
+
+        void Reset();
+
+        // Запись длительности фазы, начавшейся в момент start (по ProfileClock)
+        void Record(ProfilePhase phase, uint64_t start);
+
+        // Квантили и максимум по всем записанным замерам
+        void Summarize(ProfileSummary& out) const;
+
+        // Текущее показание часов профилировщика (в тактах)
+        static uint64_t ProfileClock();
+
+    private:
+        struct Histogram
+        {
+            uint32_t Buckets[BucketCount];
+            uint64_t Count;
+            uint64_t Total;
+            uint64_t Max;
+        };
+        Histogram histograms[(size_t)ProfilePhase::Count];
+    };
+
+    // Замер фазы до конца области видимости
+    class ProfileScope
+    {
+    public:
+        ProfileScope(TickProfiler* profiler, ProfilePhase phase)
+            : profiler(profiler != nullptr && profiler->Enabled ? profiler : nullptr), phase(phase),
+              start(this->profiler != nullptr ? TickProfiler::ProfileClock() : 0) {}
+
+        ~ProfileScope()
+        {
+            if (profiler != nullptr) profiler->Record(phase, start);
+        }
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+    private:
+        TickProfiler* profiler;
+        ProfilePhase phase;
+        uint64_t start;
+    };
+}
+
+#if RADAR_PROFILE
+#define RADAR_PROFILE_JOIN2(a, b) a##b
+#define RADAR_PROFILE_JOIN(a, b) RADAR_PROFILE_JOIN2(a, b)
+#define RADAR_PROFILE_SCOPE(profiler, phase) ::sim::ProfileScope RADAR_PROFILE_JOIN(profileScope, __LINE__)(profiler, ::sim::ProfilePhase::phase)
+#else
+#define RADAR_PROFILE_SCOPE(profiler, phase) ((void)0)
+#endif
@@ -0,0 +1,235 @@
+// Шаг модели полета ракет (TrajectoryModel::Advance).
+// Файл компилируется как обычный нативный код (без /clr): циклы одни и те же,
+// но компилятор векторизует их под разные наборы инструкций, а реализация выбирается во время выполнения
+#include "Trajectory.h"
+#include "BeamKernel.h"
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define RADAR_TRAJECTORY_X86 1
+#else
+#define RADAR_TRAJECTORY_X86 0
+#endif
+
+// Общее тело циклов встраивается в функции с разрешенными AVX2 и AVX-512 и векторизуется там заново.
+// В этих наборах есть FMA, но без -ffp-contract=fast (в режиме ISO C++ он выключен) умножение
+// со сложением не сливаются, поэтому результат совпадает до бита с SSE2
+#if RADAR_TRAJECTORY_X86 && (defined(__GNUC__) || defined(__clang__))
+#define RADAR_TARGET(isa) __attribute__((target(isa)))
+#define RADAR_KERNEL_INLINE inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define RADAR_TARGET(isa)
+#define RADAR_KERNEL_INLINE __forceinline
+#else
+#define RADAR_TARGET(isa)
+#define RADAR_KERNEL_INLINE inline
+#endif
+
+namespace sim
+{
+    namespace
+    {
+        // Постоянные шага, общие для всех ракет
+        struct StepParams
+        {
+            float DeltaTime;
+            float TargetX;
+            float TargetY;
+            float CosTurn;          // Поворот курса за шаг
+            float SinTurn;
+            float WeaveTangent;
+            float WeaveTurnsPerSec;
+            float LaunchSpeed;
+            float MaxFlightSec;
+            const float* SegmentStart;
+            const float* SegmentLength;
+            const float* SegmentSlope;
+            size_t SegmentCount;
+        };
+
+        // Синус полного оборота: sin(2 pi turns) при turns в [-0.5, 0.5]. Многочлен вместо таблицы:
+        // таблица в цикле по ракетам - это выборка по индексу, а многочлен компилятор векторизует.
+        // Отрезок сводится к [-1/4, 1/4] оборота симметрией, ошибка ряда до x^9 там меньше 4e-6
+        RADAR_KERNEL_INLINE float SinTurns(float turns)
+        {
+            float folded = std::min(std::max(turns, -0.5f - turns), 0.5f - turns);
+            float x = folded * 6.28318531f;
+            float x2 = x * x;
+            float p = 2.75573192e-6f;
+            p = p * x2 - 1.98412698e-4f;
+            p = p * x2 + 8.33333333e-3f;
+            p = p * x2 - 1.66666667e-1f;
+            return x + x * x2 * p;
+        }
+
+        // Ракет в одной полосе шага: восемь массивов полосы (16 КБ) помещаются в L1
+        const size_t StripRockets = 512;
+
+        // Шаг полосы ракет: время полета, курс и вектор скорости - один цикл без ветвлений и выборок по индексу.
+        // Массивы RocketStore не пересекаются, и __restrict избавляет цикл по восьми массивам от проверок
+        // пересечения указателей, без которых компилятор его не векторизует. Профиль скорости - отдельные
+        // проходы перед ним (цикл по участкам внутри цикла по ракетам не векторизуется), полоса остается в L1
+        template <bool Pursuit, bool Weave, bool Profiled>
+        RADAR_KERNEL_INLINE size_t AdvanceStrip(const StepParams& step, size_t count, const float* __restrict x, const float* __restrict y,
+            float* __restrict vx, float* __restrict vy, float* __restrict speed, float* __restrict age, float* __restrict dirX, float* __restrict dirY)
+        {
+            // Скорость по профилю - от нового времени полета, поэтому время обновляется здесь же, отдельным проходом.
+            // Проход на каждый участок профиля, первый из них заодно задает начальную скорость
+            const float deltaTime = step.DeltaTime;
+            if (Profiled)
+            {
+                for (size_t i = 0; i < count; i++) age[i] += deltaTime;
+                const float v0 = step.LaunchSpeed;
+                for (size_t k = 0; k < step.SegmentCount; k++)
+                {
+                    const float from = step.SegmentStart[k], length = step.SegmentLength[k], slope = step.SegmentSlope[k];
+                    if (k == 0)
+                    {
+                        for (size_t i = 0; i < count; i++) speed[i] = v0 + slope * std::min(std::max(age[i] - from, 0.0f), length);
+                    }
+                    else
+                    {
+                        for (size_t i = 0; i < count; i++) speed[i] += slope * std::min(std::max(age[i] - from, 0.0f), length);
+                    }
+                }
+            }
+
+            // Время полета (без профиля), курс наведения и вектор скорости - одним циклом
+            const float limit = step.MaxFlightSec;
+            const float tx = step.TargetX, ty = step.TargetY;
+            const float cosTurn = step.CosTurn, sinTurn = step.SinTurn;
+            const float weaveTan = step.WeaveTangent;
+            const float turnsPerSec = step.WeaveTurnsPerSec;
+            size_t expired = 0;
+            for (size_t i = 0; i < count; i++)
+            {
+                float t = Profiled ? age[i] : age[i] + deltaTime;
+                if (!Profiled) age[i] = t;
+                expired += t > limit ? 1 : 0;
+
+                float hx = dirX[i], hy = dirY[i];
+                if (Pursuit)
+                {
+                    float ux = tx - x[i], uy = ty - y[i];
+                    float inv = 1.0f / std::sqrt(ux * ux + uy * uy + 1e-12f);
+                    ux *= inv;
+                    uy *= inv;
+                    // Поворот к цели на предельный угол; если цель ближе по углу - курс прямо на нее.
+                    // Выбор через вес 0/1, а не через условие - иначе компилятор не векторизует цикл
+                    float dot = hx * ux + hy * uy;
+                    float s = std::copysign(sinTurn, hx * uy - hy * ux);
+                    float rx = hx * cosTurn - hy * s;
+                    float ry = hx * s + hy * cosTurn;
+                    float snap = dot >= cosTurn ? 1.0f : 0.0f;
+                    hx = rx + (ux - rx) * snap;
+                    hy = ry + (uy - ry) * snap;
+                    dirX[i] = hx;
+                    dirY[i] = hy;
+                }
+                if (Weave)
+                {
+                    // Змейка - боковая составляющая курса tg(amplitude) * sin(2 pi t / period):
+                    // отклонение atan(tg(amplitude) * sin) доходит до amplitude, а синус и косинус отклонения не нужны.
+                    // Время полета во float не растет дальше ~2^19 с, а период не короче 0.01 с (Validate),
+                    // поэтому число оборотов помещается в int32_t
+                    float turns = t * turnsPerSec;
+                    turns -= (float)(int32_t)(turns + 0.5f);
+                    float k = weaveTan * SinTurns(turns);
+                    float inv = 1.0f / std::sqrt(1.0f + k * k);
+                    float wx = (hx - hy * k) * inv;
+                    float wy = (hy + hx * k) * inv;
+                    hx = wx;
+                    hy = wy;
+                }
+                float v = speed[i];
+                vx[i] = hx * v;
+                vy[i] = hy * v;
+            }
+            return expired;
+        }
+
+        // Шаг всех ракет полосами: каждый массив проходит через память один раз за шаг,
+        // а не по разу на каждый проход (при 10^5 ракет массивы не помещаются в кэш)
+        template <bool Pursuit, bool Weave, bool Profiled>
+        RADAR_KERNEL_INLINE size_t AdvanceWith(const StepParams& step, RocketStore& rockets)
+        {
+            const size_t count = rockets.Size();
+            size_t expired = 0;
+            for (size_t from = 0; from < count; from += StripRockets)
+            {
+                size_t n = std::min(StripRockets, count - from);
+                expired += AdvanceStrip<Pursuit, Weave, Profiled>(step, n, rockets.X.data() + from, rockets.Y.data() + from,
+                    rockets.VX.data() + from, rockets.VY.data() + from, rockets.Speed.data() + from, rockets.Age.data() + from,
+                    rockets.DirX.data() + from, rockets.DirY.data() + from);
+            }
+            return expired;
+        }
+
+        RADAR_KERNEL_INLINE size_t AdvanceVariant(int variant, const StepParams& step, RocketStore& rockets)
+        {
+            switch (variant)
+            {
+            case 0: return AdvanceWith<false, false, false>(step, rockets);
+            case 1: return AdvanceWith<false, false, true>(step, rockets);
+            case 2: return AdvanceWith<false, true, false>(step, rockets);
+            case 3: return AdvanceWith<false, true, true>(step, rockets);
+            case 4: return AdvanceWith<true, false, false>(step, rockets);
+            case 5: return AdvanceWith<true, false, true>(step, rockets);
+            case 6: return AdvanceWith<true, true, false>(step, rockets);
+            default: return AdvanceWith<true, true, true>(step, rockets);
+            }
+        }
+
+        size_t AdvanceDefault(int variant, const StepParams& step, RocketStore& rockets)
+        {
+            return AdvanceVariant(variant, step, rockets);
+        }
+
+#if RADAR_TRAJECTORY_X86
+        RADAR_TARGET("avx2")
+        size_t AdvanceAvx2(int variant, const StepParams& step, RocketStore& rockets)
+        {
+            return AdvanceVariant(variant, step, rockets);
+        }
+
+        RADAR_TARGET("avx512f,avx512vl")
+        size_t AdvanceAvx512(int variant, const StepParams& step, RocketStore& rockets)
+        {
+            return AdvanceVariant(variant, step, rockets);
+        }
+#endif
+    }
+
+    size_t TrajectoryModel::Advance(RocketStore& rockets, Vec2 target, float deltaTime) const
+    {
+        // Поворот курса за шаг: синус и косинус один раз на шаг. Без ограничения курс сразу смотрит на цель
+        const double turnRad = (double)turnRateDps * deltaTime * (3.14159265358979323846 / 180.0);
+        const bool unlimited = turnRateDps <= 0.0f || turnRad >= 3.14159265358979323846;
+
+        StepParams step;
+        step.DeltaTime = deltaTime;
+        step.TargetX = target.X;
+        step.TargetY = target.Y;
+        step.CosTurn = unlimited ? -1.0f : (float)std::cos(turnRad);
+        step.SinTurn = unlimited ? 0.0f : (float)std::sin(turnRad);
+        step.WeaveTangent = weaveTangent;
+        step.WeaveTurnsPerSec = weaveTurnsPerSec;
+        step.LaunchSpeed = launchSpeed;
+        step.MaxFlightSec = maxFlightSec;
+        step.SegmentStart = segmentStart.data();
+        step.SegmentLength = segmentLength.data();
+        step.SegmentSlope = segmentSlope.data();
+        step.SegmentCount = segmentStart.size();
+
+        int variant = (pursuit ? 4 : 0) | (weave ? 2 : 0) | (profiled ? 1 : 0);
+        switch (ActiveBeamKernelIsa())
+        {
+#if RADAR_TRAJECTORY_X86
+        case BeamKernelIsa::Avx2: return AdvanceAvx2(variant, step, rockets);
+        case BeamKernelIsa::Avx512: return AdvanceAvx512(variant, step, rockets);
+#endif
+        default: return AdvanceDefault(variant, step, rockets);
+        }
+    }
+}
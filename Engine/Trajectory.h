@@ -0,0 +1,116 @@
+#pragma once
+
+#include "ConfigData.h"
+#include "RocketStore.h"
+#include "BinaryAngle.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace sim
+{
+    // Полет ракет по модели из RocketModelConfig: наведение на цель, змейка и профиль скорости.
+    // Модель одна на всю партию, поэтому шаг всех ракет - векторизуемый проход по массивам RocketStore
+    // (полунеявный метод Эйлера: здесь обновляются скорости, а координаты по новым скоростям сдвигает
+    // обычный проход движения Simulation). У каждого сочетания наведения, змейки и профиля свой вариант циклов
+    // без ветвлений и виртуальных вызовов внутри (Trajectory.cpp); при прямом полете с постоянной скоростью
+    // шаг модели не нужен вовсе
+    class TrajectoryModel
+    {
+    public:
+        TrajectoryModel() { Configure(ConfigData()); }
+
+        void Configure(const ConfigData& config)
+        {
+            const RocketModelConfig& model = config.RocketModel;
+            straight = model.Straight();
+            pursuit = model.Guidance == RocketGuidance::Pursuit;
+            turnRateDps = model.TurnRateDps;
+            spreadDegrees = model.LaunchSpreadDegrees;
+            weave = model.WeaveAmplitudeDegrees > 0.0f;
+            weaveTangent = (float)std::tan(model.WeaveAmplitudeDegrees * (3.14159265358979323846 / 180.0));
+            weaveTurnsPerSec = 1.0f / model.WeavePeriodSec;
+
+            // Профиль скорости - сумма линейных участков: v(t) = v0 + сумма slope_k * clamp(t - t_k, 0, len_k)
+            segmentStart.clear();
+            segmentLength.clear();
+            segmentSlope.clear();
+            const std::vector<SpeedPoint>& profile = model.SpeedProfile;
+            launchSpeed = profile.empty() ? config.RocketSpeed : profile.front().Speed;
+            maxSpeed = launchSpeed;
+            // Скорости залпов сценария действуют, только пока скорость не задана профилем
+            const ScenarioSummary& scenario = config.ScenarioInfo;
+            if (profile.empty() && config.HasScenario()) maxSpeed = std::max(maxSpeed, scenario.FastestSpeed);
+            for (size_t k = 1; k < profile.size(); k++)
+            {
+                float length = profile[k].TimeSec - profile[k - 1].TimeSec;
+                segmentStart.push_back(profile[k - 1].TimeSec);
+                segmentLength.push_back(length);
+                segmentSlope.push_back(length > 0.0f ? (profile[k].Speed - profile[k - 1].Speed) / length : 0.0f);
+                maxSpeed = std::max(maxSpeed, profile[k].Speed);
+            }
+            profiled = !segmentStart.empty();
+
+            // Без явного предела ракета живет втрое дольше прямого полета от самой дальней установки до центра
+            // на конечной скорости: с разбросом курса или змейкой она может пройти мимо цели и не вернуться
+            maxFlightSec = model.MaxFlightSec;
+            float cruiseSpeed = profile.empty() ? config.RocketSpeed : profile.back().Speed;
+            if (profile.empty() && config.HasScenario() && scenario.SlowestSpeed > 0.0f) cruiseSpeed = std::min(cruiseSpeed, scenario.SlowestSpeed);
+            if (maxFlightSec <= 0.0f)
+            {
+                maxFlightSec = !straight && cruiseSpeed > 0.0f
+                    ? 3.0f * config.LaunchDistance() * 1.41421356f / cruiseSpeed
+                    : std::numeric_limits<float>::infinity();
+            }
+        }
+
+        // Прямой полет с постоянной скоростью: Advance не нужен
+        bool Straight() const { return straight; }
+
+        float LaunchSpeed() const { return launchSpeed; }
+        float MaxSpeed() const { return maxSpeed; }
+        float MaxFlightSec() const { return maxFlightSec; }
+
+        // Курс при запуске: ракета, выпущенная на цель target, отклоняется на угол в пределах +-половины разброса.
+        // randomBits - случайное число ракеты (по ее номеру, поэтому курс не зависит от порядка вызовов).
+        // Возвращает единичный курс: при нулевой начальной скорости профиля его не восстановить из скорости
+        Vec2 Launch(Rocket& rocket, Vec2 target, uint64_t randomBits) const
+        {
+            float dx = target.X - rocket.Position.X;
+            float dy = target.Y - rocket.Position.Y;
+            float length = std::sqrt(dx * dx + dy * dy);
+            Vec2 heading = length > 0.0f ? Vec2(dx / length, dy / length) : Vec2(0.0f, 0.0f);
+            if (spreadDegrees <= 0.0f) return heading;
+
+            float unit = (float)(randomBits >> 40) * (1.0f / 16777216.0f);
+            BinaryAngle turn = BinaryAngleFromDegrees((unit - 0.5f) * spreadDegrees);
+            float c = Cos(turn), s = Sin(turn);
+            heading = Vec2(heading.X * c - heading.Y * s, heading.X * s + heading.Y * c);
+            rocket.Velocity = Vec2(heading.X * rocket.Speed, heading.Y * rocket.Speed);
+            return heading;
+        }
+
+        // Шаг модели для всех ракет: время полета, курс наведения, скорость и вектор скорости.
+        // Возвращает число ракет, которые летят дольше MaxFlightSec (их удаляет Simulation).
+        // Циклы векторизуются под набор инструкций, выбранный для проверки лучом (ActiveBeamKernelIsa),
+        // результат от набора инструкций не зависит
+        size_t Advance(RocketStore& rockets, Vec2 target, float deltaTime) const;
+
+    private:
+        bool straight;
+        bool pursuit;
+        bool weave;
+        bool profiled;
+        float turnRateDps;
+        float spreadDegrees;
+        float weaveTangent;       // Тангенс амплитуды змейки
+        float weaveTurnsPerSec;   // Частота змейки (оборотов фазы в секунду)
+        float launchSpeed;
+        float maxSpeed;
+        float maxFlightSec;
+        std::vector<float> segmentStart;
+        std::vector<float> segmentLength;
+        std::vector<float> segmentSlope;
+    };
+}
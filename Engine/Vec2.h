@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cmath>
+
+namespace sim
+{
+    // Нативная замена System::Drawing::PointF для симуляции без WinForms
+    struct Vec2
+    {
+        float X; // Координата X в игровом мире
+        float Y; // Координата Y в игровом мире
+
+        Vec2() : X(0.0f), Y(0.0f) {}
+        Vec2(float x, float y) : X(x), Y(y) {}
+    };
+
+    // Квадрат расстояния между двумя точками (без извлечения корня)
+    inline float DistanceSquared(Vec2 a, Vec2 b)
+    {
+        float dx = a.X - b.X;
+        float dy = a.Y - b.Y;
+        return dx * dx + dy * dy;
+    }
+
+    // Расстояние между двумя точками по теореме Пифагора
+    inline float Distance(Vec2 a, Vec2 b)
+    {
+        return std::sqrt(DistanceSquared(a, b));
+    }
+}
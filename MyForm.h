@@ -1,6 +1,6 @@
 #pragma once
 
-#include "Config.h"   
+#include "Engine/SimulationThread.h"
 #include "Rocket.h"     
 #include "Launcher.h"   
 #include "Radar.h"      
@@ -41,36 +41,44 @@ namespace radar // Объявление пространства имен для
 			{
 				gameTimer->Stop();
 			}
+			this->!MyForm();
+		}
+
+		// Финализатор: останавливает поток симуляции и освобождает его, если деструктор не был вызван
+		!MyForm()
+		{
+			delete simulationThread;
+			simulationThread = nullptr;
+			delete uiProfiler;
+			uiProfiler = nullptr;
+			delete staticLayer;
+			staticLayer = nullptr;
 		}
 
 	private: System::Windows::Forms::Timer^ gameTimer; // Главный таймер, который управляет игровым циклом
 	private:
 		// Переменные для хранения состояния игры
-		ConfigData^ config; // Объект с параметрами игры, загруженными из файла
-		Radar^ radar; // Объект радара
-		List<Launcher^>^ launchers; // Список всех пусковых установок
-		List<Rocket^>^ activeRockets; // Список всех активных ракет в данный момент
+		// Вся игровая логика (радар, установки, ракеты, счетчики) живет в нативной симуляции,
+		// которая идет в собственном потоке. Форма по таймеру только забирает последний снимок состояния и рисует его
+		sim::SimulationThread* simulationThread; // Поток симуляции и обмен снимками
 		PointF worldOriginOffset; // Смещение центра игрового мира относительно левого верхнего угла окна
-
-		// Счетчики и флаги состояния игры 
-		int rocketsLaunchedCount; // Сколько всего ракет было запущено
-		int rocketsInterceptedCount; // Сколько ракет было перехвачено
-		bool gameOver; // Флаг, который становится true, когда игра окончена
 		String^ gameStatusMessage; // Сообщение, отображаемое на экране (например, "Победа" или "Поражение")
-
-		// Переменные для управления последовательным запуском ракет 
-		float timeUntilNextPossibleLaunchSec; // Общий таймер, отсчитывающий время до следующего запуска
-		bool canLaunchNextRocketFlag; // Флаг, разрешающий запуск следующей ракеты
-		int nextLauncherIndex; // Индекс следующей пусковой установки, которая будет стрелять
+		// Фоновый слой: черный фон, зоны радаров и пусковые установки, нарисованные один раз.
+		// Перестраивается при изменении размера окна, перезапуске игры, уничтожении радара и правке settings.txt
+		Bitmap^ staticLayer;
+		int staticLayerDestroyedRadars; // Сколько радаров было уничтожено, когда строился слой
+		unsigned int staticLayerConfigVersion; // Версия конфигурации партии, по которой строился слой
+		// Замеры фаз кадра (таймер и отрисовка); фазы шага замеряет поток симуляции и передает в снимке.
+		// F3 показывает таблицу замеров рядом со строкой состояния, F4 сохраняет ее в profile.csv
+		sim::TickProfiler* uiProfiler;
+		bool profileOverlay;
+		// Перемотка (F5 - до обнаружения, F6 - до перехвата, F7 - на минуту вперед, Esc - отмена):
+		// шагает поток симуляции, окно только показывает снимки и итог, когда перемотка кончится.
+		// Номер последнего запроса перемотки, 0 - перемотки нет
+		unsigned int pendingWarp;
 	private: System::ComponentModel::IContainer^ components; // Контейнер для компонентов, управляемый дизайнером
 
 
-	private:
-		// Предикат для поиска - в текущей версии кода не используется, но может быть полезен для List::RemoveAll
-		static bool Predicate_IsRocketInactiveAndIntercepted(Rocket^ r) 
-		{
-			return !r->IsActive && r->IsIntercepted;
-		}
 
 #pragma region Windows Form Designer generated code
 		// Метод, автоматически сгенерированный дизайнером Windows Forms
@@ -82,7 +90,7 @@ namespace radar // Объявление пространства имен для
 			this->SuspendLayout();
 
 			// Настройка игрового таймера
-			this->gameTimer->Interval = 33; // Интервал примерно 30 кадров в секунду (1000мс / 30fps ? 33мс)
+			this->gameTimer->Interval = 33; // Интервал перерисовки, уточняется по render_rate_hz в LoadAndInitializeGame
 			this->gameTimer->Tick += gcnew System::EventHandler(this, &MyForm::GameTimer_Tick); // Привязка обработчика события Tick
 
 			// Настройка самой формы
@@ -97,6 +105,7 @@ namespace radar // Объявление пространства имен для
 			this->Load += gcnew System::EventHandler(this, &MyForm::MyForm_Load);
 			this->Paint += gcnew System::Windows::Forms::PaintEventHandler(this, &MyForm::MyForm_Paint);
 			this->Resize += gcnew System::EventHandler(this, &MyForm::MyForm_Resize);
+			this->KeyDown += gcnew System::Windows::Forms::KeyEventHandler(this, &MyForm::MyForm_KeyDown);
 			this->ResumeLayout(false);
 
 		}
@@ -107,40 +116,39 @@ namespace radar // Объявление пространства имен для
 		void LoadAndInitializeGame() 
 		{
 			// Создаем объект конфигурации и загружаем данные из файла
-			config = gcnew ConfigData();
-			config->LoadFromFile("settings.txt"); // Файл должен лежать в папке с exe-файлом
+			sim::ConfigData config;
+			std::string error;
+			if (!config.LoadFromFile("settings.txt", &error)) // Файл должен лежать в папке с exe-файлом
+			{
+				String^ errorText = gcnew String(error.c_str(), 0, (int)error.size(), System::Text::Encoding::UTF8);
+				MessageBox::Show("Ошибка загрузки конфигурации: " + errorText + "\nИспользуются значения по умолчанию.", "Ошибка конфигурации");
+			}
 
 			// Определяем центр окна как начало мировых координат (0,0)
 			worldOriginOffset = PointF(this->ClientSize.Width / 2.0f, this->ClientSize.Height / 2.0f);
 
-			// Создаем радар в центре игрового мира с параметрами из конфига
-			radar = gcnew Radar(PointF(0, 0), config->RadarRotationSpeedDps, config->RadarBeamWidthDegrees,
-				config->RadarMaxDetectionRangeP, config->RadarBeamEffectiveRadiusR,
-				config->RadarCircularAttackRange, config->RadarCoreVulnerabilityRadius,
-				config->RadarDeadZoneRadius);
-
-			// Создаем пусковые установки по углам квадрата вокруг центра
-			launchers = gcnew List<Launcher^>();
-			// Вычисляем смещение по X и Y для расположения установок
-			float d = (float)(config->DistanceCornerToCenter / Math::Sqrt(2.0));
-			launchers->Add(gcnew Launcher(PointF(-d, -d), 0, config->LaunchIntervalMinSec, config->LaunchIntervalMaxSec)); // Верхняя левая
-			launchers->Add(gcnew Launcher(PointF(d, -d), 1, config->LaunchIntervalMinSec, config->LaunchIntervalMaxSec));  // Верхняя правая
-			launchers->Add(gcnew Launcher(PointF(d, d), 2, config->LaunchIntervalMinSec, config->LaunchIntervalMaxSec));   // Нижняя правая
-			launchers->Add(gcnew Launcher(PointF(-d, d), 3, config->LaunchIntervalMinSec, config->LaunchIntervalMaxSec));  // Нижняя левая
-
-			// Инициализируем список для активных ракет
-			activeRockets = gcnew List<Rocket^>();
-
-			// Сбрасываем все игровые счетчики и флаги в начальное состояние
-			rocketsLaunchedCount = 0;
-			rocketsInterceptedCount = 0;
-			gameOver = false;
-			gameStatusMessage = "Игра началась, защищайте радар";
+			// Создаем (или перезапускаем) симуляцию: радар в центре, установки по углам квадрата или из сценария (scenario).
+			// seed берется из random_seed в settings.txt, а если его нет - выбирается случайно
+			if (simulationThread == nullptr)
+			{
+				simulationThread = new sim::SimulationThread();
+			}
+			if (uiProfiler == nullptr)
+			{
+				uiProfiler = new sim::TickProfiler();
+			}
+			uiProfiler->Reset();
+			// Поток симуляции идет фиксированными шагами 1 / sim_rate_hz, а таймер окна только задает частоту кадров.
+			// Правки settings.txt во время партии применяются к ней на границе шага, без перезапуска
+			simulationThread->Start(config, "settings.txt");
+			if (config.RenderRateHz > 0)
+			{
+				gameTimer->Interval = Math::Max(1, (int)(1000.0f / config.RenderRateHz));
+			}
 
-			// Сбрасываем таймеры запуска ракет
-			timeUntilNextPossibleLaunchSec = 0; // Первая ракета может стартовать немедленно
-			canLaunchNextRocketFlag = true;
-			nextLauncherIndex = 0; // Начинаем с первой пусковой установки
+			gameStatusMessage = "Игра началась, защищайте радар";
+			pendingWarp = 0;
+			InvalidateStaticLayer();
 
 			// Запускаем игровой таймер, если он существует
 			if (gameTimer) gameTimer->Start();
@@ -157,16 +165,39 @@ namespace radar // Объявление пространства имен для
 		{
 			// Пересчитываем положение центра мира при изменении размера окна
 			worldOriginOffset = PointF(this->ClientSize.Width / 2.0f, this->ClientSize.Height / 2.0f);
+			InvalidateStaticLayer();
 			// Вызываем принудительную перерисовку окна
 			this->Invalidate();
 		}
 
-		// Главный игровой цикл, вызывается по таймеру
+		// Цикл отрисовки, вызывается по таймеру. Симуляция идет в своем потоке и от таймера не зависит
 		System::Void GameTimer_Tick(System::Object^ sender, System::EventArgs^ e) 
 		{
+			RADAR_PROFILE_SCOPE(uiProfiler, TimerTick);
+			const sim::SimSnapshot& snapshot = simulationThread->AcquireSnapshot();
+
+			// Правка settings.txt во время партии: итог - в строку состояния, частота кадров - из новой конфигурации
+			std::string configMessage = simulationThread->TakeConfigMessage();
+			if (!configMessage.empty())
+			{
+				gameStatusMessage = "settings.txt - " + gcnew String(configMessage.c_str(), 0, (int)configMessage.size(), System::Text::Encoding::UTF8);
+			}
+			// Перемотка кончилась (цель, отмена или правка): партия снова идет в реальном времени
+			if (pendingWarp != 0 && snapshot.WarpSerial >= pendingWarp && !snapshot.Warping)
+			{
+				pendingWarp = 0;
+				gameStatusMessage = String::Format("Перемотка окончена: шаг {0}, {1:F1} с игры", snapshot.TickCount, snapshot.ElapsedSec);
+			}
+			if (snapshot.RenderRateHz > 0)
+			{
+				int interval = Math::Max(1, (int)(1000.0f / snapshot.RenderRateHz));
+				if (gameTimer->Interval != interval) gameTimer->Interval = interval;
+			}
+
 			// Блок проверки окончания игры 
-			if (gameOver) 
+			if (snapshot.GameOver) 
 			{
+				gameStatusMessage = GetOutcomeMessage(snapshot);
 				gameTimer->Stop(); // Останавливаем игровой цикл
 				this->Invalidate(); // Перерисовываем экран, чтобы показать финальное сообщение
 
@@ -191,173 +222,196 @@ namespace radar // Объявление пространства имен для
 				return; // Выходим из текущего тика, так как игра либо перезапущена, либо закрыта
 			}
 
-			// Вычисляем время, прошедшее с последнего кадра, в секундах
-			float deltaTime = (float)gameTimer->Interval / 1000.0f;
-
-			// 1, Обновление состояния радара (вращение)
-			radar->Update(deltaTime);
+			// В конце каждого кадра запрашиваем перерисовку формы
+			this->Invalidate();
+		}
 
-			// 2, Обновление собственных таймеров пусковых установок
-			for each(Launcher ^ launcher in launchers) 
+		// Текст итога партии для строки состояния и финального окна
+		String^ GetOutcomeMessage(const sim::SimSnapshot& snapshot)
+		{
+			switch (snapshot.Result)
 			{
-				launcher->UpdateOwnTimer(deltaTime);
+			case sim::Outcome::RadarDestroyed:
+				return "Радар уничтожен";
+			case sim::Outcome::Victory:
+				return "ПОБЕДА, Все ракеты перехвачены";
+			case sim::Outcome::DefenseFailed:
+				return String::Format("ЗАЩИТА ПРОВАЛЕНА, Запущено: {0}, Перехвачено: {1}", snapshot.TotalRocketsToLaunch, snapshot.RocketsInterceptedCount);
+			default:
+				return gameStatusMessage;
 			}
+		}
 
-			// 3, Логика последовательного запуска ракет
-			// Уменьшаем общий таймер ожидания
-			if (timeUntilNextPossibleLaunchSec > 0) 
+		// Сбрасывает фоновый слой: он будет построен заново при следующей отрисовке
+		void InvalidateStaticLayer()
+		{
+			delete staticLayer;
+			staticLayer = nullptr;
+		}
+
+		// Строит фоновый слой, если его нет или он устарел: все, что не движется между кадрами
+		void EnsureStaticLayer(const sim::SimSnapshot& snapshot)
+		{
+			int destroyedRadars = snapshot.DestroyedRadarCount();
+			int width = Math::Max(1, this->ClientSize.Width);
+			int height = Math::Max(1, this->ClientSize.Height);
+			if (staticLayer != nullptr && staticLayerDestroyedRadars == destroyedRadars
+				&& staticLayerConfigVersion == snapshot.ConfigVersion
+				&& staticLayer->Width == width && staticLayer->Height == height)
 			{
-				timeUntilNextPossibleLaunchSec -= deltaTime;
-			}
-			else {
-				// Когда таймер истек, разрешаем запуск
-				canLaunchNextRocketFlag = true;
+				return;
 			}
 
-			// Если можно запускать и еще не все ракеты запущены
-			if (canLaunchNextRocketFlag && rocketsLaunchedCount < config->TotalRocketsToLaunch) 
+			InvalidateStaticLayer();
+			// Формат с предумноженной альфой копируется на экран быстрее всего
+			staticLayer = gcnew Bitmap(width, height, System::Drawing::Imaging::PixelFormat::Format32bppPArgb);
+			Graphics^ g = Graphics::FromImage(staticLayer);
+			g->SmoothingMode = System::Drawing::Drawing2D::SmoothingMode::AntiAlias;
+			g->Clear(Color::Black);
+			Radar::DrawStatic(g, snapshot.MainRadar, worldOriginOffset);
+			for (const sim::Radar& radar : snapshot.SupportRadars)
 			{
-				// Выбираем текущую пусковую установку
-				Launcher^ currentLauncher = launchers[nextLauncherIndex];
-
-				// Проверяем, готова ли стрелять именно эта установка (ее личный таймер)
-				if (currentLauncher->TimeToNextLaunchSec <= 0) {
-					// Если готова, производим запуск
-					Rocket^ newRocket = currentLauncher->Fire(radar->Position, config->RocketSpeed);
-					activeRockets->Add(newRocket);
-					rocketsLaunchedCount++;
-
-					// Устанавливаем общую задержку до следующего ВОЗМОЖНОГО запуска
-					timeUntilNextPossibleLaunchSec = (float)Launcher::SharedRandom->NextDouble() *
-						(config->LaunchIntervalMaxSec - config->LaunchIntervalMinSec) +
-						config->LaunchIntervalMinSec;
-					canLaunchNextRocketFlag = false; // Запрещаем запуск до истечения таймера
-
-					// Переходим к следующей установке по кругу
-					nextLauncherIndex = (nextLauncherIndex + 1) % launchers->Count;
-				}
+				Radar::DrawStatic(g, radar, worldOriginOffset);
+			}
+			for (const sim::Launcher& launcher : snapshot.Launchers)
+			{
+				Launcher::Draw(g, launcher, worldOriginOffset);
 			}
+			delete g;
+			staticLayerDestroyedRadars = destroyedRadars;
+			staticLayerConfigVersion = snapshot.ConfigVersion;
+		}
 
+		// Метод отрисовки, вызывается каждый раз, когда нужно перерисовать окно
+		System::Void MyForm_Paint(System::Object^ sender, System::Windows::Forms::PaintEventArgs^ e) 
+		{
+			RADAR_PROFILE_SCOPE(uiProfiler, Paint);
+			// Получаем объект Graphics для рисования
+			Graphics^ g = e->Graphics;
 
-			// 4, Обновление ракет и проверка столкновений
-			// Идем по списку с конца, чтобы безопасно удалять элементы
-			for (int i = activeRockets->Count - 1; i >= 0; i--) 
+			// Без симуляции рисовать нечего, кроме фона
+			if (simulationThread == nullptr)
 			{
-				Rocket^ rocket = activeRockets[i];
-				if (!rocket->IsActive) // Пропускаем уже неактивные ракеты
-				{ 
-					continue;
-				}
+				g->Clear(Color::Black);
+				return;
+			}
+			// Последний опубликованный снимок: поток симуляции его больше не трогает, копия не нужна
+			const sim::SimSnapshot& snapshot = simulationThread->AcquireSnapshot();
 
-				rocket->Update(deltaTime); // Обновляем позицию ракеты
+			// Фон, зоны радаров и пусковые установки копируются из готового слоя без сглаживания и пересчета
+			EnsureStaticLayer(snapshot);
+			g->CompositingMode = System::Drawing::Drawing2D::CompositingMode::SourceCopy;
+			g->DrawImageUnscaled(staticLayer, 0, 0);
+			g->CompositingMode = System::Drawing::Drawing2D::CompositingMode::SourceOver;
 
-				// Проверка на уничтожение радара
-				if (rocket->GetDistanceTo(radar->Position) <= radar->CoreVulnerabilityRadius) 
-				{
-					radar->IsDestroyed = true;
-					gameOver = true;
-					gameStatusMessage = "Радар уничтожен";
-					break; // Немедленно выходим из цикла, игра окончена
-				}
+			// Включаем сглаживание для более красивой графики
+			g->SmoothingMode = System::Drawing::Drawing2D::SmoothingMode::AntiAlias;
 
-				// Попытка перехвата ракеты радаром
-				if (!radar->IsDestroyed && radar->DetectAndIntercept(rocket)) 
-				{
-					rocketsInterceptedCount++;
-					// Флаг IsActive станет false внутри метода DetectAndIntercept
-				}
+			// Доля шага, прошедшая после последнего шага симуляции: объекты рисуются между двумя шагами
+			float alpha = snapshot.AlphaAt(sim::SimulationThread::NowSec());
+			// Лучи радаров - главного и дополнительных (radar_site в settings.txt)
+			Radar::DrawBeam(g, snapshot.MainRadar, worldOriginOffset, snapshot.BeamAngleAt(snapshot.MainRadar, alpha));
+			for (const sim::Radar& radar : snapshot.SupportRadars)
+			{
+				Radar::DrawBeam(g, radar, worldOriginOffset, snapshot.BeamAngleAt(radar, alpha));
 			}
 
-			// Если игра закончилась из-за уничтожения радара, выходим из этого тика
-			if (gameOver) 
+			// Рисуем активные ракеты прямо из снимка
+			Rocket::Draw(g, snapshot.Rockets, worldOriginOffset, snapshot.InterpolationBackstepSec(alpha));
+
+			// Выводим на экран текстовую информацию о состоянии игры
+			int supportAlive = 0;
+			for (const sim::Radar& radar : snapshot.SupportRadars)
 			{
-				this->Invalidate(); // Запрашиваем перерисовку, чтобы показать уничтоженный радар
-				return;
+				if (!radar.IsDestroyed) supportAlive++;
 			}
-
-			// Удаляем все неактивные ракеты из списка
-			// (проверка отдельным циклом для ясности)
-			for (int i = activeRockets->Count - 1; i >= 0; i--)
+			String^ statusText = String::Format(
+				"Запущено ракет: {0}/{1}\nПерехвачено: {2}\nСостояние радара: {3}\n{4}",
+				snapshot.RocketsLaunchedCount, snapshot.TotalRocketsToLaunch,
+				snapshot.RocketsInterceptedCount,
+				snapshot.MainRadar.IsDestroyed ? "УНИЧТОЖЕН" : "РАБОТАЕТ",
+				gameStatusMessage
+			);
+			if (!snapshot.SupportRadars.empty())
 			{
-				if (!activeRockets[i]->IsActive) 
-				{
-					activeRockets->RemoveAt(i);
-				}
+				statusText += String::Format("\nРадары сети: {0}/{1} в строю", supportAlive, (int)snapshot.SupportRadars.size());
 			}
+			g->DrawString(statusText, this->Font, Brushes::LightGreen, 10, 10);
 
-
-			// 5, Проверка условий победы или поражения (если радар еще цел)
-			if (!gameOver) 
+			// Замеры фаз справа от строки состояния
+			if (profileOverlay)
 			{
-				// Если все запланированные ракеты запущены и на поле больше нет активных ракет
-				if (rocketsLaunchedCount >= config->TotalRocketsToLaunch && activeRockets->Count == 0) 
-				{
-					// Все ракеты были сбиты - это победа
-					if (rocketsInterceptedCount == config->TotalRocketsToLaunch) 
-					{
-						gameStatusMessage = "ПОБЕДА, Все ракеты перехвачены";
-					}
-					else // Некоторые ракеты пролетели мимо, но не попали в ядро
-					{ 
-						gameStatusMessage = String::Format("ЗАЩИТА ПРОВАЛЕНА, Запущено: {0}, Перехвачено: {1}", config->TotalRocketsToLaunch, rocketsInterceptedCount);
-					}
-					gameOver = true; // В любом случае игра окончена
-				}
+				g->DrawString(GetProfileText(snapshot), this->Font, Brushes::LightGreen, 260, 10);
 			}
-			// В конце каждого кадра запрашиваем перерисовку формы
-			this->Invalidate();
 		}
 
-		// Метод отрисовки, вызывается каждый раз, когда нужно перерисовать окно
-		System::Void MyForm_Paint(System::Object^ sender, System::Windows::Forms::PaintEventArgs^ e) 
+		// Итог замеров: фазы шага из снимка и фазы кадра окна
+		sim::ProfileSummary GetProfileSummary(const sim::SimSnapshot& snapshot)
 		{
-			// Получаем объект Graphics для рисования
-			Graphics^ g = e->Graphics;
-			// Включаем сглаживание для более красивой графики
-			g->SmoothingMode = System::Drawing::Drawing2D::SmoothingMode::AntiAlias;
-
-			// Очищаем экран черным цветом
-			g->Clear(Color::Black);
+			sim::ProfileSummary summary = snapshot.Profile;
+			sim::ProfileSummary frame;
+			uiProfiler->Summarize(frame);
+			summary.Merge(frame);
+			return summary;
+		}
 
-			// Рисуем радар, если он был создан
-			if (radar != nullptr) 
+		// Таблица замеров для экрана: по строке на фазу, время в микросекундах
+		String^ GetProfileText(const sim::SimSnapshot& snapshot)
+		{
+			sim::ProfileSummary summary = GetProfileSummary(snapshot);
+			String^ text = "Фаза: p50 / p99 / max, мкс";
+			for (int p = 0; p < (int)sim::ProfilePhase::Count; p++)
 			{
-				radar->Draw(g, worldOriginOffset);
+				const sim::PhaseSummary& phase = summary.Phases[p];
+				if (phase.Count == 0) continue;
+				text += String::Format("\n{0}: {1:F1} / {2:F1} / {3:F1}", gcnew String(sim::ProfilePhaseName((sim::ProfilePhase)p)),
+					phase.P50Us, phase.P99Us, phase.MaxUs);
 			}
+			return text;
+		}
 
-			// Рисуем пусковые установки, если они были созданы
-			if (launchers != nullptr) 
+		// F3 - показать или скрыть замеры фаз, F4 - сохранить их в profile.csv рядом с exe-файлом,
+		// F5/F6/F7 - перемотка до обнаружения, до перехвата, на минуту игры вперед, Esc - отмена перемотки
+		System::Void MyForm_KeyDown(System::Object^ sender, System::Windows::Forms::KeyEventArgs^ e)
+		{
+			if (simulationThread == nullptr) return;
+			if (e->KeyCode == Keys::F3)
 			{
-				for each(Launcher ^ launcher in launchers) 
-				{
-					launcher->Draw(g, worldOriginOffset);
-				}
+				profileOverlay = !profileOverlay;
+				this->Invalidate();
 			}
-
-			// Рисуем активные ракеты
-			if (activeRockets != nullptr) 
+			else if (e->KeyCode == Keys::F4)
 			{
-				// Копируем список, чтобы избежать ошибок, если он изменится во время отрисовки (маловероятно, но безопасно)
-				List<Rocket^>^ rocketsToDraw = gcnew List<Rocket^>(activeRockets);
-				for each(Rocket ^ rocket in rocketsToDraw) 
+				std::string error;
+				bool written = GetProfileSummary(simulationThread->AcquireSnapshot()).WriteCsv("profile.csv", &error);
+				gameStatusMessage = written ? "Замеры сохранены в profile.csv"
+					: "Замеры не сохранены: " + gcnew String(error.c_str(), 0, (int)error.size(), System::Text::Encoding::UTF8);
+				this->Invalidate();
+			}
+			else if (e->KeyCode == Keys::F5 || e->KeyCode == Keys::F6 || e->KeyCode == Keys::F7)
+			{
+				const sim::SimSnapshot& snapshot = simulationThread->AcquireSnapshot();
+				sim::WarpGoal goal(sim::WarpGoal::Detection);
+				String^ target = "до обнаружения";
+				if (e->KeyCode == Keys::F6)
+				{
+					goal = sim::WarpGoal(sim::WarpGoal::Interception);
+					target = "до перехвата";
+				}
+				else if (e->KeyCode == Keys::F7)
 				{
-					// Рисуем только активные или только что перехваченные ракеты
-					if (rocket->IsActive || (rocket->IsIntercepted && !rocket->IsActive)) 
-					{
-						rocket->Draw(g, worldOriginOffset);
-					}
+					uint64_t minuteTicks = snapshot.StepSec > 0.0 ? (uint64_t)Math::Ceiling(60.0 / snapshot.StepSec) : 1800;
+					goal = sim::WarpGoal(sim::WarpGoal::Tick, snapshot.TickCount + minuteTicks);
+					target = "на минуту вперед";
 				}
+				pendingWarp = simulationThread->Warp(goal);
+				gameStatusMessage = "Перемотка " + target + "... (Esc - отмена)";
+				this->Invalidate();
+			}
+			else if (e->KeyCode == Keys::Escape)
+			{
+				if (pendingWarp != 0) simulationThread->CancelWarp();
 			}
-
-			// Выводим на экран текстовую информацию о состоянии игры
-			String^ statusText = String::Format(
-				"Запущено ракет: {0}/{1}\nПерехвачено: {2}\nСостояние радара: {3}\n{4}",
-				rocketsLaunchedCount, config->TotalRocketsToLaunch,
-				rocketsInterceptedCount,
-				(radar != nullptr && radar->IsDestroyed) ? "УНИЧТОЖЕН" : "РАБОТАЕТ",
-				gameStatusMessage
-			);
-			g->DrawString(statusText, this->Font, Brushes::LightGreen, 10, 10);
 		}
 	}; // конец класса MyForm
 #pragma endregion
@@ -0,0 +1,388 @@
+// Замеры горячих путей симуляции: отдельные функции ракеты и радара и полный шаг симуляции
+// при 10, 10^3, 10^5 и 10^6 ракет. Результат - таблица через табуляцию, по строке на замер,
+// в одном и том же порядке, поэтому два прогона сравниваются обычным diff:
+//   ./build/radar_bench > before.tsv
+//   ./build/radar_bench > after.tsv
+#include "Engine/Simulation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Счетчик выделений памяти во всей программе (operator new заменен ниже)
+    std::atomic<uint64_t> AllocationCount(0);
+
+    // Выделение и освобождение для замененных operator new/delete. Не встраиваются: иначе GCC видит
+    // malloc в new и free в delete в одном месте и ругается (-Wmismatched-new-delete), хотя пара и согласована
+#if defined(__GNUC__)
+#define RADAR_NOINLINE __attribute__((noinline))
+#else
+#define RADAR_NOINLINE
+#endif
+
+    RADAR_NOINLINE void* CountedAlloc(std::size_t size)
+    {
+        AllocationCount.fetch_add(1, std::memory_order_relaxed);
+        if (void* p = std::malloc(size != 0 ? size : 1)) return p;
+        throw std::bad_alloc();
+    }
+
+    RADAR_NOINLINE void CountedFree(void* p) noexcept
+    {
+        std::free(p);
+    }
+}
+
+void* operator new(std::size_t size) { return CountedAlloc(size); }
+void* operator new[](std::size_t size) { return CountedAlloc(size); }
+void operator delete(void* p) noexcept { CountedFree(p); }
+void operator delete[](void* p) noexcept { CountedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { CountedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { CountedFree(p); }
+
+namespace
+{
+    // Параметры командной строки
+    struct Options
+    {
+        std::vector<size_t> Sizes = { 10, 1000, 100000, 1000000 };
+        std::string Only;           // Только замеры, в имени которых есть эта строка
+        double MinTimeSec = 0.25;   // Сколько времени набирать на один замер
+    };
+
+    void PrintUsage(const char* program)
+    {
+        std::printf(
+            "Использование: %s [параметры]\n"
+            "  --sizes <N,N,...>  числа ракет (по умолчанию 10,1000,100000,1000000)\n"
+            "  --only <строка>    только замеры, в имени которых есть строка (например, tick)\n"
+            "  --min-time <сек>   время на один замер (по умолчанию 0.25)\n"
+            "  --help             эта справка\n"
+            "Колонки: benchmark, rockets, passes - сколько раз пройдены все ракеты (или шагов симуляции),\n"
+            "ns_per_rocket - медиана времени прохода на одну ракету, ticks_per_sec - проходов в секунду,\n"
+            "allocs_per_tick - выделений памяти на проход\n",
+            program);
+    }
+
+    // Не дает компилятору выбросить вычисление, результат которого не используется
+    template <typename T>
+    inline void KeepValue(const T& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        volatile T sink = value;
+        (void)sink;
+#endif
+    }
+
+    double NowSec()
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    struct Measurement
+    {
+        uint64_t Passes;
+        double NsPerRocket;
+        double PassesPerSec;
+        double AllocsPerPass;
+    };
+
+    // Прогон pass() пачками: размер пачки подбирается так, чтобы пять пачек заняли minTimeSec.
+    // Время прохода - медиана по пачкам (устойчивее среднего к помехам), выделения - по всем проходам
+    template <typename Pass>
+    Measurement Measure(size_t rockets, double minTimeSec, Pass pass)
+    {
+        const int Repeats = 5;
+        pass(); // Разгон: кэши, ленивые выделения рабочих массивов
+
+        uint64_t batch = 1;
+        for (;;)
+        {
+            double started = NowSec();
+            for (uint64_t i = 0; i < batch; i++) pass();
+            double elapsed = NowSec() - started;
+            double target = minTimeSec / Repeats;
+            if (elapsed >= target) break;
+            uint64_t estimate = elapsed > 0.0 ? (uint64_t)(batch * target / elapsed * 1.1) + 1 : batch * 10;
+            batch = std::max(batch * 2, std::min(estimate, batch * 100));
+        }
+
+        double perPass[Repeats];
+        uint64_t allocations = 0;
+        for (int r = 0; r < Repeats; r++)
+        {
+            uint64_t allocationsBefore = AllocationCount.load(std::memory_order_relaxed);
+            double started = NowSec();
+            for (uint64_t i = 0; i < batch; i++) pass();
+            perPass[r] = (NowSec() - started) / batch;
+            allocations += AllocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+        }
+        std::sort(perPass, perPass + Repeats);
+        double median = perPass[Repeats / 2];
+
+        Measurement result;
+        result.Passes = batch * Repeats;
+        result.NsPerRocket = median * 1e9 / (double)std::max<size_t>(rockets, 1);
+        result.PassesPerSec = median > 0.0 ? 1.0 / median : 0.0;
+        result.AllocsPerPass = (double)allocations / (double)result.Passes;
+        return result;
+    }
+
+    void Report(const char* name, size_t rockets, const Measurement& m)
+    {
+        std::printf("%s\t%zu\t%llu\t%.3f\t%.1f\t%.3f\n", name, rockets, (unsigned long long)m.Passes,
+            m.NsPerRocket, m.PassesPerSec, m.AllocsPerPass);
+        std::fflush(stdout);
+    }
+
+    // Ракеты, летящие к радару из случайных точек круга радиусом в полторы дальности обнаружения:
+    // часть из них в луче, часть в мертвой зоне, часть вне дальности
+    std::vector<sim::Rocket> MakeRockets(const sim::ConfigData& config, size_t count, uint64_t seed)
+    {
+        sim::RandomStream random(seed, 0);
+        float radius = config.RadarMaxDetectionRangeP * 1.5f;
+        std::vector<sim::Rocket> rockets;
+        rockets.reserve(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            float r = radius * std::sqrt(random.NextFloat());
+            float angle = random.NextRange(0.0f, 2.0f * (float)M_PI);
+            rockets.push_back(sim::Rocket(sim::Vec2(r * std::cos(angle), r * std::sin(angle)), sim::Vec2(0, 0), config.RocketSpeed));
+        }
+        return rockets;
+    }
+
+    // Партия с count неподвижными ракетами в кольце за дальностью луча: каждый шаг проходит
+    // полный путь (движение, ядро, проверка лучом), но число ракет не меняется от шага к шагу.
+    // Запуски отключены: счетчик запущенных уже равен общему числу
+    void FillSimulation(sim::Simulation& simulation, size_t count, uint64_t seed)
+    {
+        sim::RandomStream random(seed, 1);
+        float inner = simulation.MainRadar.BeamEffectiveRadiusR * 1.05f;
+        float outer = simulation.MainRadar.MaxDetectionRangeP * 3.0f;
+        simulation.ActiveRockets.Reserve(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            float r = std::sqrt(inner * inner + (outer * outer - inner * inner) * random.NextFloat());
+            float angle = random.NextRange(0.0f, 2.0f * (float)M_PI);
+            sim::Vec2 position(r * std::cos(angle), r * std::sin(angle));
+            simulation.AddRocket(sim::Rocket(position, position, 0.0f));
+        }
+        simulation.Config.TotalRocketsToLaunch = (int)count;
+        simulation.RocketsLaunchedCount = (int)count;
+    }
+
+    bool Selected(const Options& options, const char* name)
+    {
+        return options.Only.empty() || std::strstr(name, options.Only.c_str()) != nullptr;
+    }
+
+    void RunSize(const Options& options, size_t count)
+    {
+        const sim::ConfigData config;
+        const float deltaTime = 1.0f / 30.0f;
+        const uint64_t seed = 12345;
+
+        if (Selected(options, "rocket_update"))
+        {
+            std::vector<sim::Rocket> rockets = MakeRockets(config, count, seed);
+            Report("rocket_update", count, Measure(count, options.MinTimeSec, [&]()
+            {
+                for (sim::Rocket& rocket : rockets) rocket.Update(deltaTime);
+                KeepValue(rockets.data());
+            }));
+        }
+
+        if (Selected(options, "rocket_distance"))
+        {
+            std::vector<sim::Rocket> rockets = MakeRockets(config, count, seed);
+            sim::Vec2 center(0, 0);
+            Report("rocket_distance", count, Measure(count, options.MinTimeSec, [&]()
+            {
+                float sum = 0.0f;
+                for (const sim::Rocket& rocket : rockets) sum += rocket.GetDistanceTo(center);
+                KeepValue(sum);
+            }));
+        }
+
+        if (Selected(options, "angle_normalize") || Selected(options, "angle_difference"))
+        {
+            sim::RandomStream random(seed, 2);
+            std::vector<float> a(count), b(count);
+            for (size_t i = 0; i < count; i++)
+            {
+                a[i] = random.NextRange(-1080.0f, 1080.0f);
+                b[i] = random.NextRange(-1080.0f, 1080.0f);
+            }
+            if (Selected(options, "angle_normalize"))
+            {
+                Report("angle_normalize", count, Measure(count, options.MinTimeSec, [&]()
+                {
+                    float sum = 0.0f;
+                    for (size_t i = 0; i < count; i++) sum += sim::Radar::NormalizeAngle(a[i]);
+                    KeepValue(sum);
+                }));
+            }
+            if (Selected(options, "angle_difference"))
+            {
+                Report("angle_difference", count, Measure(count, options.MinTimeSec, [&]()
+                {
+                    float sum = 0.0f;
+                    for (size_t i = 0; i < count; i++) sum += sim::Radar::AngleDifference(a[i], b[i]);
+                    KeepValue(sum);
+                }));
+            }
+        }
+
+        // Поштучная проверка ракет радаром. Луч поворачивается на каждом проходе;
+        // перехваченная ракета сразу возвращается в полет, чтобы все проходы были одинаковыми
+        if (Selected(options, "radar_detect"))
+        {
+            std::vector<sim::Rocket> rockets = MakeRockets(config, count, seed);
+            sim::Radar radar(sim::Vec2(0, 0), config.RadarRotationSpeedDps, config.RadarBeamWidthDegrees,
+                config.RadarMaxDetectionRangeP, config.RadarBeamEffectiveRadiusR, config.RadarCircularAttackRange,
+                config.RadarCoreVulnerabilityRadius, config.RadarDeadZoneRadius);
+            Report("radar_detect", count, Measure(count, options.MinTimeSec, [&]()
+            {
+                radar.Angle += sim::BinaryAngleFromDegrees(7.0);
+                size_t hits = 0;
+                for (sim::Rocket& rocket : rockets)
+                {
+                    if (radar.DetectAndIntercept(rocket))
+                    {
+                        hits++;
+                        rocket.IsActive = true;
+                        rocket.IsIntercepted = false;
+                    }
+                }
+                KeepValue(hits);
+            }));
+        }
+
+        // Пакетная проверка по массивам координат - то, чем пользуется Simulation::Step
+        if (Selected(options, "detect_batch"))
+        {
+            std::vector<sim::Rocket> rockets = MakeRockets(config, count, seed);
+            std::vector<float> x(count), y(count);
+            std::vector<uint8_t> hit(count);
+            for (size_t i = 0; i < count; i++)
+            {
+                x[i] = rockets[i].Position.X;
+                y[i] = rockets[i].Position.Y;
+            }
+            sim::Radar radar(sim::Vec2(0, 0), config.RadarRotationSpeedDps, config.RadarBeamWidthDegrees,
+                config.RadarMaxDetectionRangeP, config.RadarBeamEffectiveRadiusR, config.RadarCircularAttackRange,
+                config.RadarCoreVulnerabilityRadius, config.RadarDeadZoneRadius);
+            Report("detect_batch", count, Measure(count, options.MinTimeSec, [&]()
+            {
+                radar.Angle += sim::BinaryAngleFromDegrees(7.0);
+                size_t hits = sim::DetectBatch(radar.GetBeamSector(), x.data(), y.data(), count, hit.data());
+                KeepValue(hits);
+            }));
+        }
+
+        // Полный шаг симуляции: обычный путь, с индексом по секторам, с замером фаз (цена профилировщика)
+        // и с наведением, змейкой и профилем скорости (цена модели полета; профиль держит скорость нулевой,
+        // чтобы ракеты оставались на месте и число проверок лучом не менялось)
+        const char* tickNames[] = { "tick", "tick_bucket_index", "tick_profiled", "tick_maneuvering" };
+        for (int variant = 0; variant < 4; variant++)
+        {
+            if (!Selected(options, tickNames[variant])) continue;
+            sim::ConfigData tickConfig = config;
+            tickConfig.RadarBucketIndex = variant == 1;
+            if (variant == 3)
+            {
+                tickConfig.RocketModel.Guidance = sim::RocketGuidance::Pursuit;
+                tickConfig.RocketModel.TurnRateDps = 90.0f;
+                tickConfig.RocketModel.WeaveAmplitudeDegrees = 10.0f;
+                tickConfig.RocketModel.SpeedProfile = { sim::SpeedPoint{ 0.0f, 0.0f }, sim::SpeedPoint{ 1.0f, 0.0f }, sim::SpeedPoint{ 3.0f, 0.0f } };
+            }
+            sim::Simulation simulation(tickConfig, seed);
+            FillSimulation(simulation, count, seed);
+            sim::TickProfiler profiler;
+            if (variant == 2) simulation.Profiler = &profiler;
+            Report(tickNames[variant], count, Measure(count, options.MinTimeSec, [&]()
+            {
+                simulation.Step(deltaTime);
+            }));
+        }
+
+        // Шаг идущего боя: ракета стартует на каждом шаге, а луч во весь круг перехватывает каждую на дальности R,
+        // так что ракеты непрерывно добавляются и удаляются. Проверка, что такой шаг не выделяет память
+        if (Selected(options, "tick_launching"))
+        {
+            sim::ConfigData launchConfig = config;
+            launchConfig.TotalRocketsToLaunch = 1 << 30;
+            launchConfig.LaunchIntervalMinSec = 0.0f;
+            launchConfig.LaunchIntervalMaxSec = 0.0f;
+            launchConfig.RadarBeamWidthDegrees = 360.0f;
+            sim::Simulation simulation(launchConfig, seed);
+            FillSimulation(simulation, count, seed);
+            simulation.Config.TotalRocketsToLaunch = launchConfig.TotalRocketsToLaunch;
+            simulation.RocketsLaunchedCount = 0;
+            Report("tick_launching", count, Measure(count, options.MinTimeSec, [&]()
+            {
+                simulation.Step(deltaTime);
+            }));
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--help" || arg == "-h")
+        {
+            PrintUsage(argv[0]);
+            return 0;
+        }
+        else if (arg == "--sizes" && hasValue)
+        {
+            options.Sizes.clear();
+            for (const char* p = argv[++i]; *p; )
+            {
+                char* end = nullptr;
+                unsigned long long size = std::strtoull(p, &end, 10);
+                if (end == p || size == 0)
+                {
+                    std::fprintf(stderr, "Числа ракет задаются списком через запятую, например 10,1000\n");
+                    return 2;
+                }
+                options.Sizes.push_back((size_t)size);
+                p = *end == ',' ? end + 1 : end;
+            }
+        }
+        else if (arg == "--only" && hasValue)
+        {
+            options.Only = argv[++i];
+        }
+        else if (arg == "--min-time" && hasValue)
+        {
+            options.MinTimeSec = std::strtod(argv[++i], nullptr);
+        }
+        else
+        {
+            std::fprintf(stderr, "Неизвестный параметр: %s\n", arg.c_str());
+            PrintUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    std::printf("benchmark\trockets\tpasses\tns_per_rocket\tticks_per_sec\tallocs_per_tick\n");
+    for (size_t count : options.Sizes) RunSize(options, count);
+    return 0;
+}
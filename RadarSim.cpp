@@ -0,0 +1,755 @@
+// Консольный запуск симуляции без окна.
+// Прогоняет полную партию по settings.txt с максимальной скоростью, не привязываясь к реальному времени,
+// либо пакет из многих независимых партий на всех ядрах, либо перебор параметров
+#include "Engine/Simulation.h"
+#include "Engine/BatchRunner.h"
+#include "Engine/EventSimulation.h"
+#include "Engine/ParameterSweep.h"
+#include "Engine/FrameExporter.h"
+#include "Engine/Replay.h"
+#include "Engine/ConfigWatcher.h"
+#include "Engine/StateStream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+
+namespace
+{
+    // Параметры командной строки
+    struct Options
+    {
+        std::string SettingsPath = "settings.txt";
+        float DeltaTime = 0.0f;     // 0 - взять фиксированный шаг из конфигурации
+        uint64_t Seed = 0;
+        bool HasSeed = false;       // Задан ли --seed (иначе random_seed из settings.txt или случайный)
+        uint64_t MaxTicks = 0;
+        bool Swept = false;
+        bool EventDriven = false;   // Событийный движок вместо пошагового
+        int BatchRuns = 0;          // 0 - одиночная партия
+        int Threads = 0;            // 0 - по числу ядер
+        sim::SweepOptions Sweep;    // Оси перебора (--sweep) и его параметры
+        bool ExportFrames = false;  // Записывать кадры партии (--frames или --frames-pipe)
+        sim::FrameExportOptions Frames;
+        int FrameEveryTicks = 0;    // 0 - по render_rate_hz из settings.txt
+        std::string RecordPath;     // Записать партию в файл (--record)
+        uint32_t KeyframeEvery = 0; // Шагов между опорными кадрами записи (0 - около двух секунд)
+        std::string ReplayPath;     // Проиграть запись вместо новой партии (--replay)
+        uint64_t ReplayTick = 0;    // Шаг записи для --at
+        bool HasReplayTick = false;
+        bool Watch = false;         // Применять правки settings.txt к идущей партии (--watch)
+        std::string ProfilePath;    // Записать замеры фаз шага в CSV (--profile)
+        bool HasUntil = false;      // Остановиться на цели перемотки (--until)
+        sim::WarpGoal Until;
+        std::string ServeAddress;   // Раздавать состояние зрителям, играя в реальном времени (--serve)
+        std::string ViewAddress;    // Смотреть партию, которую раздает другой процесс (--view)
+        Options() { Frames.DropWhenBusy = false; } // Консольная партия не привязана ко времени: полная запись важнее
+    };
+
+    void PrintUsage(const char* program)
+    {
+        std::printf(
+            "Использование: %s [settings.txt] [параметры]\n"
+            "  --dt <сек>         шаг симуляции (по умолчанию 1 / sim_rate_hz из settings.txt)\n"
+            "  --seed <число>     seed партии (по умолчанию random_seed из settings.txt или случайный)\n"
+            "  --max-ticks <N>    остановиться после N шагов\n"
+            "  --swept            непрерывная проверка перехвата по всему повороту луча (для больших --dt)\n"
+            "  --event            событийный движок: без шагов, по очереди событий (запуск, перехват, ядро)\n"
+            "  --batch <N>        сыграть N независимых партий и вывести статистику\n"
+            "  --threads <N>      число потоков для --batch и --sweep (по умолчанию по числу ядер)\n"
+            "  --sweep <ключ=min:max:count | ключ=v1,v2,...>\n"
+            "                     перебрать значения ключа settings.txt (можно несколько раз - сетка по всем осям)\n"
+            "  --sweep-runs <N>   партий в точке перебора (по умолчанию 200)\n"
+            "  --sweep-round <N>  партий в раунде, после которого отсекаются проигрывающие точки (по умолчанию 25)\n"
+            "  --no-cutoff        не отсекать точки досрочно\n"
+            "  --adaptive <N>     после сетки N раз сузить ее вдвое вокруг лучшей точки\n"
+            "  --objective <win_rate|intercepted>  метрика сравнения точек (по умолчанию win_rate)\n"
+            "  --frames <шаблон>  записать кадры партии в файлы, например frames/f_%%05d.png (.png или .ppm)\n"
+            "  --frames-pipe <команда>  передавать сырые кадры rgb24 на стандартный ввод команды, например\n"
+            "                     \"ffmpeg -f rawvideo -pix_fmt rgb24 -s 800x600 -r 60 -i - out.mp4\"\n"
+            "  --frame-size <ШxВ> размер кадра (по умолчанию 800x600)\n"
+            "  --frame-every <N>  кадр каждые N шагов (по умолчанию по render_rate_hz)\n"
+            "  --frames-drop      пропускать кадры, если запись отстает (по умолчанию симуляция ждет записи)\n"
+            "  --record <файл>    записать партию (запуски, перехваты, радары, опорные кадры) в двоичный файл\n"
+            "  --keyframe-every <N>  шагов между опорными кадрами записи (по умолчанию около 2 с игрового времени)\n"
+            "  --replay <файл>    проиграть запись: состояние на шаге --at <N> или кадры (--frames, --frames-pipe)\n"
+            "  --watch            применять правки settings.txt к идущей партии между шагами (для долгих прогонов)\n"
+            "  --profile <файл>   замерить фазы шага (p50/p99/max) и записать их в CSV\n"
+            "  --until <detection|interception|tick=N>  остановиться на первом входе ракеты в зону обнаружения,\n"
+            "                     на первом перехвате или на шаге N (перемотка долгой партии к интересному месту)\n"
+            "  --serve <адрес>    играть в реальном времени и раздавать состояние зрителям: unix:/путь или tcp:порт\n"
+            "  --view <адрес>     подключиться к раздаче и печатать состояние после каждого сообщения\n"
+            "  --help             эта справка\n",
+            program);
+    }
+
+    const char* OutcomeName(sim::Outcome outcome)
+    {
+        switch (outcome)
+        {
+        case sim::Outcome::Victory: return "victory";
+        case sim::Outcome::DefenseFailed: return "defense_failed";
+        case sim::Outcome::RadarDestroyed: return "radar_destroyed";
+        default: return "in_progress";
+        }
+    }
+
+    // Перебор параметров: таблица метрик по точкам, отсеченные точки помечены
+    int RunSweepMode(const sim::ConfigData& config, const Options& options)
+    {
+        sim::SweepOptions sweep = options.Sweep;
+        sweep.Threads = options.Threads;
+        sweep.BaseSeed = options.Seed;
+        sweep.DeltaTime = options.DeltaTime;
+        sweep.MaxTicks = options.MaxTicks;
+        sweep.EventDriven = options.EventDriven;
+
+        sim::SweepResult result;
+        std::string error;
+        auto started = std::chrono::steady_clock::now();
+        if (!sim::RunSweep(config, sweep, result, &error))
+        {
+            std::fprintf(stderr, "Ошибка перебора: %s\n", error.c_str());
+            return 2;
+        }
+        double wallSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+        // Таблица через табуляцию: оси, затем метрики
+        for (const sim::SweepAxis& axis : sweep.Axes) std::printf("%s\t", axis.Key.c_str());
+        std::printf("round\truns\tpruned\tscore\tscore_ci_low\tscore_ci_high\twin_rate\tintercepted_mean\tbreach_time_p50_sec\n");
+        for (const sim::SweepPointResult& point : result.Points)
+        {
+            for (size_t a = 0; a < sweep.Axes.size(); a++)
+            {
+                std::printf("%s\t", sim::FormatSweepValue(sweep.Axes[a], point.Values[a]).c_str());
+            }
+            std::printf("%d\t%d\t%d\t%.4f\t%.4f\t%.4f\t%.4f\t%.3f\t%.3f\n",
+                point.Round, point.RunsDone, point.Pruned ? 1 : 0, point.Score, point.ScoreCi.Low, point.ScoreCi.High,
+                point.Stats.WinRate, point.Stats.InterceptMean, point.Stats.BreachTimeP50);
+        }
+
+        std::printf("\npoints=%zu\n", result.Points.size());
+        std::printf("base_seed=%llu\n", (unsigned long long)options.Seed);
+        std::printf("engagements=%llu\n", (unsigned long long)result.Engagements);
+        if (result.BestIndex >= 0)
+        {
+            const sim::SweepPointResult& best = result.Points[result.BestIndex];
+            std::printf("best=");
+            for (size_t a = 0; a < sweep.Axes.size(); a++)
+            {
+                std::printf("%s%s=%s", a ? "," : "", sweep.Axes[a].Key.c_str(), sim::FormatSweepValue(sweep.Axes[a], best.Values[a]).c_str());
+            }
+            std::printf("\nbest_score=%.4f\n", best.Score);
+        }
+        std::printf("wall_time_sec=%.6f\n", wallSec);
+        std::printf("engagements_per_sec=%.1f\n", wallSec > 0 ? result.Engagements / wallSec : 0.0);
+        return 0;
+    }
+
+    // Кадр каждые столько шагов: --frame-every или по render_rate_hz
+    uint64_t FrameEveryTicks(const sim::ConfigData& config, const Options& options, float deltaTime)
+    {
+        if (options.FrameEveryTicks > 0) return (uint64_t)options.FrameEveryTicks;
+        return (uint64_t)std::max(1.0, std::round(config.RenderRateHz > 0.0f ? 1.0 / (deltaTime * config.RenderRateHz) : 1.0));
+    }
+
+    // Проигрывание записи: состояние на одном шаге или кадры всей партии
+    int RunReplay(const sim::ConfigData& config, const Options& options)
+    {
+        sim::ReplayReader reader;
+        std::string error;
+        auto started = std::chrono::steady_clock::now();
+        if (!reader.Open(options.ReplayPath, &error))
+        {
+            std::fprintf(stderr, "Ошибка чтения записи: %s\n", error.c_str());
+            return 2;
+        }
+        double openSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        const sim::ReplayHeader& header = reader.Header();
+
+        std::printf("seed=%llu\n", (unsigned long long)header.Seed);
+        std::printf("ticks=%llu\n", (unsigned long long)header.TickCount);
+        std::printf("keyframes=%llu\n", (unsigned long long)header.KeyframeCount);
+        std::printf("keyframe_interval=%u\n", header.KeyframeInterval);
+        std::printf("radars=%u\n", header.RadarCount);
+        std::printf("outcome=%s\n", OutcomeName((sim::Outcome)header.Result));
+        std::printf("open_time_sec=%.6f\n", openSec);
+
+        sim::SimSnapshot snapshot;
+        if (options.ExportFrames)
+        {
+            sim::FrameExporter exporter;
+            if (!exporter.Open(options.Frames, &error))
+            {
+                std::fprintf(stderr, "Ошибка записи кадров: %s\n", error.c_str());
+                return 2;
+            }
+            uint64_t frameEvery = FrameEveryTicks(config, options, header.StepSec);
+            for (uint64_t tick = 0; tick <= header.TickCount; tick += frameEvery)
+            {
+                if (!reader.Seek(tick, snapshot, &error)) break;
+                exporter.Submit(snapshot);
+            }
+            bool written = exporter.Close(&error) && error.empty();
+            std::printf("frames_written=%llu\n", (unsigned long long)exporter.FramesWritten());
+            if (!written)
+            {
+                std::fprintf(stderr, "Ошибка: %s\n", error.c_str());
+                return 2;
+            }
+            return 0;
+        }
+
+        uint64_t tick = options.HasReplayTick ? options.ReplayTick : header.TickCount;
+        started = std::chrono::steady_clock::now();
+        if (!reader.Seek(tick, snapshot, &error))
+        {
+            std::fprintf(stderr, "Ошибка чтения записи: %s\n", error.c_str());
+            return 2;
+        }
+        double seekSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+        std::printf("at_tick=%llu\n", (unsigned long long)snapshot.TickCount);
+        std::printf("sim_time_sec=%.3f\n", snapshot.ElapsedSec);
+        std::printf("launched=%d/%d\n", snapshot.RocketsLaunchedCount, snapshot.TotalRocketsToLaunch);
+        std::printf("intercepted=%d\n", snapshot.RocketsInterceptedCount);
+        std::printf("rockets_in_flight=%zu\n", snapshot.Rockets.Size());
+        std::printf("radar_angle_deg=%.2f\n", snapshot.MainRadar.AngleDegrees());
+        std::printf("radars_destroyed=%d\n", snapshot.DestroyedRadarCount());
+        std::printf("seek_time_sec=%.6f\n", seekSec);
+        return 0;
+    }
+
+    // Одиночная партия событийным движком
+    int RunSingleEvent(const sim::ConfigData& config, const Options& options)
+    {
+        std::string reason;
+        if (!sim::EventSimulation::Supports(config, &reason))
+        {
+            std::fprintf(stderr, "%s\n", reason.c_str());
+            return 2;
+        }
+        sim::EventSimulation simulation(config, options.Seed);
+        float deltaTime = options.DeltaTime > 0.0f ? options.DeltaTime : (config.SimRateHz > 0.0f ? 1.0f / config.SimRateHz : 0.033f);
+
+        auto started = std::chrono::steady_clock::now();
+        sim::Outcome outcome = simulation.RunToEnd(options.MaxTicks > 0 ? (double)options.MaxTicks * deltaTime : 0.0);
+        double wallSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+        std::printf("outcome=%s\n", OutcomeName(outcome));
+        std::printf("seed=%llu\n", (unsigned long long)options.Seed);
+        std::printf("launched=%d/%d\n", simulation.RocketsLaunchedCount, simulation.Config.TotalRocketsToLaunch);
+        std::printf("intercepted=%d\n", simulation.RocketsInterceptedCount);
+        std::printf("events=%llu\n", (unsigned long long)simulation.EventCount);
+        std::printf("sim_time_sec=%.3f\n", simulation.ElapsedSec);
+        std::printf("wall_time_sec=%.6f\n", wallSec);
+
+        return outcome == sim::Outcome::Victory ? 0 : 1;
+    }
+
+    // Зритель раздачи (--view): строка состояния после каждого сообщения, итог - в конце партии
+    int RunView(const Options& options)
+    {
+        sim::StateClient client;
+        std::string error;
+        if (!client.Connect(options.ViewAddress, &error))
+        {
+            std::fprintf(stderr, "Ошибка подключения: %s\n", error.c_str());
+            return 2;
+        }
+        sim::StateStreamDecoder decoder;
+        std::vector<uint8_t> buffer(1 << 16);
+        uint64_t received = 0;
+        while (!decoder.GameOver)
+        {
+            long got = client.Receive(buffer.data(), buffer.size(), &error);
+            if (got < 0)
+            {
+                std::fprintf(stderr, "Ошибка чтения: %s\n", error.c_str());
+                return 2;
+            }
+            if (got == 0) break;
+            received += (uint64_t)got;
+            decoder.Feed(buffer.data(), (size_t)got);
+            int next;
+            while (!decoder.GameOver && (next = decoder.Next(&error)) > 0)
+            {
+                std::printf("tick=%llu launched=%d/%d intercepted=%d rockets=%zu radar_angle_deg=%.2f\n",
+                    (unsigned long long)decoder.TickCount, decoder.Launched, decoder.Total, decoder.Intercepted,
+                    decoder.Rockets.size(), sim::BinaryAngleToDegrees(decoder.Radars[0].Angle));
+                if (options.MaxTicks > 0 && decoder.Messages >= options.MaxTicks) return 0;
+            }
+            if (next < 0)
+            {
+                std::fprintf(stderr, "Ошибка потока: %s\n", error.c_str());
+                return 2;
+            }
+        }
+        std::printf("outcome=%s\n", OutcomeName(decoder.Result));
+        std::printf("messages=%llu\n", (unsigned long long)decoder.Messages);
+        std::printf("keyframes=%llu\n", (unsigned long long)decoder.Keyframes);
+        std::printf("bytes=%llu\n", (unsigned long long)received);
+        return decoder.GameOver ? 0 : 1;
+    }
+
+    // Одиночная партия с подробным выводом
+    int RunSingle(const sim::ConfigData& config, const Options& options)
+    {
+        if (options.EventDriven) return RunSingleEvent(config, options);
+
+        sim::Simulation simulation(config, options.Seed);
+        if (!simulation.ScenarioError().empty())
+        {
+            std::fprintf(stderr, "Ошибка сценария: %s\n", simulation.ScenarioError().c_str());
+            return 2;
+        }
+        float deltaTime = options.DeltaTime > 0.0f ? options.DeltaTime : simulation.FixedStepSec();
+
+        // Запись кадров: симуляция только снимает состояние, рисование и запись - в фоновом потоке
+        sim::FrameExporter exporter;
+        uint64_t frameEvery = FrameEveryTicks(config, options, deltaTime);
+        if (options.ExportFrames)
+        {
+            std::string error;
+            if (!exporter.Open(options.Frames, &error))
+            {
+                std::fprintf(stderr, "Ошибка записи кадров: %s\n", error.c_str());
+                return 2;
+            }
+            exporter.Submit(simulation);
+        }
+
+        // Запись партии: события каждого шага и опорные кадры
+        sim::ReplayRecorder recorder;
+        bool recording = !options.RecordPath.empty();
+        if (recording)
+        {
+            std::string error;
+            if (!recorder.Open(options.RecordPath, simulation, deltaTime, options.KeyframeEvery, &error))
+            {
+                std::fprintf(stderr, "Ошибка записи партии: %s\n", error.c_str());
+                return 2;
+            }
+        }
+
+        // Замеры фаз шага
+        sim::TickProfiler profiler;
+        bool profiling = !options.ProfilePath.empty();
+        if (profiling) simulation.Profiler = &profiler;
+
+        // Слежение за settings.txt: разбор в фоновом потоке, применение между шагами
+        sim::ConfigWatcher watcher;
+        sim::ConfigData update;
+        uint64_t rejectedSeen = 0;
+        if (options.Watch)
+        {
+            std::string error;
+            if (!watcher.Start(options.SettingsPath, &error))
+            {
+                std::fprintf(stderr, "Ошибка слежения за настройками: %s\n", error.c_str());
+                return 2;
+            }
+        }
+
+        // Раздача состояния: партия идет в реальном времени, чтобы зрителям было что смотреть
+        sim::StateServer server;
+        const bool serving = !options.ServeAddress.empty();
+        if (serving)
+        {
+            std::string error;
+            if (!server.Start(options.ServeAddress, sim::StateServer::BufferBytesFor(simulation), &error))
+            {
+                std::fprintf(stderr, "Ошибка раздачи состояния: %s\n", error.c_str());
+                return 2;
+            }
+            server.Publish(simulation, deltaTime);
+            std::fprintf(stderr, "stream=%s\n", options.ServeAddress.c_str());
+        }
+
+        auto started = std::chrono::steady_clock::now();
+        auto nextStep = started;
+        sim::Outcome outcome;
+        bool reached = false;
+        if (options.ExportFrames || recording || options.Watch || options.HasUntil || serving)
+        {
+            while (!simulation.GameOver && (options.MaxTicks == 0 || simulation.TickCount < options.MaxTicks))
+            {
+                if (serving)
+                {
+                    nextStep += std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(deltaTime));
+                    std::this_thread::sleep_until(nextStep);
+                }
+                if (options.Watch)
+                {
+                    if (watcher.TakeUpdate(update))
+                    {
+                        if (options.Swept) update.RadarSweptBeam = true;
+                        // Шаг записи партии задан в заголовке файла и меняться не может, а запись поддерживает только прямой полет
+                        if (recording)
+                        {
+                            update.SimRateHz = simulation.Config.SimRateHz;
+                            update.RocketModel = simulation.Config.RocketModel;
+                        }
+                        std::string keys;
+                        if (simulation.ApplyConfig(update, &keys) > 0)
+                        {
+                            if (options.DeltaTime <= 0.0f) deltaTime = simulation.FixedStepSec();
+                            std::fprintf(stderr, "config_applied tick=%llu keys=%s\n", (unsigned long long)simulation.TickCount, keys.c_str());
+                        }
+                    }
+                    if (watcher.Rejected() != rejectedSeen)
+                    {
+                        rejectedSeen = watcher.Rejected();
+                        std::fprintf(stderr, "config_rejected tick=%llu error=%s\n", (unsigned long long)simulation.TickCount, watcher.LastError().c_str());
+                    }
+                }
+                if (options.HasUntil) reached = simulation.WarpStep(options.Until, deltaTime) && !simulation.GameOver;
+                else simulation.Step(deltaTime);
+                if (recording) recorder.Record(simulation);
+                if (serving) server.Publish(simulation, deltaTime);
+                if (options.ExportFrames && (simulation.TickCount % frameEvery == 0 || simulation.GameOver)) exporter.Submit(simulation);
+                if (reached) break;
+            }
+            outcome = simulation.Result;
+        }
+        else
+        {
+            outcome = simulation.RunToEnd(deltaTime, options.MaxTicks);
+        }
+        double wallSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        // Сценарий, изменившийся во время партии, обрывается на последнем прочитанном залпе
+        if (!simulation.ScenarioError().empty()) std::fprintf(stderr, "Ошибка сценария: %s\n", simulation.ScenarioError().c_str());
+
+        std::printf("outcome=%s\n", OutcomeName(outcome));
+        std::printf("seed=%llu\n", (unsigned long long)options.Seed);
+        std::printf("launched=%d/%d\n", simulation.RocketsLaunchedCount, simulation.Config.TotalRocketsToLaunch);
+        std::printf("intercepted=%d\n", simulation.RocketsInterceptedCount);
+        std::printf("ticks=%llu\n", (unsigned long long)simulation.TickCount);
+        std::printf("sim_time_sec=%.3f\n", simulation.ElapsedSec);
+        std::printf("wall_time_sec=%.6f\n", wallSec);
+        std::printf("ticks_per_sec=%.0f\n", wallSec > 0 ? simulation.TickCount / wallSec : 0.0);
+        if (options.HasUntil) std::printf("until_reached=%d\n", reached ? 1 : 0);
+        if (serving)
+        {
+            server.Stop();
+            std::printf("stream_bytes=%llu\n", (unsigned long long)server.BytesPublished());
+            std::printf("stream_resyncs=%llu\n", (unsigned long long)server.Resyncs());
+            std::printf("stream_dropped=%llu\n", (unsigned long long)server.Dropped());
+        }
+        if (recording)
+        {
+            std::string error;
+            if (!recorder.Close(simulation, &error))
+            {
+                std::fprintf(stderr, "Ошибка записи партии: %s\n", error.c_str());
+                return 2;
+            }
+            std::printf("record_bytes=%llu\n", (unsigned long long)recorder.BytesWritten());
+        }
+        if (profiling)
+        {
+            sim::ProfileSummary summary;
+            profiler.Summarize(summary);
+            std::string error;
+            if (!summary.WriteCsv(options.ProfilePath, &error))
+            {
+                std::fprintf(stderr, "Ошибка записи замеров: %s\n", error.c_str());
+                return 2;
+            }
+            std::printf("profile_csv=%s\n", options.ProfilePath.c_str());
+        }
+        if (options.ExportFrames)
+        {
+            std::string error;
+            bool written = exporter.Close(&error);
+            std::printf("frames_written=%llu\n", (unsigned long long)exporter.FramesWritten());
+            std::printf("frames_dropped=%llu\n", (unsigned long long)exporter.FramesDropped());
+            if (!written)
+            {
+                std::fprintf(stderr, "Ошибка записи кадров: %s\n", error.c_str());
+                return 2;
+            }
+        }
+
+        // Достигнутая цель --until - успешный запуск, хотя партия не доиграна
+        return outcome == sim::Outcome::Victory || reached ? 0 : 1;
+    }
+
+    // Пакет партий: доля побед, распределение числа перехватов и время до прорыва к ядру
+    int RunBatchMode(const sim::ConfigData& config, const Options& options)
+    {
+        sim::BatchOptions batch;
+        batch.Runs = options.BatchRuns;
+        batch.Threads = options.Threads;
+        batch.BaseSeed = options.Seed;
+        batch.DeltaTime = options.DeltaTime;
+        batch.MaxTicks = options.MaxTicks;
+        batch.EventDriven = options.EventDriven;
+
+        auto started = std::chrono::steady_clock::now();
+        std::string error;
+        std::vector<sim::EngagementResult> results = sim::RunBatch(config, batch, &error);
+        if (!error.empty())
+        {
+            std::fprintf(stderr, "Ошибка сценария: %s\n", error.c_str());
+            return 2;
+        }
+        double wallSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        sim::BatchStats stats = sim::Summarize(results);
+
+        std::printf("runs=%d\n", stats.Runs);
+        std::printf("base_seed=%llu\n", (unsigned long long)options.Seed);
+        std::printf("victories=%d\n", stats.Victories);
+        std::printf("defense_failures=%d\n", stats.DefenseFailures);
+        std::printf("radar_destroyed=%d\n", stats.RadarDestructions);
+        std::printf("unfinished=%d\n", stats.Unfinished);
+        std::printf("win_rate=%.4f\n", stats.WinRate);
+        std::printf("win_rate_ci95=%.4f..%.4f\n", stats.WinRateCi.Low, stats.WinRateCi.High);
+        std::printf("intercepted_mean=%.3f\n", stats.InterceptMean);
+        std::printf("intercepted_stddev=%.3f\n", stats.InterceptStdDev);
+        std::printf("intercepted_mean_ci95=%.3f..%.3f\n", stats.InterceptMeanCi.Low, stats.InterceptMeanCi.High);
+        std::printf("intercepted_hist=");
+        for (size_t k = 0; k < stats.InterceptHistogram.size(); k++)
+        {
+            std::printf("%s%zu:%d", k ? "," : "", k, stats.InterceptHistogram[k]);
+        }
+        std::printf("\n");
+        if (stats.RadarDestructions > 0)
+        {
+            std::printf("breach_time_mean_sec=%.3f\n", stats.BreachTimeMean);
+            std::printf("breach_time_stddev_sec=%.3f\n", stats.BreachTimeStdDev);
+            std::printf("breach_time_mean_ci95_sec=%.3f..%.3f\n", stats.BreachTimeMeanCi.Low, stats.BreachTimeMeanCi.High);
+            std::printf("breach_time_min_p10_p50_p90_max_sec=%.3f,%.3f,%.3f,%.3f,%.3f\n",
+                stats.BreachTimeMin, stats.BreachTimeP10, stats.BreachTimeP50, stats.BreachTimeP90, stats.BreachTimeMax);
+        }
+        std::printf("wall_time_sec=%.6f\n", wallSec);
+        std::printf("engagements_per_sec=%.1f\n", wallSec > 0 ? stats.Runs / wallSec : 0.0);
+        return 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--help" || arg == "-h")
+        {
+            PrintUsage(argv[0]);
+            return 0;
+        }
+        else if (arg == "--dt" && hasValue)
+        {
+            options.DeltaTime = std::strtof(argv[++i], nullptr);
+        }
+        else if (arg == "--seed" && hasValue)
+        {
+            options.Seed = std::strtoull(argv[++i], nullptr, 10);
+            options.HasSeed = true;
+        }
+        else if (arg == "--max-ticks" && hasValue)
+        {
+            options.MaxTicks = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--swept")
+        {
+            options.Swept = true;
+        }
+        else if (arg == "--event")
+        {
+            options.EventDriven = true;
+        }
+        else if (arg == "--batch" && hasValue)
+        {
+            options.BatchRuns = std::atoi(argv[++i]);
+        }
+        else if (arg == "--threads" && hasValue)
+        {
+            options.Threads = std::atoi(argv[++i]);
+        }
+        else if (arg == "--sweep" && hasValue)
+        {
+            sim::SweepAxis axis;
+            std::string error;
+            if (!sim::SweepAxis::Parse(argv[++i], axis, &error))
+            {
+                std::fprintf(stderr, "%s\n", error.c_str());
+                return 2;
+            }
+            options.Sweep.Axes.push_back(axis);
+        }
+        else if (arg == "--sweep-runs" && hasValue)
+        {
+            options.Sweep.RunsPerPoint = std::atoi(argv[++i]);
+        }
+        else if (arg == "--sweep-round" && hasValue)
+        {
+            options.Sweep.RoundRuns = std::atoi(argv[++i]);
+        }
+        else if (arg == "--no-cutoff")
+        {
+            options.Sweep.EarlyCutoff = false;
+        }
+        else if (arg == "--adaptive" && hasValue)
+        {
+            options.Sweep.AdaptiveRounds = std::atoi(argv[++i]);
+        }
+        else if (arg == "--objective" && hasValue)
+        {
+            std::string objective = argv[++i];
+            if (objective == "win_rate") options.Sweep.Objective = sim::SweepObjective::WinRate;
+            else if (objective == "intercepted") options.Sweep.Objective = sim::SweepObjective::InterceptMean;
+            else
+            {
+                std::fprintf(stderr, "Неизвестная метрика: %s\n", objective.c_str());
+                return 2;
+            }
+        }
+        else if (arg == "--frames" && hasValue)
+        {
+            options.ExportFrames = true;
+            options.Frames.PathPattern = argv[++i];
+            options.Frames.Format = sim::FrameExportOptions::FormatForPath(options.Frames.PathPattern);
+        }
+        else if (arg == "--frames-pipe" && hasValue)
+        {
+            options.ExportFrames = true;
+            options.Frames.PipeCommand = argv[++i];
+            options.Frames.Format = sim::FrameFormat::Raw;
+        }
+        else if (arg == "--frame-size" && hasValue)
+        {
+            if (std::sscanf(argv[++i], "%dx%d", &options.Frames.Width, &options.Frames.Height) != 2
+                || options.Frames.Width < 1 || options.Frames.Height < 1)
+            {
+                std::fprintf(stderr, "Размер кадра задается как ШИРИНАxВЫСОТА, например 800x600\n");
+                return 2;
+            }
+        }
+        else if (arg == "--frame-every" && hasValue)
+        {
+            options.FrameEveryTicks = std::atoi(argv[++i]);
+        }
+        else if (arg == "--frames-drop")
+        {
+            options.Frames.DropWhenBusy = true;
+        }
+        else if (arg == "--record" && hasValue)
+        {
+            options.RecordPath = argv[++i];
+        }
+        else if (arg == "--keyframe-every" && hasValue)
+        {
+            options.KeyframeEvery = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--replay" && hasValue)
+        {
+            options.ReplayPath = argv[++i];
+        }
+        else if (arg == "--at" && hasValue)
+        {
+            options.ReplayTick = std::strtoull(argv[++i], nullptr, 10);
+            options.HasReplayTick = true;
+        }
+        else if (arg == "--watch")
+        {
+            options.Watch = true;
+        }
+        else if (arg == "--profile" && hasValue)
+        {
+            options.ProfilePath = argv[++i];
+        }
+        else if (arg == "--until" && hasValue)
+        {
+            std::string goal = argv[++i];
+            options.HasUntil = true;
+            if (goal == "detection") options.Until = sim::WarpGoal(sim::WarpGoal::Detection);
+            else if (goal == "interception") options.Until = sim::WarpGoal(sim::WarpGoal::Interception);
+            else if (goal.compare(0, 5, "tick=") == 0 && goal.size() > 5)
+            {
+                options.Until = sim::WarpGoal(sim::WarpGoal::Tick, std::strtoull(goal.c_str() + 5, nullptr, 10));
+            }
+            else
+            {
+                std::fprintf(stderr, "Неизвестная цель --until: %s\n", goal.c_str());
+                return 2;
+            }
+        }
+        else if (arg == "--serve" && hasValue)
+        {
+            options.ServeAddress = argv[++i];
+        }
+        else if (arg == "--view" && hasValue)
+        {
+            options.ViewAddress = argv[++i];
+        }
+        else if (arg.compare(0, 2, "--") != 0)
+        {
+            options.SettingsPath = arg;
+        }
+        else
+        {
+            std::fprintf(stderr, "Неизвестный параметр: %s\n", arg.c_str());
+            PrintUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    // Зрителю settings.txt не нужен: все приходит в потоке
+    if (!options.ViewAddress.empty()) return RunView(options);
+
+    if (options.DeltaTime < 0.0f)
+    {
+        std::fprintf(stderr, "Шаг симуляции должен быть положительным\n");
+        return 2;
+    }
+
+    sim::ConfigData config;
+    std::string error;
+    if (!config.LoadFromFile(options.SettingsPath, &error))
+    {
+        std::fprintf(stderr, "Ошибка загрузки конфигурации: %s\nИспользуются значения по умолчанию.\n", error.c_str());
+    }
+    if (options.Swept) config.RadarSweptBeam = true;
+
+    // Явный --seed важнее random_seed из файла; если нет ни того, ни другого - seed случайный
+    if (!options.HasSeed)
+    {
+        options.Seed = config.HasRandomSeed ? config.RandomSeed
+            : ((uint64_t)std::random_device()() << 32) ^ std::random_device()();
+    }
+
+    if (!options.ReplayPath.empty()) return RunReplay(config, options);
+
+    // Запись, правки на ходу, раздача, остановка, замер фаз и кадры - только для одиночной пошаговой партии
+    const bool singleStepped = options.Sweep.Axes.empty() && options.BatchRuns == 0 && !options.EventDriven;
+    const struct { bool Enabled; const char* Flag; } singleOnly[] = {
+        { !options.RecordPath.empty(), "--record" },
+        { options.Watch, "--watch" },
+        { !options.ServeAddress.empty(), "--serve" },
+        { options.HasUntil, "--until" },
+        { !options.ProfilePath.empty(), "--profile" },
+        { options.ExportFrames, "--frames" },
+    };
+    for (const auto& option : singleOnly)
+    {
+        if (option.Enabled && !singleStepped)
+        {
+            std::fprintf(stderr, "%s действует только в одиночной пошаговой партии (без --sweep, --batch и --event)\n", option.Flag);
+            return 2;
+        }
+    }
+
+    if (!options.Sweep.Axes.empty()) return RunSweepMode(config, options);
+    if (options.BatchRuns > 0) return RunBatchMode(config, options);
+    return RunSingle(config, options);
+}
@@ -0,0 +1,569 @@
+// Проверки ядра симуляции. Каждая проверка - отдельный тест ctest (см. CMakeLists.txt):
+//   ./build/radar_tests             все проверки
+//   ./build/radar_tests <имя>       одна проверка
+//   ctest --test-dir build
+#include "Engine/BatchRunner.h"
+#include "Engine/FrameExporter.h"
+#include "Engine/LaunchScheduler.h"
+#include "Engine/ParameterSweep.h"
+#include "Engine/Replay.h"
+#include "Engine/StateStream.h"
+#include "Engine/Simulation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Проваленных условий в текущей проверке
+    int Failures = 0;
+
+    void Fail(const char* file, int line, const std::string& message)
+    {
+        std::printf("%s:%d: %s\n", file, line, message.c_str());
+        Failures++;
+    }
+
+// Условие проверки: при провале печатается место и текст условия, проверка продолжается
+#define CHECK(condition) \
+    do { if (!(condition)) Fail(__FILE__, __LINE__, "не выполнено: " #condition); } while (0)
+
+// То же с пояснением (значения, seed, шаг)
+#define CHECK_MSG(condition, message) \
+    do { if (!(condition)) Fail(__FILE__, __LINE__, std::string("не выполнено: " #condition " - ") + (message)); } while (0)
+
+    std::string Format(const char* format, double a, double b = 0.0, double c = 0.0)
+    {
+        char text[256];
+        std::snprintf(text, sizeof(text), format, a, b, c);
+        return text;
+    }
+
+    // Конфигурация проверок: значения settings.txt из репозитория, заданные здесь, чтобы правка
+    // settings.txt не меняла проверки
+    sim::ConfigData TestConfig()
+    {
+        sim::ConfigData config;
+        const char* values[][2] = {
+            { "rocket_speed", "40" },
+            { "distance_corner_to_center", "300" },
+            { "radar_beam_width_degrees", "45" },
+            { "radar_rotation_speed_dps", "86" },
+            { "radar_max_detection_range_P", "200" },
+            { "radar_circular_attack_range", "125" },
+            { "radar_core_vulnerability_radius", "20" },
+            { "radar_dead_zone_radius", "20" },
+            { "launch_interval_min_sec", "3" },
+            { "launch_interval_max_sec", "5" },
+            { "total_rockets_to_launch", "10" },
+        };
+        for (const auto& value : values) config.SetValue(value[0], value[1]);
+        return config;
+    }
+
+    sim::BatchOptions Batch(int runs, uint64_t baseSeed, float deltaTime, bool eventDriven)
+    {
+        sim::BatchOptions options;
+        options.Runs = runs;
+        options.Threads = 1;
+        options.BaseSeed = baseSeed;
+        options.DeltaTime = deltaTime;
+        options.EventDriven = eventDriven;
+        return options;
+    }
+
+    // Событийный движок (EventSimulation) и пошаговый при малом шаге играют одни и те же партии:
+    // у каждой партии совпадает исход и почти всегда число перехватов, у пакета - доля побед и среднее перехватов
+    void EventMatchesStepped()
+    {
+        const sim::ConfigData config = TestConfig();
+        const int runs = 200;
+        const float deltaTime = 0.002f;
+
+        for (uint64_t baseSeed : { 1ull, 7ull, 2024ull })
+        {
+            std::vector<sim::EngagementResult> stepped = sim::RunBatch(config, Batch(runs, baseSeed, deltaTime, false));
+            std::vector<sim::EngagementResult> events = sim::RunBatch(config, Batch(runs, baseSeed, deltaTime, true));
+
+            int sameResult = 0, sameIntercepted = 0;
+            for (int run = 0; run < runs; run++)
+            {
+                if (stepped[run].Result == events[run].Result) sameResult++;
+                if (stepped[run].Intercepted == events[run].Intercepted) sameIntercepted++;
+            }
+            // Расхождения - только партии, где перехват решается долями шага
+            CHECK_MSG(sameResult >= runs * 97 / 100, Format("seed %.0f: исход совпал в %.0f партиях из %.0f", (double)baseSeed, sameResult, runs));
+            CHECK_MSG(sameIntercepted >= runs * 90 / 100,
+                Format("seed %.0f: число перехватов совпало в %.0f партиях из %.0f", (double)baseSeed, sameIntercepted, runs));
+
+            sim::BatchStats a = sim::Summarize(stepped);
+            sim::BatchStats b = sim::Summarize(events);
+            CHECK_MSG(std::fabs(a.WinRate - b.WinRate) <= 0.02, Format("seed %.0f: доля побед %.4f и %.4f", (double)baseSeed, a.WinRate, b.WinRate));
+            CHECK_MSG(std::fabs(a.InterceptMean - b.InterceptMean) <= 0.15,
+                Format("seed %.0f: среднее перехватов %.3f и %.3f", (double)baseSeed, a.InterceptMean, b.InterceptMean));
+        }
+    }
+
+    // С непрерывной проверкой луча (radar_swept_beam) шаг 0.5 и 1 с дает ту же статистику пакета, что и 33 мс:
+    // луч не проскакивает ракеты, а запуск, время которого пришлось на середину шага, не ждет следующего шага -
+    // ракета стартует вовремя и к концу шага уже пролетела остаток шага
+    void LargeStepMatchesSmallStep()
+    {
+        sim::ConfigData config = TestConfig();
+        config.RadarSweptBeam = true;
+        const int runs = 400;
+
+        for (uint64_t baseSeed : { 3ull, 19ull })
+        {
+            std::vector<sim::EngagementResult> reference = sim::RunBatch(config, Batch(runs, baseSeed, 1.0f / 30.0f, false));
+            sim::BatchStats a = sim::Summarize(reference);
+            for (float deltaTime : { 0.5f, 1.0f })
+            {
+                std::vector<sim::EngagementResult> coarse = sim::RunBatch(config, Batch(runs, baseSeed, deltaTime, false));
+                int sameIntercepted = 0;
+                for (int run = 0; run < runs; run++)
+                {
+                    if (reference[run].Intercepted == coarse[run].Intercepted) sameIntercepted++;
+                }
+                const std::string where = Format("seed %.0f, шаг %.1f с", (double)baseSeed, deltaTime);
+                CHECK_MSG(sameIntercepted >= runs * 95 / 100, where + Format(": число перехватов совпало в %.0f партиях из %.0f", sameIntercepted, runs));
+
+                sim::BatchStats b = sim::Summarize(coarse);
+                CHECK_MSG(std::fabs(a.WinRate - b.WinRate) <= 0.02, where + Format(": доля побед %.4f и %.4f", a.WinRate, b.WinRate));
+                CHECK_MSG(std::fabs(a.InterceptMean - b.InterceptMean) <= 0.15,
+                    where + Format(": среднее перехватов %.3f и %.3f", a.InterceptMean, b.InterceptMean));
+            }
+        }
+
+        // Быстрые ракеты при неподвижном луче: за шаг ракета пролетает больше диаметра ядра, и проверка только
+        // конца шага пропускала ее сквозь ядро - партия не кончалась. Ядро проверяется по всему отрезку шага:
+        // радар уничтожен в тот же момент (с точностью до шага), обычная и непрерывная проверка, с индексом и без
+        sim::ConfigData fast = TestConfig();
+        fast.SetValue("rocket_speed", "150");
+        fast.SetValue("radar_rotation_speed_dps", "0");
+        for (int variant = 0; variant < 4; variant++)
+        {
+            fast.RadarSweptBeam = (variant & 1) != 0;
+            fast.RadarBucketIndex = (variant & 2) != 0;
+            sim::BatchOptions options = Batch(50, 5, 1.0f / 30.0f, false);
+            std::vector<sim::EngagementResult> reference = sim::RunBatch(fast, options);
+            for (float deltaTime : { 0.5f, 1.0f })
+            {
+                options.DeltaTime = deltaTime;
+                options.MaxTicks = (uint64_t)(600.0f / deltaTime);
+                std::vector<sim::EngagementResult> coarse = sim::RunBatch(fast, options);
+                for (size_t run = 0; run < coarse.size(); run++)
+                {
+                    const std::string where = Format("быстрые ракеты (вариант %.0f), шаг %.1f с, партия %.0f", variant, deltaTime, (double)run);
+                    CHECK_MSG(reference[run].Result == sim::Outcome::RadarDestroyed && coarse[run].Result == sim::Outcome::RadarDestroyed,
+                        where + Format(": исходы %.0f и %.0f", (double)reference[run].Result, (double)coarse[run].Result));
+                    CHECK_MSG(std::fabs(reference[run].EndTimeSec - coarse[run].EndTimeSec) <= deltaTime + 1e-3,
+                        where + Format(": прорыв к ядру на %.3f и %.3f с", reference[run].EndTimeSec, coarse[run].EndTimeSec));
+                }
+            }
+        }
+    }
+
+    // Нулевые интервалы запуска и перезарядки: время старта в шаге не движется, поэтому ракеты идут по одной
+    // за шаг (как в замере tick_launching), а не все оставшиеся разом
+    void ZeroIntervalsLaunchPerTick()
+    {
+        sim::ConfigData config = TestConfig();
+        config.SetValue("total_rockets_to_launch", "1000000000");
+        config.SetValue("launch_interval_min_sec", "0");
+        config.SetValue("launch_interval_max_sec", "0");
+        config.SetValue("radar_core_vulnerability_radius", "0");
+
+        for (float deltaTime : { 1.0f / 30.0f, 1.0f })
+        {
+            sim::Simulation simulation(config, 5);
+            for (int tick = 0; tick < 100 && !simulation.GameOver; tick++) simulation.Step(deltaTime);
+            CHECK_MSG(simulation.RocketsLaunchedCount == (int)simulation.TickCount,
+                Format("шаг %.3f с: %.0f запусков за %.0f шагов", deltaTime, simulation.RocketsLaunchedCount, (double)simulation.TickCount));
+        }
+    }
+
+    // Индекс по секторам (MoveIndexedAndIntercept, SweepIndexedAndIntercept) проверяет лучом только ракеты
+    // из покрытых секторов, но перехватывает ровно те же ракеты, что и полный перебор: партии с индексом и без
+    // совпадают на каждом шаге - прямой полет и маневры, обычная и непрерывная проверка луча
+    void IndexedMatchesFullScan()
+    {
+        struct Variant
+        {
+            const char* Name;
+            bool Swept;
+            bool Maneuvering;
+            float DeltaTime;
+        };
+        const Variant variants[] = {
+            { "straight", false, false, 1.0f / 30.0f },
+            { "swept", true, false, 0.1f },
+            { "maneuvering", false, true, 1.0f / 30.0f },
+            { "maneuvering_swept", true, true, 0.1f },
+        };
+
+        for (const Variant& variant : variants)
+        {
+            sim::ConfigData config = TestConfig();
+            config.SetValue("total_rockets_to_launch", "400");
+            config.SetValue("launch_interval_min_sec", "0");
+            config.SetValue("launch_interval_max_sec", "0.1");
+            config.SetValue("radar_core_vulnerability_radius", "0");
+            config.SetValue("radar_beam_width_degrees", "10");
+            config.SetValue("rocket_speed", "120");
+            config.RadarSweptBeam = variant.Swept;
+            if (variant.Maneuvering)
+            {
+                config.SetValue("rocket_guidance", "pursuit");
+                config.SetValue("rocket_turn_rate_dps", "30");
+                config.SetValue("rocket_launch_spread_degrees", "60");
+                config.SetValue("rocket_weave_amplitude_degrees", "20");
+            }
+            sim::ConfigData indexedConfig = config;
+            indexedConfig.RadarBucketIndex = true;
+
+            for (uint64_t seed : { 3ull, 11ull, 42ull })
+            {
+                sim::Simulation full(config, seed);
+                sim::Simulation indexed(indexedConfig, seed);
+                // Минута игры: сотни ракет запущены, часть перехвачена, часть прошла к центру
+                const uint64_t ticks = (uint64_t)(60.0f / variant.DeltaTime);
+                for (uint64_t tick = 0; tick < ticks && !full.GameOver; tick++)
+                {
+                    full.Step(variant.DeltaTime);
+                    indexed.Step(variant.DeltaTime);
+                    bool same = full.RocketsInterceptedCount == indexed.RocketsInterceptedCount && full.Result == indexed.Result
+                        && full.GameOver == indexed.GameOver && full.ActiveRockets.Size() == indexed.ActiveRockets.Size();
+                    if (!same)
+                    {
+                        Fail(__FILE__, __LINE__, std::string(variant.Name)
+                            + Format(": seed %.0f, шаг %.0f: перехвачено %.0f", (double)seed, (double)tick, full.RocketsInterceptedCount)
+                            + Format(" и %.0f с индексом", indexed.RocketsInterceptedCount));
+                        break;
+                    }
+                }
+                CHECK_MSG(full.RocketsLaunchedCount >= 100 && full.RocketsInterceptedCount > 0,
+                    std::string(variant.Name) + Format(": seed %.0f: запущено %.0f, перехвачено %.0f", (double)seed, full.RocketsLaunchedCount, full.RocketsInterceptedCount));
+            }
+        }
+    }
+
+    // ReplayReader::Seek восстанавливает состояние записанной партии на любом шаге: опорный кадр, шаги внутри
+    // блока и последний шаг совпадают с живой симуляцией с тем же seed с точностью до квантования записи
+    void ReplaySeekMatchesLive()
+    {
+        sim::ConfigData config = TestConfig();
+        config.SetValue("total_rockets_to_launch", "30");
+        config.SetValue("launch_interval_min_sec", "0.5");
+        config.SetValue("launch_interval_max_sec", "1.5");
+        const uint64_t seed = 5;
+        const float deltaTime = 1.0f / 30.0f;
+        const uint32_t keyframeInterval = 25;
+        const std::string path = "radar_tests_replay.bin";
+
+        std::string error;
+        {
+            sim::Simulation simulation(config, seed);
+            sim::ReplayRecorder recorder;
+            CHECK_MSG(recorder.Open(path, simulation, deltaTime, keyframeInterval, &error), error);
+            while (!simulation.GameOver && simulation.TickCount < 100000)
+            {
+                simulation.Step(deltaTime);
+                recorder.Record(simulation);
+            }
+            CHECK_MSG(recorder.Close(simulation, &error), error);
+        }
+
+        sim::ReplayReader reader;
+        if (!reader.Open(path, &error))
+        {
+            Fail(__FILE__, __LINE__, error);
+            std::remove(path.c_str());
+            return;
+        }
+        const sim::ReplayHeader& header = reader.Header();
+        CHECK(header.TickCount > 4 * keyframeInterval);
+
+        // Опорные кадры, соседние с ними шаги, середины блоков и последний шаг
+        std::vector<uint64_t> ticks = { 0, 1, keyframeInterval - 1, keyframeInterval, keyframeInterval + 1 };
+        for (uint64_t block = 1; (block + 1) * keyframeInterval < header.TickCount; block += 3)
+            ticks.push_back(block * keyframeInterval + keyframeInterval / 2);
+        ticks.push_back(header.TickCount - 1);
+        ticks.push_back(header.TickCount);
+
+        // Квантование опорной точки ракеты и скорости на пролете до конца блока, плюс накопление float в шагах
+        const float tolerance = header.PositionScale + header.VelocityScale * deltaTime * (float)(keyframeInterval + 1) + 0.01f;
+        sim::Simulation live(config, seed);
+        sim::SimSnapshot snapshot;
+        for (uint64_t tick : ticks)
+        {
+            while (live.TickCount < tick) live.Step(deltaTime);
+            const std::string where = Format("шаг %.0f", (double)tick);
+            if (!reader.Seek(tick, snapshot, &error))
+            {
+                Fail(__FILE__, __LINE__, where + ": " + error);
+                continue;
+            }
+            CHECK_MSG(snapshot.RocketsLaunchedCount == live.RocketsLaunchedCount, where);
+            CHECK_MSG(snapshot.RocketsInterceptedCount == live.RocketsInterceptedCount, where);
+            CHECK_MSG(snapshot.MainRadar.IsDestroyed == live.MainRadar.IsDestroyed, where);
+            // Угол луча записан в 16 битах
+            CHECK_MSG(std::abs(sim::BinaryAngleDelta(snapshot.MainRadar.Angle, live.MainRadar.Angle)) <= (1 << 16), where);
+
+            std::map<uint32_t, size_t> liveRockets;
+            for (size_t i = 0; i < live.ActiveRockets.Size(); i++) liveRockets[live.ActiveRockets.Id[i]] = i;
+            CHECK_MSG(snapshot.Rockets.Size() == live.ActiveRockets.Size(),
+                where + Format(": ракет %.0f и %.0f", (double)snapshot.Rockets.Size(), (double)live.ActiveRockets.Size()));
+            float maxError = 0.0f;
+            for (size_t i = 0; i < snapshot.Rockets.Size(); i++)
+            {
+                auto found = liveRockets.find(snapshot.Rockets.Id[i]);
+                if (found == liveRockets.end())
+                {
+                    Fail(__FILE__, __LINE__, where + Format(": лишняя ракета %.0f", (double)snapshot.Rockets.Id[i]));
+                    continue;
+                }
+                maxError = std::max(maxError, std::fabs(snapshot.Rockets.X[i] - live.ActiveRockets.X[found->second]));
+                maxError = std::max(maxError, std::fabs(snapshot.Rockets.Y[i] - live.ActiveRockets.Y[found->second]));
+            }
+            CHECK_MSG(maxError <= tolerance, where + Format(": отклонение %.4f при допуске %.4f", maxError, tolerance));
+        }
+        reader.Close();
+        std::remove(path.c_str());
+    }
+
+    // LaunchTimers считает шаг готовности в замкнутой форме: tick + ceil(seconds / step) в double, к этому шагу
+    // OvershootSec уже не меньше нуля и не больше шага; смена шага посреди отсчета доводит таймер прежним шагом
+    void LaunchTimersClosedForm()
+    {
+        using sim::LaunchTimers;
+        std::mt19937_64 random(12345);
+        auto uniform = [&](float low, float high) { return std::uniform_real_distribution<float>(low, high)(random); };
+        const float steps[] = { 1.0f / 30.0f, 1.0f / 60.0f, 0.033f, 0.25f, 1.0f };
+
+        int mismatches = 0;
+        for (int run = 0; run < 2000 && mismatches < 5; run++)
+        {
+            float seconds = uniform(0.0f, run % 4 == 0 ? 60.0f : 8.0f);
+            float step = run % 2 == 0 ? steps[run / 2 % 5] : uniform(0.002f, 1.0f);
+
+            LaunchTimers timers;
+            timers.Reset(1, step);
+            timers.Schedule(0, seconds, 100);
+            const uint64_t expected = 100 + (uint64_t)std::ceil((double)seconds / step);
+            const uint64_t ready = timers.ReadyTick(0);
+            const float overshoot = timers.OvershootSec(0, ready);
+            if (ready != expected || timers.Ready(0, ready - 1) || !(overshoot >= 0.0f && overshoot <= step))
+            {
+                Fail(__FILE__, __LINE__, Format("таймер %a, шаг %a: готов на шаге %.0f", seconds, step, (double)ready)
+                    + Format(" вместо %.0f, запас %a", (double)expected, overshoot));
+                mismatches++;
+                continue;
+            }
+
+            // Смена шага на случайном шаге отсчета: до lastTick - прежний шаг, дальше - новый.
+            // Установка, готовая до смены шага, готова сразу
+            float newStep = steps[random() % 5];
+            uint64_t lastTick = 100 + random() % (expected - 100 + 2);
+            timers.ChangeStep(newStep, lastTick);
+            float left = (float)(seconds - (double)(lastTick - 100) * step);
+            uint64_t changed = expected <= lastTick ? lastTick : lastTick + (uint64_t)std::ceil((double)left / newStep);
+            if (timers.ReadyTick(0) != changed)
+            {
+                Fail(__FILE__, __LINE__, Format("таймер %a, шаг %a, смена шага на %a", seconds, step, newStep)
+                    + Format(" после шага %.0f: готов на шаге %.0f", (double)lastTick, (double)timers.ReadyTick(0))
+                    + Format(" вместо %.0f", (double)changed));
+                mismatches++;
+            }
+        }
+
+        // Нулевой таймер готов сразу, при нулевом шаге таймер не убывает
+        LaunchTimers timers;
+        timers.Reset(2, 0.0f);
+        timers.Schedule(0, 0.0f, 7);
+        timers.Schedule(1, 1000.0f, 0);
+        CHECK(timers.ReadyTick(0) == 7);
+        CHECK(timers.ReadyTick(1) == LaunchTimers::Never);
+    }
+
+    // Поток состояния: кодирование и разбор партии (с пропусками сообщений, опорными кадрами посреди партии
+    // и байтами, приходящими кусками) дают те же счетчики, угол луча и ракеты, что у живой симуляции,
+    // а координаты ракет - с точностью до StatePositionUnit
+    void StateStreamRoundTrip()
+    {
+        sim::ConfigData config = TestConfig();
+        config.SetValue("total_rockets_to_launch", "500");
+        config.SetValue("launch_interval_min_sec", "0.01");
+        config.SetValue("launch_interval_max_sec", "0.05");
+        config.SetValue("rocket_guidance", "pursuit");
+        config.SetValue("rocket_turn_rate_dps", "30");
+        config.SetValue("rocket_weave_amplitude_degrees", "20");
+
+        sim::Simulation simulation(config, 5);
+        const float deltaTime = simulation.FixedStepSec();
+        sim::StateStreamEncoder encoder;
+        sim::StateStreamDecoder decoder;
+        std::vector<uint8_t> message;
+        std::vector<size_t> order;
+        std::string error;
+        size_t mostRockets = 0;
+        int mismatches = 0;
+        for (uint64_t tick = 1; tick <= 20000 && !simulation.GameOver && mismatches < 5; tick++)
+        {
+            simulation.Step(deltaTime);
+            // Пропущенные сообщения (как при перемотке) и опорные кадры посреди партии
+            if (tick % 7 == 3) continue;
+            encoder.Encode(simulation, deltaTime, tick % 50 == 0, message);
+            for (size_t offset = 0; offset < message.size(); offset += 5)
+                decoder.Feed(message.data() + offset, std::min<size_t>(5, message.size() - offset));
+            int applied = 0;
+            for (int status; (status = decoder.Next(&error)) != 0; applied++)
+            {
+                if (status < 0)
+                {
+                    Fail(__FILE__, __LINE__, "поток поврежден: " + error);
+                    return;
+                }
+            }
+
+            const std::string where = Format("шаг %.0f", (double)tick);
+            bool same = applied == 1 && decoder.TickCount == simulation.TickCount && decoder.Launched == simulation.RocketsLaunchedCount
+                && decoder.Intercepted == simulation.RocketsInterceptedCount && decoder.GameOver == simulation.GameOver
+                && decoder.Result == simulation.Result && decoder.Radars[0].Angle == simulation.MainRadar.Angle
+                && decoder.Rockets.size() == simulation.ActiveRockets.Size();
+            if (!same)
+            {
+                Fail(__FILE__, __LINE__, where + ": счетчики, луч или число ракет не совпали");
+                mismatches++;
+                continue;
+            }
+
+            // Ракеты в разобранном состоянии - по возрастанию Id
+            const sim::RocketStore& rockets = simulation.ActiveRockets;
+            mostRockets = std::max(mostRockets, rockets.Size());
+            order.resize(rockets.Size());
+            for (size_t i = 0; i < order.size(); i++) order[i] = i;
+            std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return rockets.Id[a] < rockets.Id[b]; });
+            for (size_t k = 0; k < order.size(); k++)
+            {
+                const sim::StreamRocket& decoded = decoder.Rockets[k];
+                size_t i = order[k];
+                // Координата квантуется округлением: отклонение не больше половины единицы
+                float drift = std::max(std::fabs(decoded.X - rockets.X[i]), std::fabs(decoded.Y - rockets.Y[i]));
+                if (decoded.Id != rockets.Id[i] || !(drift <= sim::StatePositionUnit * 0.5f + 1e-4f))
+                {
+                    Fail(__FILE__, __LINE__, where + Format(": ракета %.0f разобрана как %.0f, отклонение %.4f", (double)rockets.Id[i],
+                        (double)decoded.Id, drift));
+                    mismatches++;
+                    break;
+                }
+            }
+        }
+        CHECK(simulation.GameOver);
+        CHECK(decoder.GameOver);
+        CHECK(mostRockets >= 50);
+        CHECK(decoder.Keyframes > 1);
+    }
+
+    // Неоткрывшийся сценарий не дает партии без установок и ракет закончиться "победой": партия окончена
+    // с итогом InProgress и ошибкой, пакет и перебор отказываются играть. Чтение settings.txt сценарий
+    // не читает (он может быть огромным, а settings.txt перечитывается при каждой правке) - файл проверяет партия
+    void MissingScenarioFails()
+    {
+        sim::ConfigData config = TestConfig();
+        CHECK(config.SetValue("scenario", "radar_tests_missing_scenario.txt"));
+        CHECK(!config.ScenarioScanned);
+
+        sim::Simulation simulation(config, 1);
+        CHECK(!simulation.ScenarioError().empty());
+        CHECK(simulation.GameOver);
+        CHECK(simulation.Result == sim::Outcome::InProgress);
+        CHECK(simulation.RunToEnd(1.0f / 30.0f) == sim::Outcome::InProgress);
+        CHECK(simulation.RocketsLaunchedCount == 0);
+
+        std::string error;
+        CHECK(sim::RunBatch(config, Batch(10, 1, 0.0f, false), &error).empty());
+        CHECK(!error.empty());
+
+        error.clear();
+        sim::SweepOptions sweep;
+        sim::SweepAxis axis;
+        CHECK(sim::SweepAxis::Parse("rocket_speed=30,40", axis));
+        sweep.Axes.push_back(axis);
+        sweep.RunsPerPoint = 10;
+        sweep.Threads = 1;
+        sim::SweepResult result;
+        CHECK(!sim::RunSweep(config, sweep, result, &error));
+        CHECK(!error.empty());
+        CHECK(result.Engagements == 0);
+    }
+
+    // Шаблон имени кадра уходит в snprintf: принимается только одна подстановка номера %d или %0Nd
+    void FramePathPattern()
+    {
+        using sim::FrameExportOptions;
+        CHECK(FrameExportOptions::CheckPathPattern("frames/f_%05d.png"));
+        CHECK(FrameExportOptions::CheckPathPattern("f%d.ppm"));
+        CHECK(FrameExportOptions::CheckPathPattern("100%%_%3d.png"));
+        CHECK(!FrameExportOptions::CheckPathPattern("frames/f.png"));
+        CHECK(!FrameExportOptions::CheckPathPattern("f_%d_%d.png"));
+        CHECK(!FrameExportOptions::CheckPathPattern("f_%s.png"));
+        CHECK(!FrameExportOptions::CheckPathPattern("f_%n%d.png"));
+        CHECK(!FrameExportOptions::CheckPathPattern("f_%5.2f.png"));
+        CHECK(!FrameExportOptions::CheckPathPattern("f_%ld.png"));
+        CHECK(!FrameExportOptions::CheckPathPattern("f_%"));
+
+        std::string error;
+        sim::FrameExporter exporter;
+        FrameExportOptions options;
+        options.PathPattern = "/tmp/f_%s.ppm";
+        CHECK(!exporter.Open(options, &error));
+        CHECK(!error.empty());
+    }
+
+    struct TestCase
+    {
+        const char* Name;
+        void (*Run)();
+    };
+
+    const TestCase Tests[] = {
+        { "event_matches_stepped", EventMatchesStepped },
+        { "large_step_matches_small_step", LargeStepMatchesSmallStep },
+        { "zero_intervals_launch_per_tick", ZeroIntervalsLaunchPerTick },
+        { "indexed_matches_full_scan", IndexedMatchesFullScan },
+        { "replay_seek_matches_live", ReplaySeekMatchesLive },
+        { "missing_scenario_fails", MissingScenarioFails },
+        { "launch_timers_closed_form", LaunchTimersClosedForm },
+        { "state_stream_round_trip", StateStreamRoundTrip },
+        { "frame_path_pattern", FramePathPattern },
+    };
+}
+
+int main(int argc, char** argv)
+{
+    const char* only = argc > 1 ? argv[1] : nullptr;
+    int failed = 0, ran = 0;
+    for (const TestCase& test : Tests)
+    {
+        if (only && std::strcmp(only, test.Name) != 0) continue;
+        Failures = 0;
+        test.Run();
+        std::printf("%s %s\n", Failures == 0 ? "ok  " : "FAIL", test.Name);
+        if (Failures > 0) failed++;
+        ran++;
+    }
+    if (ran == 0)
+    {
+        std::printf("нет проверки %s\n", only ? only : "");
+        return 2;
+    }
+    return failed == 0 ? 0 : 1;
+}